@@ -0,0 +1,172 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "GridTypes.h"
+#include "GridMemory.h"
+#include <vector>
+
+/**
+ * Dial's bucket queue for small non-negative integer keys.
+ * Every key in the queue must lie in [MinKey, MinKey + MaxSpread], which holds for Dijkstra (spread = max edge cost)
+ * and for A* with a consistent heuristic (spread = max edge cost + heuristic step). Push, decrease-key and Pop are O(1)
+ * amortized; each bucket is an intrusive doubly linked list over the cell indices.
+ * Same interface as TIndexedHeap so the search kernel can take either.
+ */
+class FBucketQueue
+{
+public:
+	/** Make room for items 0..NumItems-1 with keys spread over at most MaxSpread, and empty the queue */
+	void Reset(int32 NumItems, int32 MaxSpread)
+	{
+		Clear();
+
+		//Round up to a power of two so a key maps to its bucket with a mask
+		int32 NumBuckets = 1;
+		while (NumBuckets <= MaxSpread)
+		{
+			NumBuckets <<= 1;
+		}
+		BucketMask = NumBuckets - 1;
+		Heads.assign(NumBuckets, InvalidItem);
+
+		if ((int32)Keys.size() < NumItems)
+		{
+			Keys.resize(NumItems, InvalidKey);
+			Next.resize(NumItems, InvalidItem);
+			Prev.resize(NumItems, InvalidItem);
+		}
+	}
+
+	/** Empty the queue. Only touches the items that were in it */
+	void Clear()
+	{
+		for (int32& Head : Heads)
+		{
+			for (int32 Item = Head; Item != InvalidItem; Item = Next[Item])
+			{
+				Keys[Item] = InvalidKey;
+			}
+			Head = InvalidItem;
+		}
+		Count = 0;
+		MinKey = 0;
+	}
+
+	bool IsEmpty() const { return Count == 0; }
+	int32 Num() const { return Count; }
+
+	int64 GetAllocatedBytes() const
+	{
+		return GridMemory::GetAllocatedBytes(Heads) + GridMemory::GetAllocatedBytes(Keys) + GridMemory::GetAllocatedBytes(Next) + GridMemory::GetAllocatedBytes(Prev);
+	}
+	bool Contains(int32 Item) const { return Keys[Item] != InvalidKey; }
+	int32 GetKey(int32 Item) const { return Keys[Item]; }
+
+	/** Insert Item, or move it to Key if it is already queued. Key must not be below the last popped key */
+	void Push(int32 Item, int32 Key)
+	{
+		if (Contains(Item))
+		{
+			Unlink(Item);
+		}
+		else
+		{
+			if (Count == 0)
+			{
+				MinKey = Key;
+			}
+			Count++;
+		}
+
+		Keys[Item] = Key;
+		Link(Item);
+		if (Key < MinKey)
+		{
+			MinKey = Key;
+		}
+	}
+
+	/** Remove and return an item with the smallest key */
+	int32 Pop()
+	{
+		while (Heads[MinKey & BucketMask] == InvalidItem)
+		{
+			MinKey++;
+		}
+
+		const int32 Item = Heads[MinKey & BucketMask];
+		Remove(Item);
+		return Item;
+	}
+
+	/** Smallest key in the queue */
+	int32 TopKey()
+	{
+		while (Heads[MinKey & BucketMask] == InvalidItem)
+		{
+			MinKey++;
+		}
+		return MinKey;
+	}
+
+	/** Remove an item if it is queued */
+	void Remove(int32 Item)
+	{
+		if (Contains(Item))
+		{
+			Unlink(Item);
+			Keys[Item] = InvalidKey;
+			Count--;
+		}
+	}
+
+private:
+	enum : int32
+	{
+		InvalidItem = -1,
+		InvalidKey = -1
+	};
+
+	void Link(int32 Item)
+	{
+		int32& Head = Heads[Keys[Item] & BucketMask];
+		Prev[Item] = InvalidItem;
+		Next[Item] = Head;
+		if (Head != InvalidItem)
+		{
+			Prev[Head] = Item;
+		}
+		Head = Item;
+	}
+
+	void Unlink(int32 Item)
+	{
+		if (Prev[Item] != InvalidItem)
+		{
+			Next[Prev[Item]] = Next[Item];
+		}
+		else
+		{
+			Heads[Keys[Item] & BucketMask] = Next[Item];
+		}
+
+		if (Next[Item] != InvalidItem)
+		{
+			Prev[Next[Item]] = Prev[Item];
+		}
+	}
+
+	/** First item of each bucket */
+	std::vector<int32> Heads;
+
+	/** Key of each item, InvalidKey when it isn't queued */
+	std::vector<int32> Keys;
+
+	std::vector<int32> Next;
+	std::vector<int32> Prev;
+
+	int32 BucketMask = 0;
+	int32 MinKey = 0;
+	int32 Count = 0;
+};
@@ -0,0 +1,186 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "FlowField.h"
+#include "GridMemory.h"
+#include "GridGraph.h"
+#include <algorithm>
+
+void FGridFlowField::Build(const FGridGraph& Graph, const std::vector<int32>& InGoals)
+{
+	Width = Graph.GetWidth();
+	Goals.clear();
+	for (int32 Goal : InGoals)
+	{
+		if (Graph.IsValidIndex(Goal) && (std::find(Goals.begin(), Goals.end(), Goal) == Goals.end()))
+		{
+			Goals.push_back(Goal);
+		}
+	}
+
+	Distances.assign(Graph.Num(), GridUnreachable);
+	Directions.assign(Graph.Num(), (uint8)EGridFlowDirection::None);
+	bAffected.assign(Graph.Num(), 0);
+	Heap.Reset(Graph.Num());
+	LastUpdateSize = 0;
+
+	for (int32 Goal : Goals)
+	{
+		if (Graph.IsWalkable(Goal))
+		{
+			Distances[Goal] = 0;
+			Directions[Goal] = (uint8)EGridFlowDirection::Goal;
+			Heap.Push(Goal, 0);
+		}
+	}
+	Propagate(Graph);
+}
+
+void FGridFlowField::Clear()
+{
+	Goals.clear();
+	Distances.clear();
+	Directions.clear();
+	bAffected.clear();
+	Heap.Clear();
+}
+
+void FGridFlowField::OnCellChanged(const FGridGraph& Graph, int32 Index)
+{
+	if (!IsBuilt() || !Graph.IsValidIndex(Index))
+	{
+		return;
+	}
+	LastUpdateSize = 0;
+
+	//Everything whose route runs through the cell may have to go around it now: collect the cells pointing into it, recursively
+	Affected.clear();
+	Affected.push_back(Index);
+	bAffected[Index] = 1;
+	for (size_t i = 0; i < Affected.size(); i++)
+	{
+		const int32 Cell = Affected[i];
+		int32 Neighbors[4];
+		const int32 NumNeighbors = Graph.GetNeighbors(Cell, Neighbors);
+		for (int32 n = 0; n < NumNeighbors; n++)
+		{
+			const int32 Neighbor = Neighbors[n];
+			if (!bAffected[Neighbor] && (GetNextCell(Neighbor) == Cell))
+			{
+				bAffected[Neighbor] = 1;
+				Affected.push_back(Neighbor);
+			}
+		}
+	}
+	for (int32 Cell : Affected)
+	{
+		Distances[Cell] = GridUnreachable;
+		Directions[Cell] = (uint8)EGridFlowDirection::None;
+	}
+
+	//Refill them from the unaffected cells around them, whose distances still hold
+	for (int32 Cell : Affected)
+	{
+		bAffected[Cell] = 0;
+		if (!Graph.IsWalkable(Cell))
+		{
+			continue;
+		}
+		if (IsGoal(Cell))
+		{
+			Relax(Cell, GridInvalidIndex, 0);
+			continue;
+		}
+
+		int32 Neighbors[4];
+		const int32 NumNeighbors = Graph.GetNeighbors(Cell, Neighbors);
+		for (int32 n = 0; n < NumNeighbors; n++)
+		{
+			const int32 Neighbor = Neighbors[n];
+			if (Distances[Neighbor] != GridUnreachable)
+			{
+				Relax(Cell, Neighbor, Distances[Neighbor] + Graph.GetCost(Neighbor));
+			}
+		}
+	}
+
+	//A cheaper or newly opened cell can also shorten routes outside that set
+	if (Graph.IsWalkable(Index) && (Distances[Index] != GridUnreachable) && !Heap.Contains(Index))
+	{
+		Heap.Push(Index, Distances[Index]);
+	}
+	Propagate(Graph);
+}
+
+int32 FGridFlowField::GetNextCell(int32 Index) const
+{
+	switch (static_cast<EGridFlowDirection>(Directions[Index]))
+	{
+	case EGridFlowDirection::PositiveX:
+		return Index + 1;
+	case EGridFlowDirection::NegativeX:
+		return Index - 1;
+	case EGridFlowDirection::PositiveY:
+		return Index + Width;
+	case EGridFlowDirection::NegativeY:
+		return Index - Width;
+	default:
+		return GridInvalidIndex;
+	}
+}
+
+void FGridFlowField::Propagate(const FGridGraph& Graph)
+{
+	while (!Heap.IsEmpty())
+	{
+		const int32 Cell = Heap.Pop();
+		LastUpdateSize++;
+
+		//Stepping from a neighbor onto Cell costs Cell's cost
+		const int32 Through = Distances[Cell] + Graph.GetCost(Cell);
+		int32 Neighbors[4];
+		const int32 NumNeighbors = Graph.GetNeighbors(Cell, Neighbors);
+		for (int32 n = 0; n < NumNeighbors; n++)
+		{
+			if (Through < Distances[Neighbors[n]])
+			{
+				Relax(Neighbors[n], Cell, Through);
+			}
+		}
+	}
+}
+
+void FGridFlowField::Relax(int32 Index, int32 Via, int32 NewDistance)
+{
+	if (NewDistance >= Distances[Index])
+	{
+		return;
+	}
+
+	Distances[Index] = NewDistance;
+	Directions[Index] = Via != GridInvalidIndex ? GetDirectionTo(Index, Via) : (uint8)EGridFlowDirection::Goal;
+	Heap.Push(Index, NewDistance);
+}
+
+uint8 FGridFlowField::GetDirectionTo(int32 Index, int32 Via) const
+{
+	if (Via == Index + 1)
+	{
+		return (uint8)EGridFlowDirection::PositiveX;
+	}
+	if (Via == Index - 1)
+	{
+		return (uint8)EGridFlowDirection::NegativeX;
+	}
+	return (uint8)(Via > Index ? EGridFlowDirection::PositiveY : EGridFlowDirection::NegativeY);
+}
+
+bool FGridFlowField::IsGoal(int32 Index) const
+{
+	return std::find(Goals.begin(), Goals.end(), Index) != Goals.end();
+}
+
+int64 FGridFlowField::GetAllocatedBytes() const
+{
+	return GridMemory::GetAllocatedBytes(Goals) + GridMemory::GetAllocatedBytes(Distances) + GridMemory::GetAllocatedBytes(Directions)
+		+ Heap.GetAllocatedBytes() + GridMemory::GetAllocatedBytes(Affected) + GridMemory::GetAllocatedBytes(bAffected);
+}
@@ -0,0 +1,81 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "GridTypes.h"
+#include "IndexedHeap.h"
+#include <vector>
+
+class FGridGraph;
+
+/** Step a flow field cell points along, one byte per cell */
+enum class EGridFlowDirection : uint8
+{
+	PositiveX,
+	NegativeX,
+	PositiveY,
+	NegativeY,
+	/** The cell is a goal */
+	Goal,
+	/** No goal can be reached from the cell, or it is a wall */
+	None
+};
+
+/**
+ * Distance to the nearest of a set of goals for every cell, plus the neighbor to step to, computed with one
+ * Dijkstra run outwards from all goals at once. Any number of agents then follow GetNextCell in O(1) instead of
+ * each running its own search.
+ * Wall and cost edits are repaired locally through OnCellChanged: cells whose route ran through the edited cell
+ * are reset and refilled from the cells around them, and cheaper routes the edit opened spread outwards from it.
+ */
+class FGridFlowField
+{
+public:
+	/** Compute the field towards Goals, walls and invalid indices among them are skipped */
+	void Build(const FGridGraph& Graph, const std::vector<int32>& InGoals);
+
+	void Clear();
+	bool IsBuilt() const { return !Directions.empty(); }
+
+	/** Repair the field after a cell's wall or cost changed. Does nothing before Build */
+	void OnCellChanged(const FGridGraph& Graph, int32 Index);
+
+	/** Cost of the cheapest route from Index to a goal, GridUnreachable if there is none */
+	int32 GetDistance(int32 Index) const { return Distances[Index]; }
+
+	EGridFlowDirection GetDirection(int32 Index) const { return static_cast<EGridFlowDirection>(Directions[Index]); }
+
+	/** Neighbor to step to from Index, GridInvalidIndex on a goal or where no goal can be reached */
+	int32 GetNextCell(int32 Index) const;
+
+	const std::vector<int32>& GetGoals() const { return Goals; }
+
+	/** Cells the last Build or OnCellChanged settled, a measure of how local a repair was */
+	int32 GetLastUpdateSize() const { return LastUpdateSize; }
+
+	/** Heap bytes held by the field and its repair buffers */
+	int64 GetAllocatedBytes() const;
+
+private:
+	/** Settle everything in the heap, lowering neighbors whose route through the popped cell is cheaper */
+	void Propagate(const FGridGraph& Graph);
+
+	/** Lower a cell to reach a goal through Via for NewDistance */
+	void Relax(int32 Index, int32 Via, int32 NewDistance);
+
+	/** Direction from Index to its neighbor Via */
+	uint8 GetDirectionTo(int32 Index, int32 Via) const;
+
+	bool IsGoal(int32 Index) const;
+
+	int32 Width = 0;
+	std::vector<int32> Goals;
+	std::vector<int32> Distances;
+	std::vector<uint8> Directions;
+	TIndexedHeap<int32> Heap;
+
+	/** Cells whose route ran through an edited cell, gathered by OnCellChanged */
+	std::vector<int32> Affected;
+	std::vector<uint8> bAffected;
+	int32 LastUpdateSize = 0;
+};
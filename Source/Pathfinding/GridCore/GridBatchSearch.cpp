@@ -0,0 +1,99 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "GridBatchSearch.h"
+#include "GridMemory.h"
+#include "GridGraph.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace GridBatch
+{
+	void RunOnThreads(int32 NumWorkers, const std::function<void(int32 WorkerIndex)>& Body)
+	{
+		//The calling thread does the first share instead of waiting idle
+		std::vector<std::thread> Threads;
+		for (int32 WorkerIndex = 1; WorkerIndex < NumWorkers; WorkerIndex++)
+		{
+			Threads.emplace_back(Body, WorkerIndex);
+		}
+		Body(0);
+
+		for (std::thread& Thread : Threads)
+		{
+			Thread.join();
+		}
+	}
+}
+
+FGridBatchStats FGridBatchSearch::Solve(const FGridGraph& Graph, const std::vector<FGridPathRequest>& Requests, EGridSearchAlgorithm Algorithm, EGridOpenList OpenList,
+	std::vector<FGridSearchResult>& OutResults, int32 NumWorkers, bool bRecordVisitedOrder, const FParallelRunner& Runner)
+{
+	const int32 NumQueries = (int32)Requests.size();
+	if (NumWorkers <= 0)
+	{
+		NumWorkers = std::max((int32)std::thread::hardware_concurrency(), 1);
+	}
+	NumWorkers = std::max(std::min(NumWorkers, NumQueries), 1);
+
+	while ((int32)Workers.size() < NumWorkers)
+	{
+		Workers.emplace_back(new FGridSearch());
+	}
+	OutResults.resize(NumQueries);
+
+	std::atomic<int32> NextQuery(0);
+	std::atomic<int32> NumFound(0);
+	std::atomic<int64> NodesExpanded(0);
+	const std::function<void(int32)> Body = [&](int32 WorkerIndex)
+	{
+		FGridSearch& Search = *Workers[WorkerIndex];
+		Search.SetRecordVisitedOrder(bRecordVisitedOrder);
+
+		int32 Found = 0;
+		int64 Expanded = 0;
+		for (int32 Query = NextQuery++; Query < NumQueries; Query = NextQuery++)
+		{
+			FGridSearchResult& Result = OutResults[Query];
+			Found += Search.Run(Graph, Requests[Query].Start, Requests[Query].Goal, Algorithm, Result, OpenList) ? 1 : 0;
+			Expanded += Result.NodesExpanded;
+		}
+
+		Search.SetRecordVisitedOrder(true);
+		NumFound += Found;
+		NodesExpanded += Expanded;
+	};
+
+	const auto StartTime = std::chrono::steady_clock::now();
+	if (NumQueries > 0)
+	{
+		if (Runner)
+		{
+			Runner(NumWorkers, Body);
+		}
+		else
+		{
+			GridBatch::RunOnThreads(NumWorkers, Body);
+		}
+	}
+
+	FGridBatchStats Stats;
+	Stats.NumQueries = NumQueries;
+	Stats.NumFound = NumFound;
+	Stats.NumWorkers = NumWorkers;
+	Stats.NodesExpanded = NodesExpanded;
+	Stats.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTime).count();
+	Stats.QueriesPerSecond = Stats.Seconds > 0.0 ? NumQueries / Stats.Seconds : 0.0;
+	return Stats;
+}
+
+int64 FGridBatchSearch::GetAllocatedBytes() const
+{
+	int64 Bytes = GridMemory::GetAllocatedBytes(Workers);
+	for (const std::unique_ptr<FGridSearch>& Worker : Workers)
+	{
+		Bytes += Worker->GetAllocatedBytes();
+	}
+	return Bytes;
+}
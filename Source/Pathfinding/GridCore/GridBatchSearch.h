@@ -0,0 +1,61 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "GridTypes.h"
+#include "GridSearch.h"
+#include <functional>
+#include <memory>
+#include <vector>
+
+class FGridGraph;
+
+/** One start/goal pair of a batch */
+struct FGridPathRequest
+{
+	int32 Start = GridInvalidIndex;
+	int32 Goal = GridInvalidIndex;
+};
+
+/** Totals of one FGridBatchSearch::Solve call */
+struct FGridBatchStats
+{
+	int32 NumQueries = 0;
+	int32 NumFound = 0;
+	int32 NumWorkers = 0;
+	int64 NodesExpanded = 0;
+	double Seconds = 0.0;
+	double QueriesPerSecond = 0.0;
+};
+
+/**
+ * Solves many start/goal pairs on one graph in parallel.
+ * Every worker owns an FGridSearch that lives as long as this object, so after the first batch no query allocates
+ * or clears a full grid of buffers. Workers pull the next request from a shared counter, which keeps them busy when
+ * some queries are much longer than others.
+ */
+class FGridBatchSearch
+{
+public:
+	/**
+	 * Runs Body(WorkerIndex) for WorkerIndex 0..NumWorkers-1, possibly in parallel, and returns when all are done.
+	 * The game module passes ParallelFor here, the default spawns std::threads
+	 */
+	typedef std::function<void(int32 NumWorkers, const std::function<void(int32 WorkerIndex)>& Body)> FParallelRunner;
+
+	/**
+	 * Solve every request on Graph. OutResults gets one entry per request, in request order; their buffers are reused
+	 * between calls. VisitedOrder is only filled with bRecordVisitedOrder. NumWorkers <= 0 uses every hardware thread
+	 */
+	FGridBatchStats Solve(const FGridGraph& Graph, const std::vector<FGridPathRequest>& Requests, EGridSearchAlgorithm Algorithm, EGridOpenList OpenList,
+		std::vector<FGridSearchResult>& OutResults, int32 NumWorkers = 0, bool bRecordVisitedOrder = false, const FParallelRunner& Runner = FParallelRunner());
+
+	/** Number of worker scratch buffers currently kept */
+	int32 GetNumWorkers() const { return (int32)Workers.size(); }
+
+	/** Heap bytes held by the workers' scratch */
+	int64 GetAllocatedBytes() const;
+
+private:
+	std::vector<std::unique_ptr<FGridSearch>> Workers;
+};
@@ -0,0 +1,437 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "GridBenchmark.h"
+#include "GridGraph.h"
+#include "GridRandom.h"
+#include "GridMemory.h"
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <unordered_map>
+#include <unordered_set>
+
+std::vector<FGridBenchmarkResult> FGridBenchmark::CompareOpenLists(const FGridGraph& Graph, int32 Iterations)
+{
+	std::vector<FGridBenchmarkResult> Results;
+	for (EGridSearchAlgorithm Algorithm : { EGridSearchAlgorithm::Dijkstra, EGridSearchAlgorithm::AStar, EGridSearchAlgorithm::BidirectionalDijkstra, EGridSearchAlgorithm::BidirectionalAStar })
+	{
+		for (EGridOpenList OpenList : { EGridOpenList::Heap, EGridOpenList::Buckets })
+		{
+			Results.push_back(Time(Graph, Algorithm, OpenList, Iterations));
+		}
+	}
+	return Results;
+}
+
+FGridBenchmarkResult FGridBenchmark::Time(const FGridGraph& Graph, EGridSearchAlgorithm Algorithm, EGridOpenList OpenList, int32 Iterations)
+{
+	FGridBenchmarkResult Result;
+	Result.Algorithm = Algorithm;
+	Result.OpenList = OpenList;
+
+	if (Iterations < 1)
+	{
+		Iterations = 1;
+	}
+
+	FGridSearch Search;
+	FGridSearchResult SearchResult;
+
+	//One untimed run so buffer allocation isn't counted
+	Search.Run(Graph, Algorithm, SearchResult, OpenList);
+
+	const auto StartTime = std::chrono::steady_clock::now();
+	for (int32 i = 0; i < Iterations; i++)
+	{
+		Search.Run(Graph, Algorithm, SearchResult, OpenList);
+	}
+	const std::chrono::duration<double, std::milli> Elapsed = std::chrono::steady_clock::now() - StartTime;
+
+	Result.AverageMilliseconds = Elapsed.count() / Iterations;
+	Result.NodesExpanded = SearchResult.NodesExpanded;
+	Result.Cost = SearchResult.Cost;
+	return Result;
+}
+
+double FGridBenchmark::TimeBitsetSearch(const FGridGraph& Graph, int32 Iterations, int32& OutSteps)
+{
+	if (Iterations < 1)
+	{
+		Iterations = 1;
+	}
+
+	//Packing the walls is left out, like the buffer allocation in Time
+	FGridBitsetSearch Search;
+	Search.Build(Graph);
+
+	const auto StartTime = std::chrono::steady_clock::now();
+	for (int32 i = 0; i < Iterations; i++)
+	{
+		OutSteps = Search.GetStepDistance(Graph.GetStart(), Graph.GetGoal());
+	}
+	const std::chrono::duration<double, std::milli> Elapsed = std::chrono::steady_clock::now() - StartTime;
+	return Elapsed.count() / Iterations;
+}
+
+std::vector<FGridMazeStats> FGridBenchmark::CompareMazes(int32 Width, int32 Height, uint32 Seed, float BraidFraction)
+{
+	std::vector<FGridMazeStats> Results;
+	FGridGraph Graph(Width, Height);
+	FGridMazeGenerator Generator;
+	for (int32 Algorithm = 0; Algorithm < (int32)EGridMazeAlgorithm::Num; Algorithm++)
+	{
+		Results.push_back(Generator.Generate(Graph, Seed, static_cast<EGridMazeAlgorithm>(Algorithm), BraidFraction));
+	}
+	return Results;
+}
+
+const char* GetBenchmarkMapName(EGridBenchmarkMap Map)
+{
+	switch (Map)
+	{
+	case EGridBenchmarkMap::Maze:
+		return "Maze";
+	case EGridBenchmarkMap::RandomObstacles:
+		return "RandomObstacles";
+	case EGridBenchmarkMap::WeightedObstacles:
+		return "WeightedObstacles";
+	default:
+		return "Unknown";
+	}
+}
+
+const char* GetBenchmarkModeName(EGridBenchmarkMode Mode)
+{
+	switch (Mode)
+	{
+	case EGridBenchmarkMode::DijkstraHeap:
+		return "Dijkstra/Heap";
+	case EGridBenchmarkMode::DijkstraBuckets:
+		return "Dijkstra/Buckets";
+	case EGridBenchmarkMode::AStarHeap:
+		return "AStar/Heap";
+	case EGridBenchmarkMode::AStarBuckets:
+		return "AStar/Buckets";
+	case EGridBenchmarkMode::BidirectionalDijkstraHeap:
+		return "BidirectionalDijkstra/Heap";
+	case EGridBenchmarkMode::BidirectionalDijkstraBuckets:
+		return "BidirectionalDijkstra/Buckets";
+	case EGridBenchmarkMode::BidirectionalAStarHeap:
+		return "BidirectionalAStar/Heap";
+	case EGridBenchmarkMode::BidirectionalAStarBuckets:
+		return "BidirectionalAStar/Buckets";
+	case EGridBenchmarkMode::JumpPoint:
+		return "JumpPoint";
+	case EGridBenchmarkMode::JumpPointTable:
+		return "JumpPointTable";
+	case EGridBenchmarkMode::Hierarchical:
+		return "Hierarchical";
+	case EGridBenchmarkMode::Bitset:
+		return "Bitset";
+	default:
+		return "Unknown";
+	}
+}
+
+std::string FGridBenchmarkRecord::GetKey() const
+{
+	return Map + "/" + std::to_string(Size) + "/" + std::to_string(Seed) + "/" + Mode;
+}
+
+void FGridBenchmark::BuildMap(FGridGraph& Graph, EGridBenchmarkMap Map, int32 Size, uint32 Seed, const FGridBenchmarkSuiteSettings& Settings)
+{
+	Graph.Init(Size, Size);
+	if (Map == EGridBenchmarkMap::Maze)
+	{
+		FGridMazeGenerator Generator;
+		Generator.Generate(Graph, Seed, EGridMazeAlgorithm::RecursiveBacktracker, Settings.BraidFraction);
+
+		//First and last room
+		const int32 LastRoom = 2 * FGridMazeGenerator::GetNumRooms(Size) - 1;
+		Graph.SetStart(Graph.GetIndex(1, 1));
+		Graph.SetGoal(Graph.GetIndex(LastRoom, LastRoom));
+		return;
+	}
+
+	FGridRandom Random;
+	Random.Seed(Seed);
+	for (int32 Index = 0; Index < Graph.Num(); Index++)
+	{
+		if (Random.FRand() < Settings.ObstacleDensity)
+		{
+			Graph.SetWall(Index, true);
+		}
+		if (Map == EGridBenchmarkMap::WeightedObstacles)
+		{
+			Graph.SetCost(Index, 1 + Random.RandRange(9));
+		}
+	}
+
+	//Keep the corners from being walled in
+	for (int32 Offset = 0; Offset < 4; Offset++)
+	{
+		const int32 X = Offset & 1;
+		const int32 Y = Offset >> 1;
+		Graph.SetWall(Graph.GetIndex(X, Y), false);
+		Graph.SetWall(Graph.GetIndex(Size - 1 - X, Size - 1 - Y), false);
+	}
+	Graph.SetStart(0);
+	Graph.SetGoal(Graph.Num() - 1);
+}
+
+bool FGridBenchmarkSearcher::Init(const FGridGraph& InGraph, EGridBenchmarkMode InMode)
+{
+	const bool bNeedsUniformCosts = (InMode == EGridBenchmarkMode::JumpPoint) || (InMode == EGridBenchmarkMode::JumpPointTable) || (InMode == EGridBenchmarkMode::Bitset);
+	if (bNeedsUniformCosts && (InGraph.GetMinCost() != InGraph.GetMaxCost()))
+	{
+		return false;
+	}
+
+	Graph = &InGraph;
+	Mode = InMode;
+	Search.SetRecordVisitedOrder(false);
+	Bitset.SetRecordVisitedOrder(false);
+	if (Mode == EGridBenchmarkMode::JumpPointTable)
+	{
+		Table.Rebuild(InGraph);
+	}
+	else if (Mode == EGridBenchmarkMode::Hierarchical)
+	{
+		Hierarchy.Build(InGraph);
+	}
+	else if (Mode == EGridBenchmarkMode::Bitset)
+	{
+		Bitset.Build(InGraph);
+	}
+	return true;
+}
+
+void FGridBenchmarkSearcher::Run(int32 Start, int32 Goal, FGridSearchResult& OutResult)
+{
+	switch (Mode)
+	{
+	case EGridBenchmarkMode::JumpPoint:
+		Search.RunJumpPoint(*Graph, Start, Goal, nullptr, OutResult);
+		break;
+	case EGridBenchmarkMode::JumpPointTable:
+		Search.RunJumpPoint(*Graph, Start, Goal, &Table, OutResult);
+		break;
+	case EGridBenchmarkMode::Hierarchical:
+		Hierarchy.FindPath(*Graph, Start, Goal, OutResult);
+		break;
+	case EGridBenchmarkMode::Bitset:
+		Bitset.Run(*Graph, Start, Goal, OutResult);
+		break;
+	default:
+	{
+		//The first eight modes pair each algorithm with the heap and then the buckets
+		static const EGridSearchAlgorithm Algorithms[] = { EGridSearchAlgorithm::Dijkstra, EGridSearchAlgorithm::AStar, EGridSearchAlgorithm::BidirectionalDijkstra, EGridSearchAlgorithm::BidirectionalAStar };
+		const EGridSearchAlgorithm Algorithm = Algorithms[(int32)Mode / 2];
+		const EGridOpenList OpenList = ((int32)Mode % 2) == 0 ? EGridOpenList::Heap : EGridOpenList::Buckets;
+		Search.Run(*Graph, Start, Goal, Algorithm, OutResult, OpenList);
+		break;
+	}
+	}
+}
+
+int64 FGridBenchmarkSearcher::GetAllocatedBytes() const
+{
+	return Search.GetAllocatedBytes() + Table.GetAllocatedBytes() + Hierarchy.GetAllocatedBytes() + Bitset.GetAllocatedBytes();
+}
+
+bool FGridBenchmark::RunCase(const FGridGraph& Graph, EGridBenchmarkMode Mode, int32 Iterations, FGridBenchmarkRecord& OutRecord)
+{
+	//Precomputation happens here, outside the timed runs
+	FGridBenchmarkSearcher Searcher;
+	if (!Searcher.Init(Graph, Mode))
+	{
+		return false;
+	}
+
+	const int32 Start = Graph.GetStart();
+	const int32 Goal = Graph.GetGoal();
+	FGridSearchResult Result;
+
+	//One untimed run so buffer allocation isn't counted
+	Searcher.Run(Start, Goal, Result);
+
+	Iterations = std::max(Iterations, 1);
+	const auto StartTime = std::chrono::steady_clock::now();
+	for (int32 i = 0; i < Iterations; i++)
+	{
+		Searcher.Run(Start, Goal, Result);
+	}
+	const std::chrono::duration<double, std::milli> Elapsed = std::chrono::steady_clock::now() - StartTime;
+
+	OutRecord.Mode = GetBenchmarkModeName(Mode);
+	OutRecord.bFound = Result.bFound;
+	OutRecord.Cost = Result.Cost;
+	OutRecord.Milliseconds = Elapsed.count() / Iterations;
+	OutRecord.NodesExpanded = Result.NodesExpanded;
+	OutRecord.PeakOpenListSize = Result.PeakOpenListSize;
+	OutRecord.Bytes = Searcher.GetAllocatedBytes()
+		+ GridMemory::GetAllocatedBytes(Result.Path) + GridMemory::GetAllocatedBytes(Result.VisitedOrder) + GridMemory::GetAllocatedBytes(Result.VisitedFromGoal);
+	return true;
+}
+
+std::vector<FGridBenchmarkRecord> FGridBenchmark::RunSuite(const FGridBenchmarkSuiteSettings& Settings, const std::function<void(const FGridBenchmarkRecord&)>& OnRecord)
+{
+	std::vector<FGridBenchmarkRecord> Records;
+	FGridGraph Graph;
+	for (int32 Map = 0; Map < (int32)EGridBenchmarkMap::Num; Map++)
+	{
+		for (int32 Size : Settings.Sizes)
+		{
+			for (uint32 Seed : Settings.Seeds)
+			{
+				BuildMap(Graph, static_cast<EGridBenchmarkMap>(Map), Size, Seed, Settings);
+				for (int32 Mode = 0; Mode < (int32)EGridBenchmarkMode::Num; Mode++)
+				{
+					FGridBenchmarkRecord Record;
+					Record.Map = GetBenchmarkMapName(static_cast<EGridBenchmarkMap>(Map));
+					Record.Size = Size;
+					Record.Seed = Seed;
+					if (RunCase(Graph, static_cast<EGridBenchmarkMode>(Mode), Settings.Iterations, Record))
+					{
+						if (OnRecord)
+						{
+							OnRecord(Record);
+						}
+						Records.push_back(Record);
+					}
+				}
+			}
+		}
+	}
+	return Records;
+}
+
+bool FGridBenchmark::WriteCsv(const char* Path, const std::vector<FGridBenchmarkRecord>& Records)
+{
+	FILE* File = fopen(Path, "w");
+	if (File == nullptr)
+	{
+		return false;
+	}
+
+	fprintf(File, "map,size,seed,mode,found,cost,milliseconds,nodes_expanded,peak_open_list,bytes\n");
+	for (const FGridBenchmarkRecord& Record : Records)
+	{
+		fprintf(File, "%s,%d,%u,%s,%d,%d,%.6f,%d,%d,%" PRId64 "\n", Record.Map.c_str(), Record.Size, Record.Seed, Record.Mode.c_str(),
+			Record.bFound ? 1 : 0, Record.Cost, Record.Milliseconds, Record.NodesExpanded, Record.PeakOpenListSize, (int64_t)Record.Bytes);
+	}
+	return fclose(File) == 0;
+}
+
+bool FGridBenchmark::WriteJson(const char* Path, const std::vector<FGridBenchmarkRecord>& Records)
+{
+	FILE* File = fopen(Path, "w");
+	if (File == nullptr)
+	{
+		return false;
+	}
+
+	fprintf(File, "[\n");
+	for (size_t i = 0; i < Records.size(); i++)
+	{
+		const FGridBenchmarkRecord& Record = Records[i];
+		fprintf(File, "\t{\"map\": \"%s\", \"size\": %d, \"seed\": %u, \"mode\": \"%s\", \"found\": %s, \"cost\": %d, "
+			"\"milliseconds\": %.6f, \"nodes_expanded\": %d, \"peak_open_list\": %d, \"bytes\": %" PRId64 "}%s\n",
+			Record.Map.c_str(), Record.Size, Record.Seed, Record.Mode.c_str(), Record.bFound ? "true" : "false", Record.Cost,
+			Record.Milliseconds, Record.NodesExpanded, Record.PeakOpenListSize, (int64_t)Record.Bytes, (i + 1 < Records.size()) ? "," : "");
+	}
+	fprintf(File, "]\n");
+	return fclose(File) == 0;
+}
+
+bool FGridBenchmark::ReadCsv(const char* Path, std::vector<FGridBenchmarkRecord>& OutRecords)
+{
+	OutRecords.clear();
+	FILE* File = fopen(Path, "r");
+	if (File == nullptr)
+	{
+		return false;
+	}
+
+	char Line[512];
+	char Map[128];
+	char Mode[128];
+	bool bHeader = true;
+	while (fgets(Line, sizeof(Line), File) != nullptr)
+	{
+		if (bHeader)
+		{
+			bHeader = false;
+			continue;
+		}
+
+		FGridBenchmarkRecord Record;
+		int32 bFound = 0;
+		int64_t Bytes = 0;
+		if (sscanf(Line, "%127[^,],%d,%u,%127[^,],%d,%d,%lf,%d,%d,%" SCNd64, Map, &Record.Size, &Record.Seed, Mode, &bFound, &Record.Cost,
+			&Record.Milliseconds, &Record.NodesExpanded, &Record.PeakOpenListSize, &Bytes) == 10)
+		{
+			Record.Map = Map;
+			Record.Mode = Mode;
+			Record.bFound = bFound != 0;
+			Record.Bytes = Bytes;
+			OutRecords.push_back(Record);
+		}
+	}
+	fclose(File);
+	return true;
+}
+
+std::vector<FGridBenchmarkRegression> FGridBenchmark::FindRegressions(const std::vector<FGridBenchmarkRecord>& Current, const std::vector<FGridBenchmarkRecord>& Baseline, const FGridBenchmarkThresholds& Thresholds)
+{
+	std::unordered_map<std::string, const FGridBenchmarkRecord*> BaselineByKey;
+	for (const FGridBenchmarkRecord& Record : Baseline)
+	{
+		BaselineByKey[Record.GetKey()] = &Record;
+	}
+
+	std::vector<FGridBenchmarkRegression> Regressions;
+	std::unordered_set<std::string> CurrentKeys;
+	for (const FGridBenchmarkRecord& Record : Current)
+	{
+		CurrentKeys.insert(Record.GetKey());
+		const auto Found = BaselineByKey.find(Record.GetKey());
+		if (Found == BaselineByKey.end())
+		{
+			continue;
+		}
+
+		const FGridBenchmarkRecord& Base = *Found->second;
+		auto Check = [&Regressions, &Record](const char* Metric, double BaseValue, double CurrentValue, double MaxRatio)
+		{
+			if (CurrentValue > BaseValue * MaxRatio)
+			{
+				Regressions.push_back(FGridBenchmarkRegression{ Record.GetKey(), Metric, BaseValue, CurrentValue });
+			}
+		};
+
+		//A search that finds another cost is wrong rather than slow
+		if ((Record.bFound != Base.bFound) || (Record.Cost != Base.Cost))
+		{
+			Regressions.push_back(FGridBenchmarkRegression{ Record.GetKey(), "cost", (double)Base.Cost, (double)Record.Cost });
+		}
+		if (Base.Milliseconds >= Thresholds.MinGatedMilliseconds)
+		{
+			Check("milliseconds", Base.Milliseconds, Record.Milliseconds, Thresholds.MaxTimeRatio);
+		}
+		Check("nodes_expanded", Base.NodesExpanded, Record.NodesExpanded, Thresholds.MaxNodesRatio);
+		Check("peak_open_list", Base.PeakOpenListSize, Record.PeakOpenListSize, Thresholds.MaxPeakOpenListRatio);
+		Check("bytes", (double)Base.Bytes, (double)Record.Bytes, Thresholds.MaxBytesRatio);
+	}
+
+	//A case that stopped running, or crashed out of the suite, would otherwise pass the gate
+	for (const FGridBenchmarkRecord& Base : Baseline)
+	{
+		if (CurrentKeys.count(Base.GetKey()) == 0)
+		{
+			Regressions.push_back(FGridBenchmarkRegression{ Base.GetKey(), "missing", 1.0, 0.0 });
+		}
+	}
+	return Regressions;
+}
@@ -0,0 +1,191 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "GridTypes.h"
+#include "GridSearch.h"
+#include "GridMaze.h"
+#include "GridBitsetSearch.h"
+#include "JumpPointSearch.h"
+#include "HierarchicalSearch.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+/** Timing of one algorithm / open list combination */
+struct FGridBenchmarkResult
+{
+	EGridSearchAlgorithm Algorithm = EGridSearchAlgorithm::Dijkstra;
+	EGridOpenList OpenList = EGridOpenList::Heap;
+
+	/** Mean wall time of one search */
+	double AverageMilliseconds = 0.0;
+
+	int32 NodesExpanded = 0;
+	int32 Cost = GridUnreachable;
+};
+
+/** Boards the benchmark suite generates */
+enum class EGridBenchmarkMap : uint8
+{
+	/** Braided recursive backtracker maze, start and goal in opposite corner rooms */
+	Maze,
+	/** Random walls, uniform costs, start and goal in opposite corners */
+	RandomObstacles,
+	/** RandomObstacles with random costs 1..9, so JPS and the bitset search sit it out */
+	WeightedObstacles,
+	Num
+};
+
+/** Search configurations the suite times */
+enum class EGridBenchmarkMode : uint8
+{
+	DijkstraHeap,
+	DijkstraBuckets,
+	AStarHeap,
+	AStarBuckets,
+	BidirectionalDijkstraHeap,
+	BidirectionalDijkstraBuckets,
+	BidirectionalAStarHeap,
+	BidirectionalAStarBuckets,
+	/** Jump Point Search scanning cells */
+	JumpPoint,
+	/** JPS+ on a precomputed table */
+	JumpPointTable,
+	/** HPA* with refined paths */
+	Hierarchical,
+	/** Bit-parallel breadth-first search */
+	Bitset,
+	Num
+};
+
+const char* GetBenchmarkMapName(EGridBenchmarkMap Map);
+const char* GetBenchmarkModeName(EGridBenchmarkMode Mode);
+
+/** One mode set up on one graph, its precomputation done, ready to search between any two cells */
+class FGridBenchmarkSearcher
+{
+public:
+	/** Build what Mode needs from Graph, which has to outlive the searcher. Returns false if the mode can't run on Graph's costs */
+	bool Init(const FGridGraph& InGraph, EGridBenchmarkMode InMode);
+
+	void Run(int32 Start, int32 Goal, FGridSearchResult& OutResult);
+
+	/** Heap bytes the search buffers and precomputed data hold */
+	int64 GetAllocatedBytes() const;
+
+	/** Every mode but HPA* always finds a cheapest path */
+	static bool IsExact(EGridBenchmarkMode Mode) { return Mode != EGridBenchmarkMode::Hierarchical; }
+
+private:
+	const FGridGraph* Graph = nullptr;
+	EGridBenchmarkMode Mode = EGridBenchmarkMode::DijkstraHeap;
+	FGridSearch Search;
+	FJumpPointTable Table;
+	FGridHierarchy Hierarchy;
+	FGridBitsetSearch Bitset;
+};
+
+/** What RunSuite covers */
+struct FGridBenchmarkSuiteSettings
+{
+	/** Side of the square boards */
+	std::vector<int32> Sizes = { 25, 64, 256, 1024, 4096 };
+	std::vector<uint32> Seeds = { 1 };
+
+	/** Timed runs of each case, after one untimed warm-up */
+	int32 Iterations = 3;
+
+	/** Share of wall cells on the obstacle maps */
+	float ObstacleDensity = 0.25f;
+
+	/** Share of dead ends opened up on the maze map, so there is more than one route */
+	float BraidFraction = 0.1f;
+};
+
+/** One map / size / seed / mode case of the suite */
+struct FGridBenchmarkRecord
+{
+	std::string Map;
+	int32 Size = 0;
+	uint32 Seed = 0;
+	std::string Mode;
+	bool bFound = false;
+	int32 Cost = GridUnreachable;
+
+	/** Mean wall time of one search, precomputation like the JPS+ table or the HPA* clusters left out */
+	double Milliseconds = 0.0;
+
+	int32 NodesExpanded = 0;
+
+	/** Most cells on the open list at once; the widest layer for the bitset search, abstract nodes for HPA* */
+	int32 PeakOpenListSize = 0;
+
+	/** Heap bytes the search's buffers, precomputed data and result hold after the runs */
+	int64 Bytes = 0;
+
+	/** Identifies the case across runs: map/size/seed/mode */
+	std::string GetKey() const;
+};
+
+/** How much worse than the baseline a case may get before it counts as a regression */
+struct FGridBenchmarkThresholds
+{
+	double MaxTimeRatio = 1.25;
+
+	/** Cases faster than this in the baseline are too noisy to gate on time */
+	double MinGatedMilliseconds = 0.05;
+
+	double MaxNodesRatio = 1.0;
+	double MaxPeakOpenListRatio = 1.0;
+	double MaxBytesRatio = 1.10;
+};
+
+/** One metric of one case over its threshold. A changed path cost is always a regression */
+struct FGridBenchmarkRegression
+{
+	std::string Key;
+	std::string Metric;
+	double Baseline = 0.0;
+	double Current = 0.0;
+};
+
+/** Headless timing helpers for the grid searches */
+struct FGridBenchmark
+{
+	/** Time Dijkstra and A* with both open lists between Graph's start and goal, Iterations runs each */
+	static std::vector<FGridBenchmarkResult> CompareOpenLists(const FGridGraph& Graph, int32 Iterations);
+
+	/** Time a single configuration */
+	static FGridBenchmarkResult Time(const FGridGraph& Graph, EGridSearchAlgorithm Algorithm, EGridOpenList OpenList, int32 Iterations);
+
+	/** Mean milliseconds of a bit-parallel breadth-first search between Graph's start and goal, the step count goes to OutSteps */
+	static double TimeBitsetSearch(const FGridGraph& Graph, int32 Iterations, int32& OutSteps);
+
+	/** Generate one Width x Height maze with every maze algorithm, same seed and braiding for all */
+	static std::vector<FGridMazeStats> CompareMazes(int32 Width, int32 Height, uint32 Seed, float BraidFraction);
+
+	/** Fill Graph with a benchmark map and set its start and goal */
+	static void BuildMap(FGridGraph& Graph, EGridBenchmarkMap Map, int32 Size, uint32 Seed, const FGridBenchmarkSuiteSettings& Settings);
+
+	/** Time one mode between Graph's start and goal. Modes that can't run on the map's costs return false */
+	static bool RunCase(const FGridGraph& Graph, EGridBenchmarkMode Mode, int32 Iterations, FGridBenchmarkRecord& OutRecord);
+
+	/** Run every mode on every map, size and seed. OnRecord, if set, sees each record as soon as it is done */
+	static std::vector<FGridBenchmarkRecord> RunSuite(const FGridBenchmarkSuiteSettings& Settings, const std::function<void(const FGridBenchmarkRecord&)>& OnRecord = nullptr);
+
+	/** Write records as CSV with a header row. Returns false if the file can't be written */
+	static bool WriteCsv(const char* Path, const std::vector<FGridBenchmarkRecord>& Records);
+
+	/** Write records as a JSON array of objects */
+	static bool WriteJson(const char* Path, const std::vector<FGridBenchmarkRecord>& Records);
+
+	/** Read records written by WriteCsv, to use as a baseline */
+	static bool ReadCsv(const char* Path, std::vector<FGridBenchmarkRecord>& OutRecords);
+
+	/**
+	 * Cases of Current that got worse than their Baseline counterpart by more than Thresholds allow. Baseline cases missing
+	 * from Current are reported with the metric "missing", new cases with no baseline are skipped
+	 */
+	static std::vector<FGridBenchmarkRegression> FindRegressions(const std::vector<FGridBenchmarkRecord>& Current, const std::vector<FGridBenchmarkRecord>& Baseline, const FGridBenchmarkThresholds& Thresholds);
+};
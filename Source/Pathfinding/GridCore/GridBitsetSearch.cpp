@@ -0,0 +1,379 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "GridBitsetSearch.h"
+#include "GridGraph.h"
+#include "GridSearch.h"
+#include "GridMemory.h"
+#include <algorithm>
+#include <utility>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define GRID_BITSET_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GRID_BITSET_SSE2 1
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace GridBitsetSearch
+{
+	int32 CountTrailingZeros(uint64 Word)
+	{
+#if defined(_MSC_VER)
+		unsigned long Bit;
+		_BitScanForward64(&Bit, Word);
+		return (int32)Bit;
+#else
+		return __builtin_ctzll(Word);
+#endif
+	}
+
+	int32 CountBits(uint64 Word)
+	{
+		Word = Word - ((Word >> 1) & 0x5555555555555555ull);
+		Word = (Word & 0x3333333333333333ull) + ((Word >> 2) & 0x3333333333333333ull);
+		Word = (Word + (Word >> 4)) & 0x0f0f0f0f0f0f0f0full;
+		return (int32)((Word * 0x0101010101010101ull) >> 56);
+	}
+
+	/**
+	 * One row of a step: every frontier cell of the row and the rows above and below spreads to its four neighbors,
+	 * limited to open cells not visited before. Words W0..W1 of the row are written; MinWord/MaxWord widen to cover
+	 * the new bits, rounded out to whole vectors
+	 */
+	void StepRow(const uint64* Up, const uint64* Mid, const uint64* Down, const uint64* Open, uint64* Visited, uint64* Next, int32 W0, int32 W1, int32& MinWord, int32& MaxWord)
+	{
+		int32 Word = W0;
+#if GRID_BITSET_AVX2
+		for (; Word + 3 <= W1; Word += 4)
+		{
+			const __m256i Cells = _mm256_loadu_si256((const __m256i*)(Mid + Word));
+			const __m256i Left = _mm256_loadu_si256((const __m256i*)(Mid + Word - 1));
+			const __m256i Right = _mm256_loadu_si256((const __m256i*)(Mid + Word + 1));
+			__m256i Grown = _mm256_or_si256(_mm256_slli_epi64(Cells, 1), _mm256_srli_epi64(Left, 63));
+			Grown = _mm256_or_si256(Grown, _mm256_or_si256(_mm256_srli_epi64(Cells, 1), _mm256_slli_epi64(Right, 63)));
+			Grown = _mm256_or_si256(Grown, _mm256_or_si256(_mm256_loadu_si256((const __m256i*)(Up + Word)), _mm256_loadu_si256((const __m256i*)(Down + Word))));
+			const __m256i Seen = _mm256_loadu_si256((const __m256i*)(Visited + Word));
+			const __m256i New = _mm256_andnot_si256(Seen, _mm256_and_si256(Grown, _mm256_loadu_si256((const __m256i*)(Open + Word))));
+			_mm256_storeu_si256((__m256i*)(Next + Word), New);
+			_mm256_storeu_si256((__m256i*)(Visited + Word), _mm256_or_si256(Seen, New));
+			if (!_mm256_testz_si256(New, New))
+			{
+				MinWord = std::min(MinWord, Word);
+				MaxWord = std::max(MaxWord, Word + 3);
+			}
+		}
+#elif GRID_BITSET_SSE2
+		for (; Word + 1 <= W1; Word += 2)
+		{
+			const __m128i Cells = _mm_loadu_si128((const __m128i*)(Mid + Word));
+			const __m128i Left = _mm_loadu_si128((const __m128i*)(Mid + Word - 1));
+			const __m128i Right = _mm_loadu_si128((const __m128i*)(Mid + Word + 1));
+			__m128i Grown = _mm_or_si128(_mm_slli_epi64(Cells, 1), _mm_srli_epi64(Left, 63));
+			Grown = _mm_or_si128(Grown, _mm_or_si128(_mm_srli_epi64(Cells, 1), _mm_slli_epi64(Right, 63)));
+			Grown = _mm_or_si128(Grown, _mm_or_si128(_mm_loadu_si128((const __m128i*)(Up + Word)), _mm_loadu_si128((const __m128i*)(Down + Word))));
+			const __m128i Seen = _mm_loadu_si128((const __m128i*)(Visited + Word));
+			const __m128i New = _mm_andnot_si128(Seen, _mm_and_si128(Grown, _mm_loadu_si128((const __m128i*)(Open + Word))));
+			_mm_storeu_si128((__m128i*)(Next + Word), New);
+			_mm_storeu_si128((__m128i*)(Visited + Word), _mm_or_si128(Seen, New));
+			if (_mm_movemask_epi8(_mm_cmpeq_epi8(New, _mm_setzero_si128())) != 0xffff)
+			{
+				MinWord = std::min(MinWord, Word);
+				MaxWord = std::max(MaxWord, Word + 1);
+			}
+		}
+#endif
+		for (; Word <= W1; Word++)
+		{
+			const uint64 Cells = Mid[Word];
+			const uint64 Grown = (Cells << 1) | (Mid[Word - 1] >> 63) | (Cells >> 1) | (Mid[Word + 1] << 63) | Up[Word] | Down[Word];
+			const uint64 New = Grown & Open[Word] & ~Visited[Word];
+			Next[Word] = New;
+			Visited[Word] |= New;
+			if (New != 0)
+			{
+				MinWord = std::min(MinWord, Word);
+				MaxWord = std::max(MaxWord, Word);
+			}
+		}
+	}
+}
+
+int64 FGridBitsetSearch::GetAllocatedBytes() const
+{
+	return GridMemory::GetAllocatedBytes(Open) + GridMemory::GetAllocatedBytes(Visited) + GridMemory::GetAllocatedBytes(Frontier)
+		+ GridMemory::GetAllocatedBytes(Next) + GridMemory::GetAllocatedBytes(FrontierMinWord) + GridMemory::GetAllocatedBytes(FrontierMaxWord)
+		+ GridMemory::GetAllocatedBytes(NextMinWord) + GridMemory::GetAllocatedBytes(NextMaxWord) + GridMemory::GetAllocatedBytes(Distance)
+		+ GridMemory::GetAllocatedBytes(Touched);
+}
+
+const char* FGridBitsetSearch::GetSimdName()
+{
+#if GRID_BITSET_AVX2
+	return "AVX2";
+#elif GRID_BITSET_SSE2
+	return "SSE2";
+#else
+	return "Scalar";
+#endif
+}
+
+void FGridBitsetSearch::Build(const FGridGraph& Graph)
+{
+	Width = Graph.GetWidth();
+	Height = Graph.GetHeight();
+	WordsPerRow = (Width + 63) / 64;
+	Stride = WordsPerRow + 2;
+
+	//Every array gets a zero row above and below the grid as well
+	const size_t NumWords = (size_t)Stride * (Height + 2);
+	Open.assign(NumWords, 0);
+	Visited.assign(NumWords, 0);
+	Frontier.assign(NumWords, 0);
+	Next.assign(NumWords, 0);
+	FrontierMinWord.assign(Height, WordsPerRow);
+	FrontierMaxWord.assign(Height, -1);
+	NextMinWord.assign(Height, WordsPerRow);
+	NextMaxWord.assign(Height, -1);
+	Distance.assign(Graph.Num(), GridUnreachable);
+	Touched.clear();
+
+	for (int32 Index = 0; Index < Graph.Num(); Index++)
+	{
+		if (Graph.IsWalkable(Index))
+		{
+			const int32 X = Graph.GetX(Index);
+			Open[GetWord(X, Graph.GetY(Index))] |= 1ull << (X & 63);
+		}
+	}
+	bBuilt = true;
+}
+
+void FGridBitsetSearch::UpdateCell(const FGridGraph& Graph, int32 Index)
+{
+	if (!bBuilt)
+	{
+		return;
+	}
+
+	const int32 X = Graph.GetX(Index);
+	const uint64 Bit = 1ull << (X & 63);
+	uint64& Word = Open[GetWord(X, Graph.GetY(Index))];
+	Word = Graph.IsWalkable(Index) ? (Word | Bit) : (Word & ~Bit);
+}
+
+template <typename LayerType>
+int32 FGridBitsetSearch::Flood(int32 Start, int32 Goal, LayerType&& OnLayer)
+{
+	std::fill(Visited.begin(), Visited.end(), 0);
+	std::fill(Frontier.begin(), Frontier.end(), 0);
+	std::fill(Next.begin(), Next.end(), 0);
+	std::fill(FrontierMinWord.begin(), FrontierMinWord.end(), WordsPerRow);
+	std::fill(FrontierMaxWord.begin(), FrontierMaxWord.end(), -1);
+	std::fill(NextMinWord.begin(), NextMinWord.end(), WordsPerRow);
+	std::fill(NextMaxWord.begin(), NextMaxWord.end(), -1);
+
+	const int32 StartX = Start % Width;
+	const int32 StartY = Start / Width;
+	const uint64 StartBit = 1ull << (StartX & 63);
+	if ((Open[GetWord(StartX, StartY)] & StartBit) == 0)
+	{
+		return GridUnreachable;
+	}
+
+	Frontier[GetWord(StartX, StartY)] = StartBit;
+	Visited[GetWord(StartX, StartY)] = StartBit;
+	FrontierMinWord[StartY] = FrontierMaxWord[StartY] = StartX >> 6;
+	FrontierMinRow = FrontierMaxRow = StartY;
+	if (Start == Goal)
+	{
+		return 0;
+	}
+
+	const int32 GoalWord = Goal != GridInvalidIndex ? GetWord(Goal % Width, Goal / Width) : 0;
+	const uint64 GoalBit = Goal != GridInvalidIndex ? 1ull << ((Goal % Width) & 63) : 0;
+	for (int32 Layer = 1; ; Layer++)
+	{
+		if (!Step())
+		{
+			return GridUnreachable;
+		}
+
+		OnLayer(Layer);
+		if ((Next[GoalWord] & GoalBit) != 0)
+		{
+			return Layer;
+		}
+
+		//The old frontier becomes the next output buffer, so its words are cleared where it had bits
+		for (int32 Row = FrontierMinRow; Row <= FrontierMaxRow; Row++)
+		{
+			if (FrontierMinWord[Row] <= FrontierMaxWord[Row])
+			{
+				uint64* RowWords = &Frontier[(size_t)(Row + 1) * Stride + 1];
+				std::fill(RowWords + FrontierMinWord[Row], RowWords + FrontierMaxWord[Row] + 1, 0);
+			}
+		}
+		std::swap(Frontier, Next);
+		std::swap(FrontierMinWord, NextMinWord);
+		std::swap(FrontierMaxWord, NextMaxWord);
+		FrontierMinRow = NextMinRow;
+		FrontierMaxRow = NextMaxRow;
+	}
+}
+
+bool FGridBitsetSearch::Step()
+{
+	NextMinRow = Height;
+	NextMaxRow = -1;
+	const int32 FirstRow = std::max(FrontierMinRow - 1, 0);
+	const int32 LastRow = std::min(FrontierMaxRow + 1, Height - 1);
+	for (int32 Row = FirstRow; Row <= LastRow; Row++)
+	{
+		//Bits move at most one word sideways and one row up or down per step
+		int32 W0 = WordsPerRow;
+		int32 W1 = -1;
+		for (int32 Source = std::max(Row - 1, FrontierMinRow); Source <= std::min(Row + 1, FrontierMaxRow); Source++)
+		{
+			W0 = std::min(W0, FrontierMinWord[Source]);
+			W1 = std::max(W1, FrontierMaxWord[Source]);
+		}
+		NextMinWord[Row] = WordsPerRow;
+		NextMaxWord[Row] = -1;
+		if (W0 > W1)
+		{
+			continue;
+		}
+
+		W0 = std::max(W0 - 1, 0);
+		W1 = std::min(W1 + 1, WordsPerRow - 1);
+		const size_t RowStart = (size_t)(Row + 1) * Stride + 1;
+		int32 MinWord = WordsPerRow;
+		int32 MaxWord = -1;
+		GridBitsetSearch::StepRow(&Frontier[RowStart - Stride], &Frontier[RowStart], &Frontier[RowStart + Stride], &Open[RowStart], &Visited[RowStart], &Next[RowStart], W0, W1, MinWord, MaxWord);
+		if (MaxWord >= 0)
+		{
+			NextMinWord[Row] = MinWord;
+			NextMaxWord[Row] = MaxWord;
+			NextMinRow = std::min(NextMinRow, Row);
+			NextMaxRow = Row;
+		}
+	}
+
+	//Rows the loop skipped keep stale ranges from two steps ago, they are outside the new row band and never read
+	return NextMaxRow >= 0;
+}
+
+template <typename VisitType>
+void FGridBitsetSearch::ForEachNewCell(VisitType&& Visit) const
+{
+	for (int32 Row = NextMinRow; Row <= NextMaxRow; Row++)
+	{
+		const size_t RowStart = (size_t)(Row + 1) * Stride + 1;
+		for (int32 Word = NextMinWord[Row]; Word <= NextMaxWord[Row]; Word++)
+		{
+			for (uint64 Bits = Next[RowStart + Word]; Bits != 0; Bits &= Bits - 1)
+			{
+				Visit(Row * Width + Word * 64 + GridBitsetSearch::CountTrailingZeros(Bits));
+			}
+		}
+	}
+}
+
+bool FGridBitsetSearch::Run(const FGridGraph& Graph, int32 Start, int32 Goal, FGridSearchResult& OutResult)
+{
+	OutResult.Reset();
+	if (!bBuilt || (Graph.GetWidth() != Width) || (Graph.GetHeight() != Height))
+	{
+		Build(Graph);
+	}
+
+	for (int32 Index : Touched)
+	{
+		Distance[Index] = GridUnreachable;
+	}
+	Touched.clear();
+	if (!Graph.IsValidIndex(Start))
+	{
+		return false;
+	}
+
+	auto Reach = [this, &OutResult](int32 Index, int32 Layer)
+	{
+		Distance[Index] = Layer;
+		Touched.push_back(Index);
+		if (bRecordVisitedOrder)
+		{
+			OutResult.VisitedOrder.push_back(Index);
+		}
+	};
+
+	if (Graph.IsWalkable(Start))
+	{
+		Reach(Start, 0);
+	}
+	const int32 Layers = Flood(Start, Graph.IsValidIndex(Goal) ? Goal : GridInvalidIndex, [this, &Reach, &OutResult](int32 Layer)
+	{
+		const int32 NumBefore = (int32)Touched.size();
+		ForEachNewCell([&Reach, Layer](int32 Index) { Reach(Index, Layer); });
+		OutResult.PeakOpenListSize = std::max(OutResult.PeakOpenListSize, (int32)Touched.size() - NumBefore);
+	});
+	OutResult.NodesExpanded = (int32)Touched.size();
+
+	if (Layers == GridUnreachable || !Graph.IsValidIndex(Goal))
+	{
+		return false;
+	}
+
+	//Walk back down the layers, any neighbor one layer closer is on a shortest path
+	OutResult.bFound = true;
+	OutResult.Cost = Layers * Graph.GetCost(Goal);
+	OutResult.Path.resize(Layers + 1);
+	int32 Cell = Goal;
+	for (int32 Layer = Layers; Layer >= 0; Layer--)
+	{
+		OutResult.Path[Layer] = Cell;
+		int32 Neighbors[4];
+		const int32 NumNeighbors = Graph.GetNeighbors(Cell, Neighbors);
+		for (int32 i = 0; i < NumNeighbors; i++)
+		{
+			if (Distance[Neighbors[i]] == Layer - 1)
+			{
+				Cell = Neighbors[i];
+				break;
+			}
+		}
+	}
+	return true;
+}
+
+int32 FGridBitsetSearch::GetStepDistance(int32 Start, int32 Goal)
+{
+	if (!bBuilt || (Start < 0) || (Start >= Width * Height) || (Goal < 0) || (Goal >= Width * Height))
+	{
+		return GridUnreachable;
+	}
+	return Flood(Start, Goal, [](int32) {});
+}
+
+int32 FGridBitsetSearch::CountReachable(int32 Start)
+{
+	if (!bBuilt || (Start < 0) || (Start >= Width * Height))
+	{
+		return 0;
+	}
+
+	//Everything reachable ends up in Visited
+	Flood(Start, GridInvalidIndex, [](int32) {});
+
+	int32 NumReachable = 0;
+	for (uint64 Word : Visited)
+	{
+		NumReachable += GridBitsetSearch::CountBits(Word);
+	}
+	return NumReachable;
+}
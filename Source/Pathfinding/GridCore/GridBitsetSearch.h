@@ -0,0 +1,105 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "GridTypes.h"
+#include <vector>
+
+class FGridGraph;
+struct FGridSearchResult;
+
+/**
+ * Breadth-first search on a packed walkability bitmap, 64 cells per word. Instead of popping cells one by one, each
+ * step grows the whole frontier by one cell with shifts, ANDs and ORs over the rows it covers, so every cell of a
+ * wavefront layer costs a fraction of an instruction. Only valid when every cell costs the same; the distance of a
+ * cell is then its layer times that cost.
+ * The row loop uses AVX2 when the module is compiled for it, SSE2 on other x86 builds and plain 64 bit words otherwise.
+ */
+class FGridBitsetSearch
+{
+public:
+	/** Pack the graph's walkable cells. Needed once per size, walls after that are kept in sync with UpdateCell */
+	void Build(const FGridGraph& Graph);
+
+	void Invalidate() { bBuilt = false; }
+	bool IsBuilt() const { return bBuilt; }
+
+	/** Mirror a wall change of one cell, does nothing before Build */
+	void UpdateCell(const FGridGraph& Graph, int32 Index);
+
+	/**
+	 * Search from Start to Goal and fill OutResult like FGridSearch does: cost, path, visited cells in layer order
+	 * and per-cell distances for GetDistance. PeakOpenListSize is the widest layer. Goal GridInvalidIndex floods
+	 * everything reachable
+	 */
+	bool Run(const FGridGraph& Graph, int32 Start, int32 Goal, FGridSearchResult& OutResult);
+
+	/** Steps from Start to Goal, GridUnreachable if there is no path. Records nothing per cell, the fastest query */
+	int32 GetStepDistance(int32 Start, int32 Goal);
+
+	/** Cells reachable from Start, Start included */
+	int32 CountReachable(int32 Start);
+
+	/** Steps from the start of the last Run, GridUnreachable if the cell was never reached */
+	int32 GetDistance(int32 Index) const { return Distance[Index]; }
+
+	/** Batch callers that only want paths can skip filling VisitedOrder */
+	void SetRecordVisitedOrder(bool bRecord) { bRecordVisitedOrder = bRecord; }
+
+	int64 GetAllocatedBytes() const;
+
+	/** Instruction set the row loop was compiled for */
+	static const char* GetSimdName();
+
+private:
+	/**
+	 * Flood from Start one layer at a time, stopping after the layer that reaches Goal. Calls OnLayer(Layer) after
+	 * each one with the new cells in Next. Returns the goal's layer or GridUnreachable
+	 */
+	template <typename LayerType>
+	int32 Flood(int32 Start, int32 Goal, LayerType&& OnLayer);
+
+	/** Grow Frontier by one step into Next around the words the frontier covers. Returns false once nothing is new */
+	bool Step();
+
+	/** Call Visit(Index) for every cell set in Next */
+	template <typename VisitType>
+	void ForEachNewCell(VisitType&& Visit) const;
+
+	/** Word of a cell in the padded row-major arrays, the cell is bit X & 63 */
+	int32 GetWord(int32 X, int32 Y) const { return (Y + 1) * Stride + 1 + (X >> 6); }
+
+	int32 Width = 0;
+	int32 Height = 0;
+	int32 WordsPerRow = 0;
+
+	/** Words per stored row: the row plus a zero word on each side, so neighbor loads never need bounds checks */
+	int32 Stride = 0;
+	bool bBuilt = false;
+	bool bRecordVisitedOrder = true;
+
+	/** Walkable cells, with zero padding rows above and below */
+	std::vector<uint64> Open;
+	std::vector<uint64> Visited;
+	std::vector<uint64> Frontier;
+	std::vector<uint64> Next;
+
+	/**
+	 * Words of each row that can hold frontier (or, during a step, new) bits, inclusive and empty when min > max.
+	 * A wavefront is a thin line, so a step only touches a few words per row rather than the whole board
+	 */
+	std::vector<int32> FrontierMinWord;
+	std::vector<int32> FrontierMaxWord;
+	std::vector<int32> NextMinWord;
+	std::vector<int32> NextMaxWord;
+
+	/** Rows with frontier bits, inclusive */
+	int32 FrontierMinRow = 0;
+	int32 FrontierMaxRow = -1;
+	int32 NextMinRow = 0;
+	int32 NextMaxRow = -1;
+
+	/** Per-cell steps of the last Run, reset through Touched */
+	std::vector<int32> Distance;
+	std::vector<int32> Touched;
+};
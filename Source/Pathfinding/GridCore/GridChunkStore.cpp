@@ -0,0 +1,231 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "GridChunkStore.h"
+#include "GridMemory.h"
+#include "GridRandom.h"
+
+namespace GridChunkStore
+{
+	/** Seek that takes the whole 64 bit offset on every platform */
+	bool Seek(std::FILE* File, int64 Offset)
+	{
+#if defined(_WIN32)
+		return _fseeki64(File, Offset, SEEK_SET) == 0;
+#else
+		return fseeko(File, (off_t)Offset, SEEK_SET) == 0;
+#endif
+	}
+
+	/** Random number that depends on nothing but the seed, a chunk and what it is for */
+	uint64 Hash(uint32 Seed, int32 ChunkX, int32 ChunkY, uint32 Salt)
+	{
+		FGridRandom Random(((uint64)Seed << 32) ^ Salt);
+		Random.Seed(Random.Next64() ^ (((uint64)(uint32)ChunkX << 32) | (uint32)ChunkY));
+		return Random.Next64();
+	}
+
+	enum : uint32
+	{
+		ChunkSeedSalt,
+		WestOpeningSalt,
+		NorthOpeningSalt,
+	};
+}
+
+FGridChunkStore::FGridChunkStore()
+	: ChunkSize(0)
+	, ChunkBytes(0)
+	, LastKey(0)
+	, LastChunk(nullptr)
+	, PageFile(nullptr)
+{
+}
+
+FGridChunkStore::~FGridChunkStore()
+{
+	Close();
+}
+
+bool FGridChunkStore::Init(const FGridChunkStoreSettings& InSettings)
+{
+	Close();
+	Settings = InSettings;
+	ChunkSize = Settings.ChunkSize < 4 ? 4 : Settings.ChunkSize + (Settings.ChunkSize & 1);
+	ChunkBytes = (ChunkSize * ChunkSize + 7) / 8;
+	Settings.ChunkSize = ChunkSize;
+	Settings.MaxResidentChunks = Settings.MaxResidentChunks < 1 ? 1 : Settings.MaxResidentChunks;
+	Scratch.Init(ChunkSize + 1, ChunkSize + 1);
+	Stats = FGridChunkStoreStats();
+
+	if (!Settings.PageFilePath.empty())
+	{
+		PageFile = std::fopen(Settings.PageFilePath.c_str(), "w+b");
+	}
+	return Settings.PageFilePath.empty() || (PageFile != nullptr);
+}
+
+void FGridChunkStore::Close()
+{
+	Resident.clear();
+	ResidentChunks.clear();
+	PageOffsets.clear();
+	LastChunk = nullptr;
+	if (PageFile != nullptr)
+	{
+		std::fclose(PageFile);
+		PageFile = nullptr;
+	}
+}
+
+void FGridChunkStore::SetWall(int32 X, int32 Y, bool bWall)
+{
+	FChunk& Chunk = GetChunk(FloorDiv(X), FloorDiv(Y));
+	const int32 Bit = (Y - Chunk.Y * ChunkSize) * ChunkSize + (X - Chunk.X * ChunkSize);
+	const uint8 Mask = (uint8)(1 << (Bit & 7));
+	const uint8 Old = Chunk.Walls[Bit >> 3];
+	Chunk.Walls[Bit >> 3] = bWall ? (Old | Mask) : (Old & ~Mask);
+	Chunk.bDirty |= Chunk.Walls[Bit >> 3] != Old;
+}
+
+void FGridChunkStore::Flush()
+{
+	for (FChunk& Chunk : Resident)
+	{
+		if (Chunk.bDirty && (PageFile != nullptr))
+		{
+			Write(Chunk);
+			Chunk.bDirty = false;
+		}
+	}
+	if (PageFile != nullptr)
+	{
+		std::fflush(PageFile);
+	}
+}
+
+void FGridChunkStore::CopyWindow(int32 MinX, int32 MinY, FGridGraph& OutGraph)
+{
+	for (int32 Y = 0; Y < OutGraph.GetHeight(); Y++)
+	{
+		for (int32 X = 0; X < OutGraph.GetWidth(); X++)
+		{
+			OutGraph.SetWall(OutGraph.GetIndex(X, Y), !IsWalkable(MinX + X, MinY + Y));
+		}
+	}
+}
+
+FGridChunkStore::FChunk& FGridChunkStore::PageIn(int32 ChunkX, int32 ChunkY, uint64 Key)
+{
+	auto Found = ResidentChunks.find(Key);
+	if (Found != ResidentChunks.end())
+	{
+		Resident.splice(Resident.begin(), Resident, Found->second);
+	}
+	else
+	{
+		//Make room first so the new chunk can't be the one evicted
+		while ((int32)Resident.size() >= Settings.MaxResidentChunks)
+		{
+			EvictOldest();
+		}
+
+		Resident.push_front(FChunk{ ChunkX, ChunkY, std::vector<uint8>(ChunkBytes, 0), false });
+		FChunk& Chunk = Resident.front();
+		ResidentChunks[Key] = Resident.begin();
+
+		auto Paged = PageOffsets.find(Key);
+		if ((Paged != PageOffsets.end()) && GridChunkStore::Seek(PageFile, Paged->second) && (std::fread(Chunk.Walls.data(), 1, ChunkBytes, PageFile) == (size_t)ChunkBytes))
+		{
+			Stats.ChunksLoaded++;
+		}
+		else
+		{
+			Generate(Chunk);
+		}
+
+		Stats.ResidentChunks = (int32)Resident.size();
+		if (Stats.ResidentChunks > Stats.PeakResidentChunks)
+		{
+			Stats.PeakResidentChunks = Stats.ResidentChunks;
+			Stats.PeakResidentBytes = (int64)Stats.PeakResidentChunks * ChunkBytes;
+		}
+	}
+
+	LastKey = Key;
+	LastChunk = &Resident.front();
+	return *LastChunk;
+}
+
+void FGridChunkStore::Generate(FChunk& Chunk)
+{
+	//The scratch maze is one cell bigger than a chunk: its last row and column are the neighbors' first, all wall
+	Generator.Generate(Scratch, (uint32)GridChunkStore::Hash(Settings.Seed, Chunk.X, Chunk.Y, GridChunkStore::ChunkSeedSalt), Settings.Algorithm, Settings.BraidFraction);
+
+	const int32 ScratchWidth = ChunkSize + 1;
+	for (int32 Y = 0; Y < ChunkSize; Y++)
+	{
+		for (int32 X = 0; X < ChunkSize; X++)
+		{
+			if (Scratch.IsWall(Y * ScratchWidth + X))
+			{
+				const int32 Bit = Y * ChunkSize + X;
+				Chunk.Walls[Bit >> 3] |= (uint8)(1 << (Bit & 7));
+			}
+		}
+	}
+
+	//Every chunk owns its west and north edge and opens one room on each, the east and south ones belong to the neighbors
+	const int32 RoomsPerEdge = ChunkSize / 2;
+	const int32 WestY = 2 * (int32)(GridChunkStore::Hash(Settings.Seed, Chunk.X, Chunk.Y, GridChunkStore::WestOpeningSalt) % RoomsPerEdge) + 1;
+	const int32 NorthX = 2 * (int32)(GridChunkStore::Hash(Settings.Seed, Chunk.X, Chunk.Y, GridChunkStore::NorthOpeningSalt) % RoomsPerEdge) + 1;
+	const int32 WestBit = WestY * ChunkSize;
+	const int32 NorthBit = NorthX;
+	Chunk.Walls[WestBit >> 3] &= (uint8)~(1 << (WestBit & 7));
+	Chunk.Walls[NorthBit >> 3] &= (uint8)~(1 << (NorthBit & 7));
+	Stats.ChunksGenerated++;
+}
+
+void FGridChunkStore::Write(const FChunk& Chunk)
+{
+	const uint64 Key = GetKey(Chunk.X, Chunk.Y);
+	auto Paged = PageOffsets.find(Key);
+	const int64 Offset = Paged != PageOffsets.end() ? Paged->second : Stats.PageFileBytes;
+	if (GridChunkStore::Seek(PageFile, Offset) && (std::fwrite(Chunk.Walls.data(), 1, ChunkBytes, PageFile) == (size_t)ChunkBytes))
+	{
+		if (Paged == PageOffsets.end())
+		{
+			PageOffsets[Key] = Offset;
+			Stats.PageFileBytes += ChunkBytes;
+		}
+		Stats.ChunksWritten++;
+	}
+}
+
+void FGridChunkStore::EvictOldest()
+{
+	const FChunk& Chunk = Resident.back();
+	if (Chunk.bDirty && (PageFile != nullptr))
+	{
+		Write(Chunk);
+	}
+
+	const uint64 Key = GetKey(Chunk.X, Chunk.Y);
+	if (LastKey == Key)
+	{
+		LastChunk = nullptr;
+	}
+	ResidentChunks.erase(Key);
+	Resident.pop_back();
+	Stats.ChunksEvicted++;
+	Stats.ResidentChunks = (int32)Resident.size();
+}
+
+int64 FGridChunkStore::GetAllocatedBytes() const
+{
+	int64 Bytes = GridMemory::GetAllocatedBytes(Resident) + GridMemory::GetAllocatedBytes(ResidentChunks) + GridMemory::GetAllocatedBytes(PageOffsets);
+	for (const FChunk& Chunk : Resident)
+	{
+		Bytes += GridMemory::GetAllocatedBytes(Chunk.Walls);
+	}
+	return Bytes + Scratch.Num() + Generator.GetAllocatedBytes();
+}
@@ -0,0 +1,148 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "GridTypes.h"
+#include "GridGraph.h"
+#include "GridMaze.h"
+#include <cstdio>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/** How an FGridChunkStore lays out and generates its maze */
+struct FGridChunkStoreSettings
+{
+	uint32 Seed = 0;
+
+	/** Generator each chunk is carved with */
+	EGridMazeAlgorithm Algorithm = EGridMazeAlgorithm::Eller;
+	float BraidFraction = 0.f;
+
+	/** Side of a chunk in cells, rounded up to an even number so rooms stay on odd coordinates across chunks */
+	int32 ChunkSize = 64;
+
+	/** Chunks kept in memory, the least recently used one is evicted beyond that */
+	int32 MaxResidentChunks = 1024;
+
+	/** Where evicted edits are paged to. Empty keeps everything in memory and evicted edits are lost */
+	std::string PageFilePath;
+};
+
+/** Counters of an FGridChunkStore since Init */
+struct FGridChunkStoreStats
+{
+	int64 ChunksGenerated = 0;
+	int64 ChunksLoaded = 0;
+	int64 ChunksWritten = 0;
+	int64 ChunksEvicted = 0;
+	int32 ResidentChunks = 0;
+	int32 PeakResidentChunks = 0;
+
+	/** Wall bits held in memory at the peak, the bound set by MaxResidentChunks */
+	int64 PeakResidentBytes = 0;
+
+	/** Size of the page file */
+	int64 PageFileBytes = 0;
+};
+
+/**
+ * Maze of unbounded size, stored as square chunks that are generated on first touch and dropped when cold.
+ * Each chunk is carved on its own with FGridMazeGenerator from a seed hashed out of the store seed and its
+ * coordinates, so a chunk always comes back the same and no other chunk is needed to build it. Neighboring chunks
+ * share one opening per edge, also hashed, which joins the chunk mazes into one connected maze with a loop around
+ * every four chunks.
+ * Resident chunks are one bit per cell. Evicting a chunk that was edited writes those bits to the page file and
+ * later touches read them back; untouched chunks are just regenerated. Memory therefore stays at MaxResidentChunks
+ * chunks however far searches wander, plus an offset for each edited chunk.
+ */
+class FGridChunkStore
+{
+public:
+	FGridChunkStore();
+	~FGridChunkStore();
+
+	FGridChunkStore(const FGridChunkStore&) = delete;
+	FGridChunkStore& operator=(const FGridChunkStore&) = delete;
+
+	/** Drop everything and start a new maze. Returns false if the page file could not be created, the store then keeps edits in memory only */
+	bool Init(const FGridChunkStoreSettings& InSettings);
+
+	const FGridChunkStoreSettings& GetSettings() const { return Settings; }
+	int32 GetChunkSize() const { return ChunkSize; }
+
+	/** Can cell (X, Y) be entered. Pages its chunk in if needed */
+	bool IsWalkable(int32 X, int32 Y)
+	{
+		const FChunk& Chunk = GetChunk(FloorDiv(X), FloorDiv(Y));
+		const int32 Bit = (Y - Chunk.Y * ChunkSize) * ChunkSize + (X - Chunk.X * ChunkSize);
+		return (Chunk.Walls[Bit >> 3] & (1 << (Bit & 7))) == 0;
+	}
+
+	void SetWall(int32 X, int32 Y, bool bWall);
+
+	/** Write every edited resident chunk to the page file */
+	void Flush();
+
+	/** Fill OutGraph, at its current size, with the cells from (MinX, MinY) on. Walls only, start and goal are left alone */
+	void CopyWindow(int32 MinX, int32 MinY, FGridGraph& OutGraph);
+
+	const FGridChunkStoreStats& GetStats() const { return Stats; }
+
+	/** Heap bytes held by the resident chunks, the page index and the generation scratch */
+	int64 GetAllocatedBytes() const;
+
+private:
+	struct FChunk
+	{
+		int32 X;
+		int32 Y;
+
+		/** One bit per cell, set for walls, row-major */
+		std::vector<uint8> Walls;
+
+		/** Differs from the copy on disk or from what generation gives */
+		bool bDirty;
+	};
+
+	static uint64 GetKey(int32 ChunkX, int32 ChunkY) { return ((uint64)(uint32)ChunkX << 32) | (uint32)ChunkY; }
+
+	/** Chunk coordinate of a cell coordinate, rounding towards negative infinity */
+	int32 FloorDiv(int32 Value) const { return (Value >= 0 ? Value : Value - ChunkSize + 1) / ChunkSize; }
+
+	FChunk& GetChunk(int32 ChunkX, int32 ChunkY)
+	{
+		const uint64 Key = GetKey(ChunkX, ChunkY);
+		return (LastChunk != nullptr) && (LastKey == Key) ? *LastChunk : PageIn(ChunkX, ChunkY, Key);
+	}
+
+	FChunk& PageIn(int32 ChunkX, int32 ChunkY, uint64 Key);
+	void Generate(FChunk& Chunk);
+	void Write(const FChunk& Chunk);
+	void EvictOldest();
+	void Close();
+
+	FGridChunkStoreSettings Settings;
+	int32 ChunkSize;
+	int32 ChunkBytes;
+
+	/** Resident chunks, most recently used first */
+	std::list<FChunk> Resident;
+	std::unordered_map<uint64, std::list<FChunk>::iterator> ResidentChunks;
+
+	/** Chunk the last lookup went to, most lookups land in the same one */
+	uint64 LastKey;
+	FChunk* LastChunk;
+
+	/** Where each paged out chunk sits in the page file */
+	std::unordered_map<uint64, int64> PageOffsets;
+	std::FILE* PageFile;
+
+	FGridMazeGenerator Generator;
+
+	/** One chunk plus the row and column its right and bottom neighbors start with */
+	FGridGraph Scratch;
+
+	FGridChunkStoreStats Stats;
+};
@@ -0,0 +1,129 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "GridChunkedSearch.h"
+#include "GridMemory.h"
+#include "GridChunkStore.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace GridChunkedSearch
+{
+	uint64 GetKey(int32 X, int32 Y) { return ((uint64)(uint32)X << 32) | (uint32)Y; }
+	int32 GetX(uint64 Key) { return (int32)(uint32)(Key >> 32); }
+	int32 GetY(uint64 Key) { return (int32)(uint32)Key; }
+
+	bool IsBefore(int32 PriorityA, int32 DistanceA, int32 PriorityB, int32 DistanceB)
+	{
+		return (PriorityA < PriorityB) || ((PriorityA == PriorityB) && (DistanceA > DistanceB));
+	}
+}
+
+void FGridChunkedSearch::Run(FGridChunkStore& Store, int32 StartX, int32 StartY, int32 GoalX, int32 GoalY, FGridChunkedSearchResult& OutResult, int32 MaxExpanded)
+{
+	using namespace GridChunkedSearch;
+
+	OutResult = FGridChunkedSearchResult();
+	Nodes.clear();
+	Open.clear();
+	if (!Store.IsWalkable(StartX, StartY) || !Store.IsWalkable(GoalX, GoalY))
+	{
+		return;
+	}
+
+	auto GetHeuristic = [GoalX, GoalY](int32 X, int32 Y)
+	{
+		return std::abs(X - GoalX) + std::abs(Y - GoalY);
+	};
+
+	const uint64 StartKey = GetKey(StartX, StartY);
+	const uint64 GoalKey = GetKey(GoalX, GoalY);
+	Nodes[StartKey] = FNode{ 0, StartKey, false };
+	PushOpen(FOpenEntry{ GetHeuristic(StartX, StartY), 0, StartKey });
+
+	static const int32 Offsets[4][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+	while (!Open.empty())
+	{
+		const FOpenEntry Entry = PopOpen();
+		FNode& Node = Nodes[Entry.Key];
+		//Stale entry, the cell was reached cheaper after this was pushed
+		if (Node.bClosed || (Entry.Distance != Node.Distance))
+		{
+			continue;
+		}
+		Node.bClosed = true;
+		OutResult.NodesExpanded++;
+
+		if (Entry.Key == GoalKey)
+		{
+			OutResult.bFound = true;
+			OutResult.Cost = Entry.Distance;
+			for (uint64 Key = GoalKey; ; Key = Nodes[Key].Parent)
+			{
+				OutResult.Path.emplace_back(GetX(Key), GetY(Key));
+				if (Key == StartKey)
+				{
+					break;
+				}
+			}
+			std::reverse(OutResult.Path.begin(), OutResult.Path.end());
+			return;
+		}
+		if (OutResult.NodesExpanded >= MaxExpanded)
+		{
+			OutResult.bExhausted = true;
+			return;
+		}
+
+		const int32 X = GetX(Entry.Key);
+		const int32 Y = GetY(Entry.Key);
+		const int32 NextDistance = Entry.Distance + 1;
+		for (const auto& Offset : Offsets)
+		{
+			const int32 NextX = X + Offset[0];
+			const int32 NextY = Y + Offset[1];
+			if (!Store.IsWalkable(NextX, NextY))
+			{
+				continue;
+			}
+
+			const uint64 NextKey = GetKey(NextX, NextY);
+			auto Inserted = Nodes.insert(std::make_pair(NextKey, FNode{ NextDistance, Entry.Key, false }));
+			FNode& Next = Inserted.first->second;
+			if (!Inserted.second)
+			{
+				if (Next.bClosed || (Next.Distance <= NextDistance))
+				{
+					continue;
+				}
+				Next.Distance = NextDistance;
+				Next.Parent = Entry.Key;
+			}
+			PushOpen(FOpenEntry{ NextDistance + GetHeuristic(NextX, NextY), NextDistance, NextKey });
+		}
+	}
+}
+
+void FGridChunkedSearch::PushOpen(const FOpenEntry& Entry)
+{
+	Open.push_back(Entry);
+	std::push_heap(Open.begin(), Open.end(), [](const FOpenEntry& A, const FOpenEntry& B)
+	{
+		return GridChunkedSearch::IsBefore(B.Priority, B.Distance, A.Priority, A.Distance);
+	});
+}
+
+FGridChunkedSearch::FOpenEntry FGridChunkedSearch::PopOpen()
+{
+	std::pop_heap(Open.begin(), Open.end(), [](const FOpenEntry& A, const FOpenEntry& B)
+	{
+		return GridChunkedSearch::IsBefore(B.Priority, B.Distance, A.Priority, A.Distance);
+	});
+	const FOpenEntry Entry = Open.back();
+	Open.pop_back();
+	return Entry;
+}
+
+int64 FGridChunkedSearch::GetAllocatedBytes() const
+{
+	return GridMemory::GetAllocatedBytes(Nodes) + GridMemory::GetAllocatedBytes(Open);
+}
@@ -0,0 +1,68 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "GridTypes.h"
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class FGridChunkStore;
+
+/** Output of an FGridChunkedSearch */
+struct FGridChunkedSearchResult
+{
+	bool bFound = false;
+
+	/** Steps from start to goal, GridUnreachable if there is no path or the search gave up */
+	int32 Cost = GridUnreachable;
+
+	int32 NodesExpanded = 0;
+
+	/** Stopped at MaxExpanded before reaching the goal */
+	bool bExhausted = false;
+
+	/** Cells from start to goal as (X, Y) */
+	std::vector<std::pair<int32, int32>> Path;
+};
+
+/**
+ * A* over an FGridChunkStore. Cells are addressed by coordinates and looked up through the store, so chunks page
+ * in as the frontier reaches them and the board can be any size. Search state is hashed per reached cell instead of
+ * indexed by cell, it grows with the search rather than the maze, and MaxExpanded caps it.
+ */
+class FGridChunkedSearch
+{
+public:
+	enum : int32
+	{
+		DefaultMaxExpanded = 1 << 22
+	};
+
+	void Run(FGridChunkStore& Store, int32 StartX, int32 StartY, int32 GoalX, int32 GoalY, FGridChunkedSearchResult& OutResult, int32 MaxExpanded = DefaultMaxExpanded);
+
+	/** Heap bytes held by the node map and open list kept from the last run */
+	int64 GetAllocatedBytes() const;
+
+private:
+	struct FNode
+	{
+		int32 Distance;
+		uint64 Parent;
+		bool bClosed;
+	};
+
+	struct FOpenEntry
+	{
+		int32 Priority;
+		int32 Distance;
+		uint64 Key;
+	};
+
+	/** Binary min-heap on Priority, larger Distance first on ties */
+	void PushOpen(const FOpenEntry& Entry);
+	FOpenEntry PopOpen();
+
+	std::unordered_map<uint64, FNode> Nodes;
+	std::vector<FOpenEntry> Open;
+};
@@ -0,0 +1,374 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "GridCrowd.h"
+#include "GridMemory.h"
+#include "GridGraph.h"
+#include "FlowField.h"
+#include <algorithm>
+#include <chrono>
+
+void FGridCrowd::Reset(const FGridGraph& Graph)
+{
+	Width = Graph.GetWidth();
+	Cells.clear();
+	NextCells.clear();
+	Goals.clear();
+	Desired.clear();
+	Progress.clear();
+	Speeds.clear();
+	WaitTimes.clear();
+	PositionsX.clear();
+	PositionsY.clear();
+	States.clear();
+	Modes.clear();
+	PathOffsets.clear();
+	PathLengths.clear();
+	PathSteps.clear();
+	PathPool.clear();
+	PathPoolGarbage = 0;
+
+	const int32 NumCells = Graph.Num();
+	NumBoardCells = NumCells;
+	Occupants.reset(new std::atomic<int32>[NumCells]);
+	Claims.reset(new std::atomic<int32>[NumCells]);
+	for (int32 Cell = 0; Cell < NumCells; Cell++)
+	{
+		Occupants[Cell].store(GridInvalidIndex, std::memory_order_relaxed);
+		Claims[Cell].store(GridUnreachable, std::memory_order_relaxed);
+	}
+}
+
+int32 FGridCrowd::AddAgent(const FGridGraph& Graph, int32 Cell, EGridAgentMode Mode, float Speed, int32 Goal)
+{
+	if (!Occupants || !Graph.IsValidIndex(Cell) || Graph.IsWall(Cell) || (GetOccupant(Cell) != GridInvalidIndex))
+	{
+		return GridInvalidIndex;
+	}
+	if ((Goal != GridInvalidIndex) && (!Graph.IsValidIndex(Goal) || Graph.IsWall(Goal)))
+	{
+		return GridInvalidIndex;
+	}
+
+	const int32 Agent = Num();
+	Cells.push_back(Cell);
+	NextCells.push_back(GridInvalidIndex);
+	Goals.push_back(Goal);
+	Desired.push_back(GridInvalidIndex);
+	Progress.push_back(0.f);
+	Speeds.push_back(std::max(Speed, 0.f));
+	WaitTimes.push_back(0.f);
+	PositionsX.push_back((float)(Cell % Width));
+	PositionsY.push_back((float)(Cell / Width));
+	//Path agents have nowhere to go until they get a path
+	States.push_back((uint8)(Mode == EGridAgentMode::Path ? EGridAgentState::NoRoute : EGridAgentState::Waiting));
+	Modes.push_back((uint8)Mode);
+	PathOffsets.push_back(0);
+	PathLengths.push_back(0);
+	PathSteps.push_back(0);
+	Occupants[Cell].store(Agent, std::memory_order_relaxed);
+	return Agent;
+}
+
+void FGridCrowd::SetPath(int32 Agent, const int32* PathCells, int32 NumCells)
+{
+	PathPoolGarbage += PathLengths[Agent];
+	PathLengths[Agent] = 0;
+	PathSteps[Agent] = 0;
+
+	const EGridAgentState State = GetState(Agent);
+	if (State == EGridAgentState::Arrived)
+	{
+		return;
+	}
+
+	const int32 From = (State == EGridAgentState::Moving) ? NextCells[Agent] : Cells[Agent];
+	if (NumCells <= 0 || PathCells[0] != From)
+	{
+		if (State != EGridAgentState::Moving)
+		{
+			States[Agent] = (uint8)EGridAgentState::NoRoute;
+		}
+		return;
+	}
+
+	if (PathPoolGarbage > (int32)PathPool.size() / 2)
+	{
+		std::vector<int32> Compacted;
+		Compacted.reserve(PathPool.size() - PathPoolGarbage + NumCells);
+		for (int32 Other = 0; Other < Num(); Other++)
+		{
+			const int32 Offset = (int32)Compacted.size();
+			Compacted.insert(Compacted.end(), PathPool.begin() + PathOffsets[Other], PathPool.begin() + PathOffsets[Other] + PathLengths[Other]);
+			PathOffsets[Other] = Offset;
+		}
+		PathPool.swap(Compacted);
+		PathPoolGarbage = 0;
+	}
+
+	PathOffsets[Agent] = (int32)PathPool.size();
+	PathLengths[Agent] = NumCells;
+	PathPool.insert(PathPool.end(), PathCells, PathCells + NumCells);
+	if (State != EGridAgentState::Moving)
+	{
+		States[Agent] = (uint8)EGridAgentState::Waiting;
+		WaitTimes[Agent] = 0.f;
+	}
+}
+
+FGridCrowdStats FGridCrowd::Update(const FGridGraph& Graph, const FGridFlowField* FlowField, float DeltaSeconds, const FParallelRunner& Runner)
+{
+	const auto StartTime = std::chrono::steady_clock::now();
+
+	if (FlowField != nullptr && !FlowField->IsBuilt())
+	{
+		FlowField = nullptr;
+	}
+
+	const int32 NumAgents = Num();
+	const int32 NumTasks = (NumAgents + AgentsPerTask - 1) / AgentsPerTask;
+	TaskStats.assign(NumTasks, FGridCrowdStats());
+
+	auto RunPass = [&](const std::function<void(int32 Agent)>& Pass)
+	{
+		const std::function<void(int32)> Body = [&](int32 TaskIndex)
+		{
+			const int32 End = std::min((TaskIndex + 1) * AgentsPerTask, NumAgents);
+			for (int32 Agent = TaskIndex * AgentsPerTask; Agent < End; Agent++)
+			{
+				Pass(Agent);
+			}
+		};
+
+		if (Runner)
+		{
+			Runner(NumTasks, Body);
+		}
+		else
+		{
+			for (int32 TaskIndex = 0; TaskIndex < NumTasks; TaskIndex++)
+			{
+				Body(TaskIndex);
+			}
+		}
+	};
+
+	//Each pass only writes cells its agents own, and the passes in between keep every claim decision off cells that change
+	RunPass([&](int32 Agent) { MoveAgent(Graph, FlowField, Agent, DeltaSeconds); });
+	RunPass([&](int32 Agent) { ClaimNextCell(Graph, FlowField, Agent, DeltaSeconds); });
+	RunPass([&](int32 Agent)
+	{
+		ResolveClaim(Agent);
+		UpdatePosition(Agent);
+
+		FGridCrowdStats& Stats = TaskStats[Agent / AgentsPerTask];
+		switch (GetState(Agent))
+		{
+		case EGridAgentState::Moving:
+			Stats.NumMoving++;
+			break;
+		case EGridAgentState::Waiting:
+			Stats.NumWaiting++;
+			break;
+		case EGridAgentState::Arrived:
+			Stats.NumArrived++;
+			break;
+		default:
+			Stats.NumNoRoute++;
+			break;
+		}
+	});
+
+	FGridCrowdStats Stats;
+	Stats.NumAgents = NumAgents;
+	Stats.NumTasks = NumTasks;
+	for (const FGridCrowdStats& Task : TaskStats)
+	{
+		Stats.NumMoving += Task.NumMoving;
+		Stats.NumWaiting += Task.NumWaiting;
+		Stats.NumArrived += Task.NumArrived;
+		Stats.NumNoRoute += Task.NumNoRoute;
+	}
+	Stats.Milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - StartTime).count();
+	return Stats;
+}
+
+void FGridCrowd::MoveAgent(const FGridGraph& Graph, const FGridFlowField* FlowField, int32 Agent, float DeltaSeconds)
+{
+	const EGridAgentState State = GetState(Agent);
+	if (State == EGridAgentState::Arrived)
+	{
+		return;
+	}
+
+	if (State == EGridAgentState::Moving)
+	{
+		const int32 Next = NextCells[Agent];
+		Progress[Agent] += DeltaSeconds * Speeds[Agent] / Graph.GetCost(Next);
+		if (Progress[Agent] < 1.f)
+		{
+			return;
+		}
+
+		Occupants[Cells[Agent]].store(GridInvalidIndex, std::memory_order_relaxed);
+		Cells[Agent] = Next;
+		NextCells[Agent] = GridInvalidIndex;
+		Progress[Agent] = 0.f;
+		WaitTimes[Agent] = 0.f;
+		States[Agent] = (uint8)EGridAgentState::Waiting;
+
+		//A path set while moving starts on the cell just entered, a sidestep leaves the path
+		const int32 Step = PathSteps[Agent];
+		if ((Step + 1 < PathLengths[Agent]) && (PathPool[PathOffsets[Agent] + Step + 1] == Next))
+		{
+			PathSteps[Agent] = Step + 1;
+		}
+		else if ((PathLengths[Agent] > 0) && (PathPool[PathOffsets[Agent] + Step] != Next))
+		{
+			PathPoolGarbage += PathLengths[Agent];
+			PathLengths[Agent] = 0;
+			PathSteps[Agent] = 0;
+			States[Agent] = (uint8)EGridAgentState::NoRoute;
+			return;
+		}
+	}
+
+	const int32 Cell = Cells[Agent];
+	const bool bAtGoal = (GetMode(Agent) == EGridAgentMode::Path) ? (PathSteps[Agent] == PathLengths[Agent] - 1)
+		: (FlowField != nullptr && FlowField->GetDirection(Cell) == EGridFlowDirection::Goal);
+	if (bAtGoal)
+	{
+		States[Agent] = (uint8)EGridAgentState::Arrived;
+		Occupants[Cell].store(GridInvalidIndex, std::memory_order_relaxed);
+	}
+}
+
+void FGridCrowd::ClaimNextCell(const FGridGraph& Graph, const FGridFlowField* FlowField, int32 Agent, float DeltaSeconds)
+{
+	Desired[Agent] = GridInvalidIndex;
+
+	const EGridAgentState State = GetState(Agent);
+	const bool bPathAgent = GetMode(Agent) == EGridAgentMode::Path;
+	if ((State == EGridAgentState::Moving) || (State == EGridAgentState::Arrived) || (bPathAgent && State == EGridAgentState::NoRoute))
+	{
+		return;
+	}
+
+	const int32 Next = ChooseNextCell(Graph, FlowField, Agent);
+	if (Next == GridInvalidIndex)
+	{
+		States[Agent] = (uint8)EGridAgentState::NoRoute;
+		return;
+	}
+
+	States[Agent] = (uint8)EGridAgentState::Waiting;
+	if (GetOccupant(Next) != GridInvalidIndex)
+	{
+		WaitTimes[Agent] += DeltaSeconds;
+		return;
+	}
+
+	Desired[Agent] = Next;
+	std::atomic<int32>& Claim = Claims[Next];
+	int32 Current = Claim.load(std::memory_order_relaxed);
+	while (Agent < Current && !Claim.compare_exchange_weak(Current, Agent, std::memory_order_relaxed))
+	{
+	}
+}
+
+void FGridCrowd::ResolveClaim(int32 Agent)
+{
+	const int32 Next = Desired[Agent];
+	if (Next == GridInvalidIndex)
+	{
+		return;
+	}
+
+	//Only the winner resets the claim, a loser reading the reset value still sees it lost
+	if (Claims[Next].load(std::memory_order_relaxed) != Agent)
+	{
+		return;
+	}
+	Claims[Next].store(GridUnreachable, std::memory_order_relaxed);
+	Occupants[Next].store(Agent, std::memory_order_relaxed);
+	NextCells[Agent] = Next;
+	States[Agent] = (uint8)EGridAgentState::Moving;
+}
+
+int32 FGridCrowd::ChooseNextCell(const FGridGraph& Graph, const FGridFlowField* FlowField, int32 Agent) const
+{
+	const int32 Cell = Cells[Agent];
+	const bool bPathAgent = GetMode(Agent) == EGridAgentMode::Path;
+	int32 Next = GridInvalidIndex;
+	if (bPathAgent)
+	{
+		Next = PathPool[PathOffsets[Agent] + PathSteps[Agent] + 1];
+		if (Graph.IsWall(Next))
+		{
+			return GridInvalidIndex;
+		}
+	}
+	else if (FlowField != nullptr)
+	{
+		Next = FlowField->GetNextCell(Cell);
+	}
+
+	if (Next == GridInvalidIndex || GetOccupant(Next) == GridInvalidIndex || WaitTimes[Agent] < SidestepDelay)
+	{
+		return Next;
+	}
+
+	//Blocked for a while, so any free neighbor closer to a goal will do, or any free neighbor at all off a path
+	int32 Neighbors[4];
+	const int32 NumNeighbors = Graph.GetNeighbors(Cell, Neighbors);
+	if (bPathAgent)
+	{
+		for (int32 i = 0; i < NumNeighbors; i++)
+		{
+			if (GetOccupant(Neighbors[i]) == GridInvalidIndex)
+			{
+				return Neighbors[i];
+			}
+		}
+		return Next;
+	}
+
+	int32 Best = Next;
+	int32 BestDistance = FlowField->GetDistance(Cell);
+	for (int32 i = 0; i < NumNeighbors; i++)
+	{
+		const int32 Neighbor = Neighbors[i];
+		const int32 Distance = FlowField->GetDistance(Neighbor);
+		if ((Distance < BestDistance) && (GetOccupant(Neighbor) == GridInvalidIndex))
+		{
+			Best = Neighbor;
+			BestDistance = Distance;
+		}
+	}
+	return Best;
+}
+
+void FGridCrowd::UpdatePosition(int32 Agent)
+{
+	const int32 Cell = Cells[Agent];
+	float X = (float)(Cell % Width);
+	float Y = (float)(Cell / Width);
+	if (GetState(Agent) == EGridAgentState::Moving)
+	{
+		const int32 Next = NextCells[Agent];
+		const float Alpha = Progress[Agent];
+		X += ((Next % Width) - X) * Alpha;
+		Y += ((Next / Width) - Y) * Alpha;
+	}
+	PositionsX[Agent] = X;
+	PositionsY[Agent] = Y;
+}
+
+int64 FGridCrowd::GetAllocatedBytes() const
+{
+	return GridMemory::GetAllocatedBytes(Cells) + GridMemory::GetAllocatedBytes(NextCells) + GridMemory::GetAllocatedBytes(Goals)
+		+ GridMemory::GetAllocatedBytes(Desired) + GridMemory::GetAllocatedBytes(Progress) + GridMemory::GetAllocatedBytes(Speeds)
+		+ GridMemory::GetAllocatedBytes(WaitTimes) + GridMemory::GetAllocatedBytes(PositionsX) + GridMemory::GetAllocatedBytes(PositionsY)
+		+ GridMemory::GetAllocatedBytes(States) + GridMemory::GetAllocatedBytes(Modes) + GridMemory::GetAllocatedBytes(PathOffsets)
+		+ GridMemory::GetAllocatedBytes(PathLengths) + GridMemory::GetAllocatedBytes(PathSteps) + GridMemory::GetAllocatedBytes(PathPool)
+		+ GridMemory::GetAllocatedBytes(TaskStats) + 2 * (int64)NumBoardCells * (int64)sizeof(std::atomic<int32>);
+}
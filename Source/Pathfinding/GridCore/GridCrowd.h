@@ -0,0 +1,166 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "GridTypes.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+class FGridGraph;
+class FGridFlowField;
+
+/** What an agent is doing */
+enum class EGridAgentState : uint8
+{
+	/** Standing on a cell center, steps on as soon as the next cell is free */
+	Waiting,
+	/** On its way from its cell to its next cell, holding both */
+	Moving,
+	/** Reached its goal and left the board, its cell is free again */
+	Arrived,
+	/** Its flow field or path leads nowhere from here, or it left its path. Path agents wait for SetPath, flow agents retry every update */
+	NoRoute
+};
+
+/** Where an agent takes its steps from */
+enum class EGridAgentMode : uint8
+{
+	/** Towards the nearest goal of the flow field passed to Update */
+	FlowField,
+	/** Along the cells given to SetPath, towards the goal given to AddAgent */
+	Path
+};
+
+/** Totals of one FGridCrowd::Update call */
+struct FGridCrowdStats
+{
+	int32 NumAgents = 0;
+	int32 NumMoving = 0;
+	int32 NumWaiting = 0;
+	int32 NumArrived = 0;
+	int32 NumNoRoute = 0;
+	int32 NumTasks = 0;
+	double Milliseconds = 0.0;
+};
+
+/**
+ * Thousands of lightweight agents walking a grid, stored as one array per field instead of one object per agent so an
+ * update streams through memory. Agents step cell to cell following a flow field or their own path, at Speed cells per
+ * second slowed down by the cost of the cell they step onto.
+ * A cell holds at most one agent, a moving agent holds the cell it leaves and the one it enters. When several agents
+ * want the same free cell the lowest agent index gets it, so updates give the same result however they are split
+ * across threads. Agents kept waiting sidestep: flow field agents to a free neighbor closer to a goal, path agents to
+ * any free neighbor, after which they need a new path. That breaks up head-on jams between agents going opposite ways.
+ */
+class FGridCrowd
+{
+public:
+	/**
+	 * Runs Body(TaskIndex) for TaskIndex 0..NumTasks-1, possibly in parallel, and returns when all are done.
+	 * The game module passes ParallelFor here, the default runs the tasks on the calling thread
+	 */
+	typedef std::function<void(int32 NumTasks, const std::function<void(int32 TaskIndex)>& Body)> FParallelRunner;
+
+	enum : int32
+	{
+		/** Agents one task of Update works through */
+		AgentsPerTask = 2048
+	};
+
+	/** Drop every agent and size the occupancy for Graph */
+	void Reset(const FGridGraph& Graph);
+
+	/**
+	 * Add an agent on a free walkable cell, Goal is only kept for the owner of Path agents to plan with.
+	 * Returns its index, GridInvalidIndex if the cell can't take it or Goal is a wall
+	 */
+	int32 AddAgent(const FGridGraph& Graph, int32 Cell, EGridAgentMode Mode, float Speed, int32 Goal = GridInvalidIndex);
+
+	/**
+	 * Give a Path agent the cells to walk, starting with the one it stands on, or the one it is entering while it moves.
+	 * A path that starts anywhere else leaves the agent with no route
+	 */
+	void SetPath(int32 Agent, const int32* Cells, int32 NumCells);
+
+	/** Move every agent on by DeltaSeconds. FlowField may be null if no agent uses one */
+	FGridCrowdStats Update(const FGridGraph& Graph, const FGridFlowField* FlowField, float DeltaSeconds, const FParallelRunner& Runner = FParallelRunner());
+
+	int32 Num() const { return (int32)Cells.size(); }
+
+	EGridAgentState GetState(int32 Agent) const { return static_cast<EGridAgentState>(States[Agent]); }
+	EGridAgentMode GetMode(int32 Agent) const { return static_cast<EGridAgentMode>(Modes[Agent]); }
+
+	/** Cell the agent stands on or is leaving */
+	int32 GetCell(int32 Agent) const { return Cells[Agent]; }
+
+	/** Cell the agent is entering, GridInvalidIndex unless it is Moving */
+	int32 GetNextCell(int32 Agent) const { return NextCells[Agent]; }
+
+	/** Goal given to AddAgent */
+	int32 GetGoal(int32 Agent) const { return Goals[Agent]; }
+
+	/** Position in cells, the cell's GetX/GetY on a cell center and in between while moving */
+	float GetX(int32 Agent) const { return PositionsX[Agent]; }
+	float GetY(int32 Agent) const { return PositionsY[Agent]; }
+
+	/** Agent standing on or entering Cell, GridInvalidIndex if it is free */
+	int32 GetOccupant(int32 Cell) const { return Occupants[Cell].load(std::memory_order_relaxed); }
+
+	/** Seconds an agent waits for a cell before it sidesteps */
+	void SetSidestepDelay(float Seconds) { SidestepDelay = Seconds; }
+
+	/** Heap bytes held by the agents, their paths and the occupancy of the board */
+	int64 GetAllocatedBytes() const;
+
+private:
+	/** Walk a moving agent on, free the cells it leaves and the goal it reaches. First pass of Update */
+	void MoveAgent(const FGridGraph& Graph, const FGridFlowField* FlowField, int32 Agent, float DeltaSeconds);
+
+	/** Pick a waiting agent's next cell and claim it if it is free. Second pass of Update, occupancy doesn't change */
+	void ClaimNextCell(const FGridGraph& Graph, const FGridFlowField* FlowField, int32 Agent, float DeltaSeconds);
+
+	/** Start moving if the agent won its claim. Third pass of Update */
+	void ResolveClaim(int32 Agent);
+
+	/** Cell a waiting agent wants to step to next, GridInvalidIndex if there is none */
+	int32 ChooseNextCell(const FGridGraph& Graph, const FGridFlowField* FlowField, int32 Agent) const;
+
+	void UpdatePosition(int32 Agent);
+
+	int32 Width = 0;
+
+	/** Cells of the board Occupants and Claims cover */
+	int32 NumBoardCells = 0;
+
+	std::vector<int32> Cells;
+	std::vector<int32> NextCells;
+	std::vector<int32> Goals;
+	/** Cell each agent wants this update, GridInvalidIndex if none */
+	std::vector<int32> Desired;
+	std::vector<float> Progress;
+	std::vector<float> Speeds;
+	std::vector<float> WaitTimes;
+	std::vector<float> PositionsX;
+	std::vector<float> PositionsY;
+	std::vector<uint8> States;
+	std::vector<uint8> Modes;
+
+	/** Where each path agent's cells start in PathPool, how many there are and which one it stands on */
+	std::vector<int32> PathOffsets;
+	std::vector<int32> PathLengths;
+	std::vector<int32> PathSteps;
+	std::vector<int32> PathPool;
+	/** Cells of PathPool no agent uses anymore, compacted away once they are the majority */
+	int32 PathPoolGarbage = 0;
+
+	/** Agent holding each cell, GridInvalidIndex if free */
+	std::unique_ptr<std::atomic<int32>[]> Occupants;
+
+	/** Lowest agent index claiming each cell this update, GridUnreachable if none */
+	std::unique_ptr<std::atomic<int32>[]> Claims;
+
+	std::vector<FGridCrowdStats> TaskStats;
+	float SidestepDelay = 0.5f;
+};
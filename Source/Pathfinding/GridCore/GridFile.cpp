@@ -0,0 +1,156 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "GridFile.h"
+#include "GridGraph.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace GridFile
+{
+	/** Length of an open file, -1 if it can't be told. Takes the whole 64 bit size on every platform */
+	int64 GetLength(std::FILE* File)
+	{
+#if defined(_WIN32)
+		return _fseeki64(File, 0, SEEK_END) == 0 ? _ftelli64(File) : -1;
+#else
+		return fseeko(File, 0, SEEK_END) == 0 ? (int64)ftello(File) : -1;
+#endif
+	}
+
+	int64 GetWallBytes(int32 Width, int32 Height)
+	{
+		return ((int64)Width * Height + 7) / 8;
+	}
+}
+
+const char* GetGridFileResultName(EGridFileResult Result)
+{
+	switch (Result)
+	{
+	case EGridFileResult::Success:
+		return "Success";
+	case EGridFileResult::CantOpen:
+		return "CantOpen";
+	case EGridFileResult::CantWrite:
+		return "CantWrite";
+	case EGridFileResult::BadMagic:
+		return "BadMagic";
+	case EGridFileResult::NewerVersion:
+		return "NewerVersion";
+	case EGridFileResult::BadHeader:
+		return "BadHeader";
+	case EGridFileResult::Truncated:
+		return "Truncated";
+	default:
+		break;
+	}
+	return "Unknown";
+}
+
+int64 FGridFile::GetFileSize(int32 Width, int32 Height, bool bWithCosts)
+{
+	return (int64)sizeof(FGridFileHeader) + GridFile::GetWallBytes(Width, Height) + (bWithCosts ? (int64)Width * Height : 0);
+}
+
+EGridFileResult FGridFile::Write(const char* Path, const FGridGraph& Graph)
+{
+	const int32 NumCells = Graph.Num();
+	const bool bWithCosts = (Graph.GetMinCost() != 1) || (Graph.GetMaxCost() != 1);
+
+	FGridFileHeader Header;
+	std::memset(&Header, 0, sizeof(Header));
+	Header.Magic = Magic;
+	Header.Version = Version;
+	Header.Flags = bWithCosts ? HasCosts : 0;
+	Header.HeaderSize = sizeof(FGridFileHeader);
+	Header.Width = Graph.GetWidth();
+	Header.Height = Graph.GetHeight();
+	Header.Start = Graph.GetStart();
+	Header.Goal = Graph.GetGoal();
+
+	//The last wall byte is padded with open cells
+	std::vector<uint8> Walls((size_t)GridFile::GetWallBytes(Header.Width, Header.Height));
+	std::vector<uint8> Costs(bWithCosts ? NumCells : 0);
+	Graph.CopyCells(Walls.data(), bWithCosts ? Costs.data() : nullptr);
+
+	std::FILE* File = std::fopen(Path, "wb");
+	if (File == nullptr)
+	{
+		return EGridFileResult::CantOpen;
+	}
+
+	bool bWritten = std::fwrite(&Header, sizeof(Header), 1, File) == 1;
+	//An empty vector's data() may be null, which fwrite mustn't be given even for no bytes
+	bWritten = bWritten && (Walls.empty() || (std::fwrite(Walls.data(), 1, Walls.size(), File) == Walls.size()));
+	bWritten = bWritten && (Costs.empty() || (std::fwrite(Costs.data(), 1, Costs.size(), File) == Costs.size()));
+	bWritten = (std::fclose(File) == 0) && bWritten;
+	return bWritten ? EGridFileResult::Success : EGridFileResult::CantWrite;
+}
+
+EGridFileResult FGridFile::ReadHeader(const uint8* Data, int64 Size, FGridFileHeader& OutHeader)
+{
+	if ((Data == nullptr) || (Size < (int64)sizeof(FGridFileHeader)))
+	{
+		return EGridFileResult::Truncated;
+	}
+
+	//Mapped files are page aligned but in-memory copies need not be, so the header is copied out
+	std::memcpy(&OutHeader, Data, sizeof(OutHeader));
+	if (OutHeader.Magic != Magic)
+	{
+		return EGridFileResult::BadMagic;
+	}
+	if (OutHeader.Version > Version)
+	{
+		return EGridFileResult::NewerVersion;
+	}
+	if ((OutHeader.HeaderSize < sizeof(FGridFileHeader)) || (OutHeader.Width < 0) || (OutHeader.Height < 0)
+		|| ((int64)OutHeader.Width * OutHeader.Height > 0x7fffffff))
+	{
+		return EGridFileResult::BadHeader;
+	}
+
+	const int64 BoardBytes = FGridFile::GetFileSize(OutHeader.Width, OutHeader.Height, (OutHeader.Flags & HasCosts) != 0) - (int64)sizeof(FGridFileHeader);
+	return Size - (int64)OutHeader.HeaderSize >= BoardBytes ? EGridFileResult::Success : EGridFileResult::Truncated;
+}
+
+EGridFileResult FGridFile::Read(const uint8* Data, int64 Size, FGridGraph& OutGraph)
+{
+	FGridFileHeader Header;
+	const EGridFileResult Result = ReadHeader(Data, Size, Header);
+	if (Result != EGridFileResult::Success)
+	{
+		return Result;
+	}
+
+	const uint8* Walls = Data + Header.HeaderSize;
+	const uint8* Costs = (Header.Flags & HasCosts) != 0 ? Walls + GridFile::GetWallBytes(Header.Width, Header.Height) : nullptr;
+	OutGraph.AssignCells(Header.Width, Header.Height, Walls, Costs);
+
+	//A hand-edited file may put the start or goal out of range or on a wall, those are dropped
+	if (OutGraph.IsValidIndex(Header.Start) && OutGraph.IsWalkable(Header.Start))
+	{
+		OutGraph.SetStart(Header.Start);
+	}
+	if (OutGraph.IsValidIndex(Header.Goal) && OutGraph.IsWalkable(Header.Goal) && (Header.Goal != OutGraph.GetStart()))
+	{
+		OutGraph.SetGoal(Header.Goal);
+	}
+	return EGridFileResult::Success;
+}
+
+EGridFileResult FGridFile::Load(const char* Path, FGridGraph& OutGraph)
+{
+	std::FILE* File = std::fopen(Path, "rb");
+	if (File == nullptr)
+	{
+		return EGridFileResult::CantOpen;
+	}
+
+	const int64 Length = GridFile::GetLength(File);
+	std::vector<uint8> Data(Length > 0 ? (size_t)Length : 0);
+	const bool bRead = (Length >= 0) && (std::fseek(File, 0, SEEK_SET) == 0) && (std::fread(Data.data(), 1, Data.size(), File) == Data.size());
+	std::fclose(File);
+	return bRead ? Read(Data.data(), (int64)Data.size(), OutGraph) : EGridFileResult::CantOpen;
+}
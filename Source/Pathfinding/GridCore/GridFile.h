@@ -0,0 +1,82 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "GridTypes.h"
+
+class FGridGraph;
+
+/** Outcome of reading or writing a grid file */
+enum class EGridFileResult : uint8
+{
+	Success,
+	/** The file couldn't be opened or read */
+	CantOpen,
+	/** The file couldn't be written in full */
+	CantWrite,
+	/** Not a grid file */
+	BadMagic,
+	/** Written by a newer version of the format */
+	NewerVersion,
+	/** Header sizes that make no sense */
+	BadHeader,
+	/** Shorter than its header says */
+	Truncated
+};
+
+const char* GetGridFileResultName(EGridFileResult Result);
+
+/** Fixed start of a grid file. Everything in the file is little-endian */
+struct FGridFileHeader
+{
+	uint32 Magic;
+	uint16 Version;
+	/** FGridFile::HasCosts if a cost layer follows the walls */
+	uint16 Flags;
+	/** Bytes before the wall bitset, lets later versions grow the header */
+	uint32 HeaderSize;
+	int32 Width;
+	int32 Height;
+	/** Start and goal cells, GridInvalidIndex if unset */
+	int32 Start;
+	int32 Goal;
+	uint32 Reserved;
+};
+
+static_assert(sizeof(FGridFileHeader) == 32, "Grid file header layout changed");
+
+/**
+ * Versioned binary board file: the header, a wall bitset of one bit per cell (bit Index % 8 of byte Index / 8) and,
+ * only if some cell costs more than 1, a cost layer of one byte per cell. A 4096x4096 maze is 2MB, 18MB with costs.
+ * Reading works on the file's bytes in place, so a memory-mapped file goes straight into the graph without a copy.
+ */
+class FGridFile
+{
+public:
+	enum : uint32
+	{
+		/** "PFGR" */
+		Magic = 0x52474650
+	};
+
+	enum : uint16
+	{
+		Version = 1,
+		HasCosts = 1 << 0
+	};
+
+	/** Bytes a board of the given size takes on disk */
+	static int64 GetFileSize(int32 Width, int32 Height, bool bWithCosts);
+
+	/** Write Graph's walls, costs, start and goal to Path */
+	static EGridFileResult Write(const char* Path, const FGridGraph& Graph);
+
+	/** Check the header at the start of Data, Size bytes long, and that the whole board follows it */
+	static EGridFileResult ReadHeader(const uint8* Data, int64 Size, FGridFileHeader& OutHeader);
+
+	/** Fill OutGraph from a whole file in memory, resizing it to the board's size. OutGraph is untouched on failure */
+	static EGridFileResult Read(const uint8* Data, int64 Size, FGridGraph& OutGraph);
+
+	/** Read the file at Path into memory and fill OutGraph from it, for callers that can't map files */
+	static EGridFileResult Load(const char* Path, FGridGraph& OutGraph);
+};
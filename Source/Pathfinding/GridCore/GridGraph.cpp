@@ -0,0 +1,267 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "GridGraph.h"
+#include <cstdlib>
+#include <cstring>
+
+namespace GridGraph
+{
+	/** For each byte of wall bits, the wall bit of the eight cells it covers, first cell in the lowest byte */
+	const uint64* GetWallMasks()
+	{
+		struct FWallMasks
+		{
+			uint64 Masks[256];
+			FWallMasks()
+			{
+				for (int32 Bits = 0; Bits < 256; Bits++)
+				{
+					Masks[Bits] = 0;
+					for (int32 Cell = 0; Cell < 8; Cell++)
+					{
+						Masks[Bits] |= (Bits & (1 << Cell)) != 0 ? (uint64)0x80 << (Cell * 8) : 0;
+					}
+				}
+			}
+		};
+		static const FWallMasks WallMasks;
+		return WallMasks.Masks;
+	}
+}
+
+FGridGraph::FGridGraph()
+	: Width(0)
+	, Height(0)
+	, StartIndex(GridInvalidIndex)
+	, GoalIndex(GridInvalidIndex)
+{
+	std::memset(CostCounts, 0, sizeof(CostCounts));
+}
+
+FGridGraph::FGridGraph(int32 InWidth, int32 InHeight)
+	: FGridGraph()
+{
+	Init(InWidth, InHeight);
+}
+
+void FGridGraph::Init(int32 InWidth, int32 InHeight)
+{
+	Width = InWidth > 0 ? InWidth : 0;
+	Height = InHeight > 0 ? InHeight : 0;
+	Cells.assign(Num(), 1);
+	std::memset(CostCounts, 0, sizeof(CostCounts));
+	CostCounts[1] = Num();
+	StartIndex = GridInvalidIndex;
+	GoalIndex = GridInvalidIndex;
+}
+
+void FGridGraph::Clear()
+{
+	Init(Width, Height);
+}
+
+void FGridGraph::AssignCells(int32 InWidth, int32 InHeight, const uint8* WallBits, const uint8* Costs)
+{
+	Width = InWidth > 0 ? InWidth : 0;
+	Height = InHeight > 0 ? InHeight : 0;
+	Cells.resize(Num());
+	std::memset(CostCounts, 0, sizeof(CostCounts));
+	StartIndex = GridInvalidIndex;
+	GoalIndex = GridInvalidIndex;
+
+	//Eight cells per wall byte: the byte picks the wall bits of all eight, the costs come in one 64 bit load
+	const uint64* WallMasks = GridGraph::GetWallMasks();
+	const int32 NumCells = Num();
+	const int32 NumWhole = NumCells & ~7;
+	int32 NumCostOne = 0;
+	for (int32 Index = 0; Index < NumWhole; Index += 8)
+	{
+		uint64 Word = 0x0101010101010101ull;
+		if (Costs != nullptr)
+		{
+			std::memcpy(&Word, Costs + Index, sizeof(Word));
+			if (Word != 0x0101010101010101ull)
+			{
+				for (int32 Cell = Index; Cell < Index + 8; Cell++)
+				{
+					const uint8 Cost = Costs[Cell] < 1 ? 1 : (Costs[Cell] > MaxCellCost ? (uint8)MaxCellCost : Costs[Cell]);
+					CostCounts[Cost]++;
+					Cells[Cell] = Cost;
+				}
+				std::memcpy(&Word, &Cells[Index], sizeof(Word));
+			}
+			else
+			{
+				//Plain ground is by far the most common, counted a word at a time
+				NumCostOne += 8;
+			}
+		}
+		Word |= WallMasks[WallBits[Index >> 3]];
+		std::memcpy(&Cells[Index], &Word, sizeof(Word));
+	}
+	for (int32 Index = NumWhole; Index < NumCells; Index++)
+	{
+		const uint8 Cost = Costs == nullptr ? 1 : (Costs[Index] < 1 ? 1 : (Costs[Index] > MaxCellCost ? (uint8)MaxCellCost : Costs[Index]));
+		CostCounts[Cost]++;
+		Cells[Index] = ((WallBits[Index >> 3] >> (Index & 7)) & 1) != 0 ? (CellWallBit | Cost) : Cost;
+	}
+	CostCounts[1] += Costs == nullptr ? NumWhole : NumCostOne;
+}
+
+void FGridGraph::CopyCells(uint8* OutWallBits, uint8* OutCosts) const
+{
+	const int32 NumCells = Num();
+	const int32 NumWhole = NumCells & ~7;
+	for (int32 Index = 0; Index < NumWhole; Index += 8)
+	{
+		uint64 Word;
+		std::memcpy(&Word, &Cells[Index], sizeof(Word));
+		//Gathers the top bit of each byte into the top byte, first cell lowest
+		OutWallBits[Index >> 3] = (uint8)(((Word & 0x8080808080808080ull) * 0x0002040810204081ull) >> 56);
+		if (OutCosts != nullptr)
+		{
+			Word &= 0x7f7f7f7f7f7f7f7full;
+			std::memcpy(OutCosts + Index, &Word, sizeof(Word));
+		}
+	}
+	if (NumWhole < NumCells)
+	{
+		OutWallBits[NumWhole >> 3] = 0;
+	}
+	for (int32 Index = NumWhole; Index < NumCells; Index++)
+	{
+		OutWallBits[Index >> 3] |= (uint8)(IsWall(Index) ? 1 << (Index & 7) : 0);
+		if (OutCosts != nullptr)
+		{
+			OutCosts[Index] = GetCost(Index);
+		}
+	}
+}
+
+void FGridGraph::SetWall(int32 Index, bool bWall)
+{
+	if (bWall)
+	{
+		Cells[Index] |= CellWallBit;
+	}
+	else
+	{
+		Cells[Index] &= ~CellWallBit;
+	}
+}
+
+void FGridGraph::SetCost(int32 Index, int32 Cost)
+{
+	//A zero cost would make every heuristic inadmissible, walls are the only way to block a cell
+	Cost = Cost < 1 ? 1 : (Cost > MaxCellCost ? MaxCellCost : Cost);
+
+	CostCounts[GetCost(Index)]--;
+	CostCounts[Cost]++;
+	Cells[Index] = (Cells[Index] & CellWallBit) | (uint8)Cost;
+}
+
+void FGridGraph::FillCostRect(int32 MinX, int32 MinY, int32 MaxX, int32 MaxY, int32 Cost)
+{
+	MinX = MinX < 0 ? 0 : MinX;
+	MinY = MinY < 0 ? 0 : MinY;
+	MaxX = MaxX >= Width ? Width - 1 : MaxX;
+	MaxY = MaxY >= Height ? Height - 1 : MaxY;
+
+	for (int32 Y = MinY; Y <= MaxY; Y++)
+	{
+		for (int32 X = MinX; X <= MaxX; X++)
+		{
+			SetCost(GetIndex(X, Y), Cost);
+		}
+	}
+}
+
+void FGridGraph::ResetCosts()
+{
+	for (uint8& Cell : Cells)
+	{
+		Cell = (Cell & CellWallBit) | 1;
+	}
+	std::memset(CostCounts, 0, sizeof(CostCounts));
+	CostCounts[1] = Num();
+}
+
+int32 FGridGraph::GetMinCost() const
+{
+	for (int32 Cost = 1; Cost <= MaxCellCost; Cost++)
+	{
+		if (CostCounts[Cost] > 0)
+		{
+			return Cost;
+		}
+	}
+	return 1;
+}
+
+int32 FGridGraph::GetMaxCost() const
+{
+	for (int32 Cost = MaxCellCost; Cost > 0; Cost--)
+	{
+		if (CostCounts[Cost] > 0)
+		{
+			return Cost;
+		}
+	}
+	return 1;
+}
+
+void FGridGraph::SetStart(int32 Index)
+{
+	StartIndex = IsValidIndex(Index) ? Index : GridInvalidIndex;
+}
+
+void FGridGraph::SetGoal(int32 Index)
+{
+	GoalIndex = IsValidIndex(Index) ? Index : GridInvalidIndex;
+}
+
+void FGridGraph::ResetCell(int32 Index)
+{
+	SetWall(Index, false);
+
+	if (StartIndex == Index)
+	{
+		StartIndex = GridInvalidIndex;
+	}
+	if (GoalIndex == Index)
+	{
+		GoalIndex = GridInvalidIndex;
+	}
+}
+
+int32 FGridGraph::GetNeighbors(int32 Index, int32 OutNeighbors[4]) const
+{
+	const int32 X = GetX(Index);
+	const int32 Y = GetY(Index);
+	int32 Count = 0;
+
+	//Same order the old line traces used: +Y row, -Y row, -X column, +X column
+	if (Y + 1 < Height && IsWalkable(Index + Width))
+	{
+		OutNeighbors[Count++] = Index + Width;
+	}
+	if (Y > 0 && IsWalkable(Index - Width))
+	{
+		OutNeighbors[Count++] = Index - Width;
+	}
+	if (X > 0 && IsWalkable(Index - 1))
+	{
+		OutNeighbors[Count++] = Index - 1;
+	}
+	if (X + 1 < Width && IsWalkable(Index + 1))
+	{
+		OutNeighbors[Count++] = Index + 1;
+	}
+
+	return Count;
+}
+
+int32 FGridGraph::GetManhattanDistance(int32 A, int32 B) const
+{
+	return std::abs(GetX(A) - GetX(B)) + std::abs(GetY(A) - GetY(B));
+}
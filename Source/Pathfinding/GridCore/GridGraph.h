@@ -0,0 +1,106 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "GridTypes.h"
+#include <vector>
+
+/**
+ * Dense, index-addressed grid graph with no engine dependencies.
+ * Cell Index = Y * Width + X. Neighbors are found with index arithmetic, so searches never need the world.
+ * Each cell is a single byte: the high bit marks a wall and the low 7 bits hold the traversal cost,
+ * so a 4096x4096 board with a full cost map is 16MB.
+ * APathfindingBlockGrid keeps one of these in sync with its blocks.
+ */
+class FGridGraph
+{
+public:
+	FGridGraph();
+	FGridGraph(int32 InWidth, int32 InHeight);
+
+	enum : int32
+	{
+		/** Highest cost a cell can carry */
+		MaxCellCost = 127
+	};
+
+	/** Resize the graph and clear every cell to walkable, cost 1 */
+	void Init(int32 InWidth, int32 InHeight);
+
+	/** Clear walls, costs, start and goal without resizing */
+	void Clear();
+
+	/**
+	 * Resize and fill every cell in one pass. WallBits holds one bit per cell, bit Index % 8 of byte Index / 8.
+	 * Costs holds one byte per cell, clamped like SetCost, or is null for cost 1 everywhere. Start and goal are cleared
+	 */
+	void AssignCells(int32 InWidth, int32 InHeight, const uint8* WallBits, const uint8* Costs);
+
+	/** Write every cell out in the layout AssignCells takes. OutWallBits needs (Num() + 7) / 8 bytes, OutCosts may be null */
+	void CopyCells(uint8* OutWallBits, uint8* OutCosts) const;
+
+	int32 GetWidth() const { return Width; }
+	int32 GetHeight() const { return Height; }
+	int32 Num() const { return Width * Height; }
+
+	bool IsValidIndex(int32 Index) const { return Index >= 0 && Index < Num(); }
+	bool IsValidCoord(int32 X, int32 Y) const { return X >= 0 && X < Width && Y >= 0 && Y < Height; }
+	int32 GetIndex(int32 X, int32 Y) const { return Y * Width + X; }
+	int32 GetX(int32 Index) const { return Index % Width; }
+	int32 GetY(int32 Index) const { return Index / Width; }
+
+	bool IsWall(int32 Index) const { return (Cells[Index] & CellWallBit) != 0; }
+	bool IsWalkable(int32 Index) const { return (Cells[Index] & CellWallBit) == 0; }
+	void SetWall(int32 Index, bool bWall);
+
+	/** Cost of stepping onto a cell, 1..MaxCellCost. A wall keeps its cost so it comes back when the wall is removed */
+	uint8 GetCost(int32 Index) const { return Cells[Index] & CellCostMask; }
+
+	/** Set a cell's cost, clamped to 1..MaxCellCost */
+	void SetCost(int32 Index, int32 Cost);
+
+	/** Set the cost of every cell in the inclusive rectangle, clipped to the grid */
+	void FillCostRect(int32 MinX, int32 MinY, int32 MaxX, int32 MaxY, int32 Cost);
+
+	/** Put every cell back to cost 1, walls stay */
+	void ResetCosts();
+
+	/** Smallest cost on the grid, used to keep heuristics admissible */
+	int32 GetMinCost() const;
+
+	/** Largest cost on the grid, bounds the key spread of a bucket queue */
+	int32 GetMaxCost() const;
+
+	int32 GetStart() const { return StartIndex; }
+	int32 GetGoal() const { return GoalIndex; }
+	void SetStart(int32 Index);
+	void SetGoal(int32 Index);
+
+	/** Make a cell walkable and drop it as start/goal. Its cost is left alone */
+	void ResetCell(int32 Index);
+
+	/** Write the walkable neighbors of a cell into OutNeighbors, returns how many were written (at most 4) */
+	int32 GetNeighbors(int32 Index, int32 OutNeighbors[4]) const;
+
+	/** Manhattan distance in cells between two indices */
+	int32 GetManhattanDistance(int32 A, int32 B) const;
+
+private:
+	enum : uint8
+	{
+		CellWallBit = 0x80,
+		CellCostMask = 0x7f,
+	};
+
+	int32 Width;
+	int32 Height;
+
+	/** Wall bit and cost packed into one byte per cell */
+	std::vector<uint8> Cells;
+
+	/** How many cells use each cost value, so GetMinCost doesn't have to scan the grid */
+	int32 CostCounts[MaxCellCost + 1];
+
+	int32 StartIndex;
+	int32 GoalIndex;
+};
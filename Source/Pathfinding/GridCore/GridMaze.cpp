@@ -0,0 +1,499 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "GridMaze.h"
+#include "GridMemory.h"
+#include "GridGraph.h"
+#include <chrono>
+#include <utility>
+
+const char* GetMazeAlgorithmName(EGridMazeAlgorithm Algorithm)
+{
+	switch (Algorithm)
+	{
+	case EGridMazeAlgorithm::RecursiveBacktracker:
+		return "RecursiveBacktracker";
+	case EGridMazeAlgorithm::Kruskal:
+		return "Kruskal";
+	case EGridMazeAlgorithm::Wilson:
+		return "Wilson";
+	case EGridMazeAlgorithm::Eller:
+		return "Eller";
+	case EGridMazeAlgorithm::RecursiveDivision:
+		return "RecursiveDivision";
+	default:
+		break;
+	}
+	return "Unknown";
+}
+
+void FGridEllerRows::Begin(int32 InRoomsX, uint64 Seed)
+{
+	RoomsX = InRoomsX > 0 ? InRoomsX : 0;
+	Random.Seed(Seed);
+	Parents.resize(RoomsX);
+	NextParents.resize(RoomsX);
+	SetSizes.resize(RoomsX);
+	SetPicks.resize(RoomsX);
+	SetFirstDown.resize(RoomsX);
+	for (int32 Room = 0; Room < RoomsX; Room++)
+	{
+		Parents[Room] = Room;
+	}
+}
+
+int32 FGridEllerRows::FindSet(int32 Room)
+{
+	while (Parents[Room] != Room)
+	{
+		Parents[Room] = Parents[Parents[Room]];
+		Room = Parents[Room];
+	}
+	return Room;
+}
+
+void FGridEllerRows::NextRow(bool bLastRow, std::vector<uint8>& OutEast, std::vector<uint8>& OutSouth)
+{
+	OutEast.assign(RoomsX, 0);
+	OutSouth.assign(RoomsX, 0);
+
+	//Join neighbors from different sets at random, or always on the last row
+	for (int32 X = 0; X + 1 < RoomsX; X++)
+	{
+		const int32 SetA = FindSet(X);
+		const int32 SetB = FindSet(X + 1);
+		if ((SetA != SetB) && (bLastRow || Random.RandBool()))
+		{
+			Parents[SetB] = SetA;
+			OutEast[X] = 1;
+		}
+	}
+	if (bLastRow)
+	{
+		return;
+	}
+
+	for (int32 X = 0; X < RoomsX; X++)
+	{
+		Parents[X] = FindSet(X);
+		SetSizes[X] = 0;
+		SetFirstDown[X] = GridInvalidIndex;
+	}
+
+	//Random rooms go down, and every set picks one room by reservoir sampling in case none of its rooms did
+	for (int32 X = 0; X < RoomsX; X++)
+	{
+		const int32 Set = Parents[X];
+		if (Random.RandRange(++SetSizes[Set]) == 0)
+		{
+			SetPicks[Set] = X;
+		}
+		if (Random.RandBool())
+		{
+			OutSouth[X] = 1;
+			if (SetFirstDown[Set] == GridInvalidIndex)
+			{
+				SetFirstDown[Set] = X;
+			}
+		}
+	}
+	for (int32 X = 0; X < RoomsX; X++)
+	{
+		if ((Parents[X] == X) && (SetFirstDown[X] == GridInvalidIndex))
+		{
+			OutSouth[SetPicks[X]] = 1;
+			SetFirstDown[X] = SetPicks[X];
+		}
+	}
+
+	//Rooms below a passage stay in their set, the others start a set of their own
+	for (int32 X = 0; X < RoomsX; X++)
+	{
+		NextParents[X] = OutSouth[X] ? SetFirstDown[Parents[X]] : X;
+	}
+	std::swap(Parents, NextParents);
+}
+
+FGridMazeStats FGridMazeGenerator::Generate(FGridGraph& Graph, uint32 Seed, EGridMazeAlgorithm Algorithm, float BraidFraction)
+{
+	const auto StartTime = std::chrono::steady_clock::now();
+	FGridMazeStats Stats;
+	Stats.Algorithm = Algorithm;
+
+	Width = Graph.GetWidth();
+	RoomsX = GetNumRooms(Width);
+	RoomsY = GetNumRooms(Graph.GetHeight());
+	Random.Seed(Seed);
+	for (int32 Index = 0; Index < Graph.Num(); Index++)
+	{
+		Graph.SetWall(Index, true);
+	}
+
+	if ((RoomsX > 0) && (RoomsY > 0))
+	{
+		//Every algorithm only decides which walls between rooms to open
+		for (int32 Room = 0; Room < RoomsX * RoomsY; Room++)
+		{
+			Graph.SetWall(GetRoomCell(Room), false);
+		}
+
+		switch (Algorithm)
+		{
+		case EGridMazeAlgorithm::Kruskal:
+			CarveKruskal(Graph);
+			break;
+		case EGridMazeAlgorithm::Wilson:
+			CarveWilson(Graph);
+			break;
+		case EGridMazeAlgorithm::Eller:
+			CarveEller(Graph);
+			break;
+		case EGridMazeAlgorithm::RecursiveDivision:
+			CarveDivision(Graph);
+			break;
+		default:
+			CarveBacktracker(Graph);
+			break;
+		}
+
+		if (BraidFraction > 0.f)
+		{
+			Stats.NumBraided = Braid(Graph, BraidFraction);
+		}
+	}
+
+	Stats.Milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - StartTime).count();
+
+	//Counted after the clock stops, the timing is for carving alone
+	for (int32 Index = 0; Index < Graph.Num(); Index++)
+	{
+		Stats.NumOpen += Graph.IsWalkable(Index) ? 1 : 0;
+	}
+	Stats.NumDeadEnds = CountDeadEnds(Graph);
+	return Stats;
+}
+
+int32 FGridMazeGenerator::CountDeadEnds(const FGridGraph& Graph)
+{
+	int32 NumDeadEnds = 0;
+	int32 Neighbors[4];
+	for (int32 Index = 0; Index < Graph.Num(); Index++)
+	{
+		if (Graph.IsWalkable(Index) && (Graph.GetNeighbors(Index, Neighbors) == 1))
+		{
+			NumDeadEnds++;
+		}
+	}
+	return NumDeadEnds;
+}
+
+void FGridMazeGenerator::CarveBacktracker(FGridGraph& Graph)
+{
+	const int32 NumRooms = RoomsX * RoomsY;
+	Visited.assign(NumRooms, 0);
+	Stack.clear();
+	Stack.reserve(NumRooms);
+
+	const int32 First = Random.RandRange(NumRooms);
+	Visited[First] = 1;
+	Stack.push_back(First);
+
+	while (!Stack.empty())
+	{
+		const int32 Room = Stack.back();
+		int32 Rooms[4];
+		int32 Candidates[4];
+		int32 NumCandidates = 0;
+		const int32 NumRoomsNear = GetNeighborRooms(Room, Rooms);
+		for (int32 i = 0; i < NumRoomsNear; i++)
+		{
+			if (!Visited[Rooms[i]])
+			{
+				Candidates[NumCandidates++] = Rooms[i];
+			}
+		}
+
+		//Dead end, back up until a room still has unvisited neighbors
+		if (NumCandidates == 0)
+		{
+			Stack.pop_back();
+			continue;
+		}
+
+		const int32 Next = Candidates[NumCandidates > 1 ? Random.RandRange(NumCandidates) : 0];
+		Connect(Graph, Room, Next);
+		Visited[Next] = 1;
+		Stack.push_back(Next);
+	}
+}
+
+void FGridMazeGenerator::CarveKruskal(FGridGraph& Graph)
+{
+	const int32 NumRooms = RoomsX * RoomsY;
+	Edges.clear();
+	Edges.reserve(NumRooms * 2);
+	for (int32 Room = 0; Room < NumRooms; Room++)
+	{
+		if (Room % RoomsX < RoomsX - 1)
+		{
+			Edges.push_back(Room * 2);
+		}
+		if (Room < NumRooms - RoomsX)
+		{
+			Edges.push_back(Room * 2 + 1);
+		}
+	}
+
+	//Fisher-Yates
+	for (int32 i = (int32)Edges.size() - 1; i > 0; i--)
+	{
+		std::swap(Edges[i], Edges[Random.RandRange(i + 1)]);
+	}
+
+	Links.resize(NumRooms);
+	for (int32 Room = 0; Room < NumRooms; Room++)
+	{
+		Links[Room] = Room;
+	}
+
+	int32 NumJoined = 1;
+	for (int32 Edge : Edges)
+	{
+		const int32 Room = Edge / 2;
+		const int32 Other = (Edge & 1) ? Room + RoomsX : Room + 1;
+		const int32 SetA = FindSet(Room);
+		const int32 SetB = FindSet(Other);
+		if (SetA != SetB)
+		{
+			Links[SetB] = SetA;
+			Connect(Graph, Room, Other);
+
+			//A spanning tree is done after NumRooms - 1 joins, the rest of the edges would all be rejected
+			if (++NumJoined == NumRooms)
+			{
+				break;
+			}
+		}
+	}
+}
+
+int32 FGridMazeGenerator::FindSet(int32 Room)
+{
+	int32 Root = Room;
+	while (Links[Root] != Root)
+	{
+		Root = Links[Root];
+	}
+	while (Links[Room] != Root)
+	{
+		const int32 Next = Links[Room];
+		Links[Room] = Root;
+		Room = Next;
+	}
+	return Root;
+}
+
+void FGridMazeGenerator::CarveWilson(FGridGraph& Graph)
+{
+	const int32 NumRooms = RoomsX * RoomsY;
+	Visited.assign(NumRooms, 0);
+	Links.resize(NumRooms);
+	Visited[Random.RandRange(NumRooms)] = 1;
+
+	for (int32 Start = 0; Start < NumRooms; Start++)
+	{
+		if (Visited[Start])
+		{
+			continue;
+		}
+
+		//Walk until the maze is hit. Each room remembers only its last exit, which erases the loops
+		int32 Room = Start;
+		while (!Visited[Room])
+		{
+			int32 Rooms[4];
+			const int32 NumRoomsNear = GetNeighborRooms(Room, Rooms);
+			Links[Room] = Rooms[Random.RandRange(NumRoomsNear)];
+			Room = Links[Room];
+		}
+
+		for (Room = Start; !Visited[Room]; Room = Links[Room])
+		{
+			Visited[Room] = 1;
+			Connect(Graph, Room, Links[Room]);
+		}
+	}
+}
+
+void FGridMazeGenerator::CarveEller(FGridGraph& Graph)
+{
+	EllerRows.Begin(RoomsX, Random.Next64());
+	for (int32 RoomY = 0; RoomY < RoomsY; RoomY++)
+	{
+		EllerRows.NextRow(RoomY == RoomsY - 1, East, South);
+		const int32 RowStart = RoomY * RoomsX;
+		for (int32 X = 0; X < RoomsX; X++)
+		{
+			if (East[X])
+			{
+				Connect(Graph, RowStart + X, RowStart + X + 1);
+			}
+			if (South[X])
+			{
+				Connect(Graph, RowStart + X, RowStart + X + RoomsX);
+			}
+		}
+	}
+}
+
+void FGridMazeGenerator::CarveDivision(FGridGraph& Graph)
+{
+	//Start from one open room and add walls
+	for (int32 Room = 0; Room < RoomsX * RoomsY; Room++)
+	{
+		if (Room % RoomsX < RoomsX - 1)
+		{
+			Connect(Graph, Room, Room + 1);
+		}
+		if (Room / RoomsX < RoomsY - 1)
+		{
+			Connect(Graph, Room, Room + RoomsX);
+		}
+	}
+
+	//Rectangles of rooms still to split, four entries each: MinX, MinY, MaxX, MaxY
+	Stack.clear();
+	Stack.insert(Stack.end(), { 0, 0, RoomsX - 1, RoomsY - 1 });
+	while (!Stack.empty())
+	{
+		const int32 MaxY = Stack.back(); Stack.pop_back();
+		const int32 MaxX = Stack.back(); Stack.pop_back();
+		const int32 MinY = Stack.back(); Stack.pop_back();
+		const int32 MinX = Stack.back(); Stack.pop_back();
+		const int32 SizeX = MaxX - MinX + 1;
+		const int32 SizeY = MaxY - MinY + 1;
+		if ((SizeX < 2) && (SizeY < 2))
+		{
+			continue;
+		}
+
+		//Cut across the longer side so the rooms stay roughly square
+		const bool bHorizontal = (SizeX < 2) || ((SizeY >= 2) && ((SizeY > SizeX) || ((SizeY == SizeX) && Random.RandBool())));
+		if (bHorizontal)
+		{
+			const int32 CutY = MinY + Random.RandRange(SizeY - 1);
+			const int32 GapX = MinX + Random.RandRange(SizeX);
+			for (int32 X = MinX; X <= MaxX; X++)
+			{
+				if (X != GapX)
+				{
+					Graph.SetWall((2 * CutY + 2) * Width + 2 * X + 1, true);
+				}
+			}
+			Stack.insert(Stack.end(), { MinX, MinY, MaxX, CutY });
+			Stack.insert(Stack.end(), { MinX, CutY + 1, MaxX, MaxY });
+		}
+		else
+		{
+			const int32 CutX = MinX + Random.RandRange(SizeX - 1);
+			const int32 GapY = MinY + Random.RandRange(SizeY);
+			for (int32 Y = MinY; Y <= MaxY; Y++)
+			{
+				if (Y != GapY)
+				{
+					Graph.SetWall((2 * Y + 1) * Width + 2 * CutX + 2, true);
+				}
+			}
+			Stack.insert(Stack.end(), { MinX, MinY, CutX, MaxY });
+			Stack.insert(Stack.end(), { CutX + 1, MinY, MaxX, MaxY });
+		}
+	}
+}
+
+int32 FGridMazeGenerator::Braid(FGridGraph& Graph, float Fraction)
+{
+	int32 NumBraided = 0;
+	for (int32 Room = 0; Room < RoomsX * RoomsY; Room++)
+	{
+		//Dead ends are always rooms, the cells between rooms have two sides
+		const int32 Cell = GetRoomCell(Room);
+		int32 Neighbors[4];
+		if ((Graph.GetNeighbors(Cell, Neighbors) != 1) || (Random.FRand() >= Fraction))
+		{
+			continue;
+		}
+
+		//Prefer knocking through to another dead end, that removes two at once
+		int32 Rooms[4];
+		int32 Candidates[4];
+		int32 NumCandidates = 0;
+		bool bCandidatesAreDeadEnds = false;
+		const int32 NumRoomsNear = GetNeighborRooms(Room, Rooms);
+		for (int32 i = 0; i < NumRoomsNear; i++)
+		{
+			const int32 OtherCell = GetRoomCell(Rooms[i]);
+			if (Graph.IsWalkable((Cell + OtherCell) / 2))
+			{
+				continue;
+			}
+
+			const bool bDeadEnd = Graph.GetNeighbors(OtherCell, Neighbors) == 1;
+			if (bDeadEnd && !bCandidatesAreDeadEnds)
+			{
+				NumCandidates = 0;
+				bCandidatesAreDeadEnds = true;
+			}
+			if (bDeadEnd == bCandidatesAreDeadEnds)
+			{
+				Candidates[NumCandidates++] = Rooms[i];
+			}
+		}
+
+		if (NumCandidates > 0)
+		{
+			Connect(Graph, Room, Candidates[Random.RandRange(NumCandidates)]);
+			NumBraided++;
+		}
+	}
+	return NumBraided;
+}
+
+void FGridMazeGenerator::Connect(FGridGraph& Graph, int32 RoomA, int32 RoomB) const
+{
+	//Neighboring room cells are two cells apart, the wall is the one in the middle
+	Graph.SetWall((GetRoomCell(RoomA) + GetRoomCell(RoomB)) / 2, false);
+}
+
+int32 FGridMazeGenerator::GetNeighborRooms(int32 Room, int32 OutRooms[4]) const
+{
+	const int32 RoomX = Room % RoomsX;
+	int32 NumRooms = 0;
+	if (RoomX > 0)
+	{
+		OutRooms[NumRooms++] = Room - 1;
+	}
+	if (RoomX < RoomsX - 1)
+	{
+		OutRooms[NumRooms++] = Room + 1;
+	}
+	if (Room >= RoomsX)
+	{
+		OutRooms[NumRooms++] = Room - RoomsX;
+	}
+	if (Room < RoomsX * (RoomsY - 1))
+	{
+		OutRooms[NumRooms++] = Room + RoomsX;
+	}
+	return NumRooms;
+}
+
+int64 FGridEllerRows::GetAllocatedBytes() const
+{
+	return GridMemory::GetAllocatedBytes(Parents) + GridMemory::GetAllocatedBytes(NextParents) + GridMemory::GetAllocatedBytes(SetSizes)
+		+ GridMemory::GetAllocatedBytes(SetPicks) + GridMemory::GetAllocatedBytes(SetFirstDown);
+}
+
+int64 FGridMazeGenerator::GetAllocatedBytes() const
+{
+	return GridMemory::GetAllocatedBytes(Stack) + GridMemory::GetAllocatedBytes(Visited) + GridMemory::GetAllocatedBytes(Links)
+		+ GridMemory::GetAllocatedBytes(Edges) + EllerRows.GetAllocatedBytes() + GridMemory::GetAllocatedBytes(East) + GridMemory::GetAllocatedBytes(South);
+}
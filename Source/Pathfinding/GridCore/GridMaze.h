@@ -0,0 +1,146 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "GridTypes.h"
+#include "GridRandom.h"
+#include <vector>
+
+class FGridGraph;
+
+/** Ways FGridMazeGenerator can carve a maze */
+enum class EGridMazeAlgorithm : uint8
+{
+	/** Randomized depth-first search: few, very long corridors */
+	RecursiveBacktracker,
+	/** Random spanning tree by joining rooms in shuffled order: many short dead ends */
+	Kruskal,
+	/** Loop-erased random walks: an unbiased sample of all possible mazes */
+	Wilson,
+	/** One row of rooms at a time, memory only grows with the width */
+	Eller,
+	/** Splits open space with walls that each keep one gap: long straight walls, boxy rooms */
+	RecursiveDivision,
+	Num
+};
+
+const char* GetMazeAlgorithmName(EGridMazeAlgorithm Algorithm);
+
+/** What one FGridMazeGenerator::Generate call made and how long it took */
+struct FGridMazeStats
+{
+	EGridMazeAlgorithm Algorithm = EGridMazeAlgorithm::RecursiveBacktracker;
+
+	/** Walkable cells in the finished maze */
+	int32 NumOpen = 0;
+
+	/** Walkable cells with a single walkable neighbor */
+	int32 NumDeadEnds = 0;
+
+	/** Walls knocked out by braiding */
+	int32 NumBraided = 0;
+
+	double Milliseconds = 0.0;
+};
+
+/**
+ * Eller's algorithm one row of rooms at a time. Only the current row's sets are kept, so rows can be produced for an
+ * unbounded height. The same seed and width always give the same sequence of rows.
+ */
+class FGridEllerRows
+{
+public:
+	void Begin(int32 InRoomsX, uint64 Seed);
+
+	/**
+	 * Carve the next row. OutEast[X] is 1 where room X opens to room X + 1, OutSouth[X] where it opens to the room
+	 * below. The last row joins every remaining set so the maze stays connected, and opens nothing south
+	 */
+	void NextRow(bool bLastRow, std::vector<uint8>& OutEast, std::vector<uint8>& OutSouth);
+
+	int32 GetRoomsX() const { return RoomsX; }
+
+	/** Heap bytes held by the row buffers */
+	int64 GetAllocatedBytes() const;
+
+private:
+	int32 FindSet(int32 Room);
+
+	FGridRandom Random;
+	int32 RoomsX = 0;
+
+	/** Union-find over the rooms of the current row */
+	std::vector<int32> Parents;
+	std::vector<int32> NextParents;
+
+	/** Per set root: rooms seen, the room picked to carry the set down if no random one did, the first room that went down */
+	std::vector<int32> SetSizes;
+	std::vector<int32> SetPicks;
+	std::vector<int32> SetFirstDown;
+};
+
+/**
+ * Carves perfect mazes into a grid graph. Rooms sit on odd coordinates and every other cell starts as a wall, so the
+ * border is always walled and any Width x Height works; an even size just leaves its last row or column solid.
+ * Everything runs on cell indices with buffers kept between calls, so nothing recurses or allocates per cell.
+ */
+class FGridMazeGenerator
+{
+public:
+	/**
+	 * Wall the whole graph and carve a maze with Algorithm. BraidFraction of the dead ends then get a wall knocked
+	 * out, adding loops; 0 keeps the maze perfect, 1 removes every dead end. The same seed, size and settings always
+	 * give the same maze. Costs, start and goal are left alone
+	 */
+	FGridMazeStats Generate(FGridGraph& Graph, uint32 Seed, EGridMazeAlgorithm Algorithm = EGridMazeAlgorithm::RecursiveBacktracker, float BraidFraction = 0.f);
+
+	/** Rooms along each axis for a grid of Size cells */
+	static int32 GetNumRooms(int32 Size) { return Size >= 3 ? (Size - 1) / 2 : 0; }
+
+	/** Walkable cells with exactly one walkable neighbor */
+	static int32 CountDeadEnds(const FGridGraph& Graph);
+
+	/** Heap bytes held by the carving buffers kept between mazes */
+	int64 GetAllocatedBytes() const;
+
+private:
+	void CarveBacktracker(FGridGraph& Graph);
+	void CarveKruskal(FGridGraph& Graph);
+	void CarveWilson(FGridGraph& Graph);
+	void CarveEller(FGridGraph& Graph);
+	void CarveDivision(FGridGraph& Graph);
+	int32 Braid(FGridGraph& Graph, float Fraction);
+
+	/** Cell of room (Room % RoomsX, Room / RoomsX), which is cell (2X + 1, 2Y + 1) */
+	int32 GetRoomCell(int32 Room) const { return (2 * (Room / RoomsX) + 1) * Width + 2 * (Room % RoomsX) + 1; }
+
+	/** Open the wall cell between two neighboring rooms */
+	void Connect(FGridGraph& Graph, int32 RoomA, int32 RoomB) const;
+
+	/** Rooms next to Room, returns how many */
+	int32 GetNeighborRooms(int32 Room, int32 OutRooms[4]) const;
+
+	/** Kruskal's union-find with path compression */
+	int32 FindSet(int32 Room);
+
+	FGridRandom Random;
+	int32 Width = 0;
+	int32 RoomsX = 0;
+	int32 RoomsY = 0;
+
+	/** Rooms of the current walk, or room rectangles for division */
+	std::vector<int32> Stack;
+
+	/** Rooms reached so far */
+	std::vector<uint8> Visited;
+
+	/** Union-find parents for Kruskal, walk directions for Wilson */
+	std::vector<int32> Links;
+
+	/** Room pairs Kruskal joins, Room * 2 + 0 for the east wall and + 1 for the south wall */
+	std::vector<int32> Edges;
+
+	FGridEllerRows EllerRows;
+	std::vector<uint8> East;
+	std::vector<uint8> South;
+};
@@ -0,0 +1,35 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "GridTypes.h"
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+/** Memory accounting for the GetAllocatedBytes functions of the grid structures */
+namespace GridMemory
+{
+	/** Heap bytes a vector holds, which is its capacity rather than its size */
+	template <typename ElementType>
+	int64 GetAllocatedBytes(const std::vector<ElementType>& Array)
+	{
+		return (int64)Array.capacity() * (int64)sizeof(ElementType);
+	}
+
+	/** Heap bytes of a list's nodes, estimated as the element plus two links each. Not what the elements themselves point to */
+	template <typename ElementType>
+	int64 GetAllocatedBytes(const std::list<ElementType>& List)
+	{
+		return (int64)List.size() * (int64)(sizeof(ElementType) + 2 * sizeof(void*));
+	}
+
+	/** Heap bytes of a hash map, estimated as its bucket array plus one node per entry with its next link and hash */
+	template <typename KeyType, typename ValueType, typename HashType>
+	int64 GetAllocatedBytes(const std::unordered_map<KeyType, ValueType, HashType>& Map)
+	{
+		return (int64)Map.bucket_count() * (int64)sizeof(void*)
+			+ (int64)Map.size() * (int64)(sizeof(std::pair<const KeyType, ValueType>) + sizeof(void*) + sizeof(std::size_t));
+	}
+}
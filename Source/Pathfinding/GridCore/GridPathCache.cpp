@@ -0,0 +1,139 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "GridPathCache.h"
+#include "GridMemory.h"
+#include "GridGraph.h"
+#include <algorithm>
+#include <cstdlib>
+
+FGridPathCache::FGridPathCache(int32 InCapacity)
+	: Capacity(std::max(InCapacity, 0))
+{
+}
+
+const FGridCachedPath* FGridPathCache::Find(int32 Start, int32 Goal, EGridSearchAlgorithm Algorithm)
+{
+	const auto Found = Lookup.find(FKey{ Start, Goal, Algorithm });
+	if (Found == Lookup.end())
+	{
+		Stats.Misses++;
+		return nullptr;
+	}
+
+	Stats.Hits++;
+	Entries.splice(Entries.begin(), Entries, Found->second);
+	return &Found->second->Value;
+}
+
+void FGridPathCache::Add(int32 Start, int32 Goal, EGridSearchAlgorithm Algorithm, const FGridSearchResult& Result, uint32 SearchedVersion)
+{
+	if (Result.bCancelled || SearchedVersion != Version || Capacity == 0)
+	{
+		return;
+	}
+
+	const FKey Key{ Start, Goal, Algorithm };
+	const auto Found = Lookup.find(Key);
+	if (Found != Lookup.end())
+	{
+		Evict(Found->second);
+	}
+
+	Entries.push_front(FEntry());
+	FEntry& Entry = Entries.front();
+	Entry.Key = Key;
+	Entry.Value.bFound = Result.bFound;
+	Entry.Value.Cost = Result.Cost;
+	Entry.Value.Path = Result.Path;
+	Entry.Value.Version = Version;
+	Entry.SortedCells = Result.Path;
+	std::sort(Entry.SortedCells.begin(), Entry.SortedCells.end());
+	Lookup[Key] = Entries.begin();
+
+	Trim();
+}
+
+void FGridPathCache::OnCellChanged(const FGridGraph& Graph, int32 Index)
+{
+	Version++;
+
+	const bool bBlocked = Graph.IsWall(Index);
+	const int32 MinCost = Graph.GetMinCost();
+	const int32 X = Graph.GetX(Index);
+	const int32 Y = Graph.GetY(Index);
+
+	for (auto Entry = Entries.begin(); Entry != Entries.end();)
+	{
+		const auto Next = std::next(Entry);
+		const FGridCachedPath& Value = Entry->Value;
+
+		bool bAffected;
+		if (!Value.bFound)
+		{
+			//Walls never connect anything
+			bAffected = !bBlocked;
+		}
+		else if (std::binary_search(Entry->SortedCells.begin(), Entry->SortedCells.end(), Index))
+		{
+			bAffected = true;
+		}
+		else if (bBlocked)
+		{
+			bAffected = false;
+		}
+		else
+		{
+			//The cell may be open or cheaper now, keep the path if no route through the cell can be shorter
+			const int32 Start = Entry->Key.Start;
+			const int32 Goal = Entry->Key.Goal;
+			const int32 ThroughCell = std::abs(Graph.GetX(Start) - X) + std::abs(Graph.GetY(Start) - Y)
+				+ std::abs(Graph.GetX(Goal) - X) + std::abs(Graph.GetY(Goal) - Y);
+			bAffected = Value.Cost > MinCost * ThroughCell;
+		}
+
+		if (bAffected)
+		{
+			Stats.Invalidations++;
+			Evict(Entry);
+		}
+		Entry = Next;
+	}
+}
+
+void FGridPathCache::Clear()
+{
+	Version++;
+	Entries.clear();
+	Lookup.clear();
+}
+
+void FGridPathCache::SetCapacity(int32 InCapacity)
+{
+	Capacity = std::max(InCapacity, 0);
+	Trim();
+}
+
+void FGridPathCache::Evict(FEntryList::iterator Entry)
+{
+	Lookup.erase(Entry->Key);
+	Entries.erase(Entry);
+}
+
+void FGridPathCache::Trim()
+{
+	while ((int32)Entries.size() > Capacity)
+	{
+		Stats.Evictions++;
+		Evict(std::prev(Entries.end()));
+	}
+}
+
+int64 FGridPathCache::GetAllocatedBytes() const
+{
+	int64 Bytes = GridMemory::GetAllocatedBytes(Entries) + GridMemory::GetAllocatedBytes(Lookup);
+	for (const FEntry& Entry : Entries)
+	{
+		Bytes += GridMemory::GetAllocatedBytes(Entry.Value.Path) + GridMemory::GetAllocatedBytes(Entry.SortedCells);
+	}
+	return Bytes;
+}
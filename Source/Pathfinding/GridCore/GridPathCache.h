@@ -0,0 +1,116 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "GridTypes.h"
+#include "GridSearch.h"
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+class FGridGraph;
+
+/** Counters of an FGridPathCache since it was created or ResetStats was called */
+struct FGridPathCacheStats
+{
+	int64 Hits = 0;
+	int64 Misses = 0;
+	/** Entries dropped because an edit could change their path */
+	int64 Invalidations = 0;
+	/** Entries dropped to stay under the capacity */
+	int64 Evictions = 0;
+};
+
+/** A cached search result */
+struct FGridCachedPath
+{
+	bool bFound = false;
+	int32 Cost = 0;
+	/** Cells from start to goal */
+	std::vector<int32> Path;
+	/** Cache version the path was searched on */
+	uint32 Version = 0;
+};
+
+/**
+ * LRU cache of optimal paths keyed on (start, goal, algorithm).
+ * Edits only drop the entries they can affect. A cell that became a wall or changed cost drops the paths that go
+ * through it. A cell that opened up or got cheaper drops the paths a detour through it could beat: any such detour
+ * costs at least MinCost * (Manhattan(Start, Cell) + Manhattan(Cell, Goal)), so paths no longer than that are kept.
+ * Every edit bumps the version, so results searched on an older board can be turned away.
+ */
+class FGridPathCache
+{
+public:
+	enum : int32
+	{
+		DefaultCapacity = 1024
+	};
+
+	explicit FGridPathCache(int32 InCapacity = DefaultCapacity);
+
+	/** The cached result or nullptr. Counts a hit or a miss and marks the entry as recently used */
+	const FGridCachedPath* Find(int32 Start, int32 Goal, EGridSearchAlgorithm Algorithm);
+
+	/** Store a finished search. Ignored if it was cancelled or searched before the board last changed */
+	void Add(int32 Start, int32 Goal, EGridSearchAlgorithm Algorithm, const FGridSearchResult& Result, uint32 SearchedVersion);
+
+	/** Call after a cell's wall state or cost changed in Graph */
+	void OnCellChanged(const FGridGraph& Graph, int32 Index);
+
+	/** Drop everything, e.g. when the whole board was reset */
+	void Clear();
+
+	/** Bumped on every edit */
+	uint32 GetVersion() const { return Version; }
+
+	void SetCapacity(int32 InCapacity);
+	int32 GetCapacity() const { return Capacity; }
+	int32 Num() const { return (int32)Entries.size(); }
+
+	const FGridPathCacheStats& GetStats() const { return Stats; }
+	void ResetStats() { Stats = FGridPathCacheStats(); }
+
+	/** Heap bytes held by the entries, their paths and the lookup */
+	int64 GetAllocatedBytes() const;
+
+private:
+	struct FKey
+	{
+		int32 Start;
+		int32 Goal;
+		EGridSearchAlgorithm Algorithm;
+
+		bool operator==(const FKey& Other) const { return Start == Other.Start && Goal == Other.Goal && Algorithm == Other.Algorithm; }
+	};
+
+	struct FKeyHash
+	{
+		size_t operator()(const FKey& Key) const
+		{
+			return ((size_t)(uint32)Key.Start * 0x9E3779B1u) ^ ((size_t)(uint32)Key.Goal * 0x85EBCA77u) ^ (size_t)Key.Algorithm;
+		}
+	};
+
+	struct FEntry
+	{
+		FKey Key;
+		FGridCachedPath Value;
+		/** Path cells sorted, for the on-path test */
+		std::vector<int32> SortedCells;
+	};
+
+	typedef std::list<FEntry> FEntryList;
+
+	void Evict(FEntryList::iterator Entry);
+	void Trim();
+
+	/** Most recently used first */
+	FEntryList Entries;
+	std::unordered_map<FKey, FEntryList::iterator, FKeyHash> Lookup;
+
+	int32 Capacity;
+	uint32 Version = 0;
+	FGridPathCacheStats Stats;
+};
@@ -0,0 +1,45 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "GridPlayback.h"
+#include "GridSearch.h"
+#include <algorithm>
+
+void FGridPlayback::Build(const FGridSearchResult& Result, int32 NumCells, int32 Start, int32 Goal)
+{
+	Clear();
+	Events.reserve(Result.VisitedOrder.size() + Result.Path.size());
+
+	//What each cell shows after the events so far, so every event knows what undoing it goes back to
+	std::vector<EGridPlaybackVisual> Current(NumCells, EGridPlaybackVisual::Open);
+	auto AddEvent = [this, &Current, Start, Goal](int32 Cell, EGridPlaybackVisual Visual)
+	{
+		if ((Cell != Start) && (Cell != Goal) && (Current[Cell] != Visual))
+		{
+			Events.push_back(FGridPlaybackEvent{ Cell, Visual, Current[Cell] });
+			Current[Cell] = Visual;
+		}
+	};
+
+	for (size_t i = 0; i < Result.VisitedOrder.size(); i++)
+	{
+		const bool bFromGoal = (i < Result.VisitedFromGoal.size()) && Result.VisitedFromGoal[i];
+		AddEvent(Result.VisitedOrder[i], bFromGoal ? EGridPlaybackVisual::VisitedFromGoal : EGridPlaybackVisual::Visited);
+	}
+	for (int32 Cell : Result.Path)
+	{
+		AddEvent(Cell, EGridPlaybackVisual::Path);
+	}
+}
+
+void FGridPlayback::Clear()
+{
+	Events.clear();
+	Position = 0.0;
+	Applied = 0;
+	bPlaying = false;
+}
+
+void FGridPlayback::Seek(double NewPosition)
+{
+	Position = std::min(std::max(NewPosition, 0.0), (double)Num());
+}
@@ -0,0 +1,108 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "GridTypes.h"
+#include <vector>
+
+struct FGridSearchResult;
+
+/** What a cell shows at some point of a search replay */
+enum class EGridPlaybackVisual : uint8
+{
+	Open,
+	Visited,
+	/** Visited by the backward half of a bidirectional search */
+	VisitedFromGoal,
+	Path,
+};
+
+/** One step of a replay: Cell changes from PreviousVisual to Visual */
+struct FGridPlaybackEvent
+{
+	int32 Cell;
+	EGridPlaybackVisual Visual;
+	EGridPlaybackVisual PreviousVisual;
+};
+
+/**
+ * Replays a search as a stream of cell changes: the visited cells in order, then the path from start to goal.
+ * The play head moves at Speed events per second and can be paused or moved anywhere. What is on screen follows it by
+ * at most MaxUpdates events per Advance call, so one frame never does more than a fixed amount of work even right
+ * after a seek across millions of events; seeking backwards undoes events.
+ */
+class FGridPlayback
+{
+public:
+	/** Replace the replay with the events of Result. Start and goal are left out so they keep their own look */
+	void Build(const FGridSearchResult& Result, int32 NumCells, int32 Start, int32 Goal);
+
+	/** Drop every event, without undoing them */
+	void Clear();
+
+	void Play() { bPlaying = true; }
+	void Pause() { bPlaying = false; }
+	bool IsPlaying() const { return bPlaying; }
+
+	/** Events per second while playing */
+	void SetSpeed(double EventsPerSecond) { Speed = EventsPerSecond > 0.0 ? EventsPerSecond : 0.0; }
+	double GetSpeed() const { return Speed; }
+
+	/** Move the play head to an event position, 0 shows nothing and Num() shows everything */
+	void Seek(double Position);
+
+	/** Seek to a fraction of the replay */
+	void SeekNormalized(double Alpha) { Seek(Alpha * Num()); }
+
+	double GetPosition() const { return Position; }
+	int32 Num() const { return (int32)Events.size(); }
+
+	/** Has the screen caught up with the play head and is there nothing left to play */
+	bool IsFinished() const { return (Applied == (int32)Position) && (!bPlaying || Applied == Num()); }
+
+	/**
+	 * Move the play head by DeltaSeconds of playback and call Apply(Cell, Visual) for up to MaxUpdates events to bring
+	 * the screen towards it. Returns how many events were applied
+	 */
+	template <typename ApplyType>
+	int32 Advance(double DeltaSeconds, int32 MaxUpdates, ApplyType&& Apply)
+	{
+		if (bPlaying)
+		{
+			Position += DeltaSeconds * Speed;
+			if (Position >= Num())
+			{
+				Position = Num();
+				bPlaying = false;
+			}
+		}
+
+		const int32 Target = (int32)Position;
+		int32 Updates = 0;
+		while (Applied < Target && Updates < MaxUpdates)
+		{
+			const FGridPlaybackEvent& Event = Events[Applied++];
+			Apply(Event.Cell, Event.Visual);
+			Updates++;
+		}
+		while (Applied > Target && Updates < MaxUpdates)
+		{
+			const FGridPlaybackEvent& Event = Events[--Applied];
+			Apply(Event.Cell, Event.PreviousVisual);
+			Updates++;
+		}
+		return Updates;
+	}
+
+private:
+	std::vector<FGridPlaybackEvent> Events;
+
+	/** Play head in events */
+	double Position = 0.0;
+
+	/** Events [0, Applied) are on screen */
+	int32 Applied = 0;
+
+	double Speed = 250.0;
+	bool bPlaying = false;
+};
@@ -0,0 +1,125 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "GridQueryQueue.h"
+#include "GridGraph.h"
+#include <algorithm>
+
+int32 FGridQueryQueue::Push(FGridQuery Query)
+{
+	std::lock_guard<std::mutex> Lock(Mutex);
+
+	Query.Handle = NextHandle++;
+	Query.CancelFlag = std::make_shared<std::atomic<bool>>(false);
+	Active[Query.Handle] = Query.CancelFlag;
+
+	const int32 Handle = Query.Handle;
+	Pending.push_back(FPending{ std::move(Query), NextSequence++ });
+	std::push_heap(Pending.begin(), Pending.end());
+	return Handle;
+}
+
+bool FGridQueryQueue::Pop(FGridQuery& OutQuery)
+{
+	std::lock_guard<std::mutex> Lock(Mutex);
+
+	while (!Pending.empty())
+	{
+		std::pop_heap(Pending.begin(), Pending.end());
+		FGridQuery Query = std::move(Pending.back().Query);
+		Pending.pop_back();
+
+		if (!Query.CancelFlag->load())
+		{
+			OutQuery = std::move(Query);
+			return true;
+		}
+		Active.erase(Query.Handle);
+	}
+	return false;
+}
+
+bool FGridQueryQueue::Cancel(int32 Handle)
+{
+	std::lock_guard<std::mutex> Lock(Mutex);
+
+	const auto Found = Active.find(Handle);
+	if (Found == Active.end())
+	{
+		return false;
+	}
+	Found->second->store(true);
+	return true;
+}
+
+void FGridQueryQueue::CancelAll()
+{
+	std::lock_guard<std::mutex> Lock(Mutex);
+
+	for (auto& Entry : Active)
+	{
+		Entry.second->store(true);
+	}
+}
+
+void FGridQueryQueue::Finish(int32 Handle)
+{
+	std::lock_guard<std::mutex> Lock(Mutex);
+	Active.erase(Handle);
+}
+
+int32 FGridQueryQueue::NumPending() const
+{
+	std::lock_guard<std::mutex> Lock(Mutex);
+	return (int32)Pending.size();
+}
+
+std::unique_ptr<FGridSearch> FGridQueryQueue::AcquireSearch()
+{
+	std::lock_guard<std::mutex> Lock(Mutex);
+
+	if (IdleSearches.empty())
+	{
+		return std::unique_ptr<FGridSearch>(new FGridSearch());
+	}
+	std::unique_ptr<FGridSearch> Search = std::move(IdleSearches.back());
+	IdleSearches.pop_back();
+	return Search;
+}
+
+void FGridQueryQueue::ReleaseSearch(std::unique_ptr<FGridSearch> Search)
+{
+	std::lock_guard<std::mutex> Lock(Mutex);
+
+	if (bKeepSearches)
+	{
+		IdleSearches.push_back(std::move(Search));
+	}
+}
+
+void FGridQueryQueue::ReleaseSearches()
+{
+	std::lock_guard<std::mutex> Lock(Mutex);
+
+	bKeepSearches = false;
+	IdleSearches.clear();
+}
+
+int64 FGridQueryQueue::GetIdleSearchBytes() const
+{
+	std::lock_guard<std::mutex> Lock(Mutex);
+
+	int64 Bytes = 0;
+	for (const std::unique_ptr<FGridSearch>& Search : IdleSearches)
+	{
+		Bytes += Search->GetAllocatedBytes();
+	}
+	return Bytes;
+}
+
+bool FGridQueryQueue::Execute(const FGridQuery& Query, FGridSearch& Search, FGridSearchResult& OutResult)
+{
+	Search.SetCancelFlag(Query.CancelFlag.get());
+	const bool bFound = Search.Run(*Query.Graph, Query.Start, Query.Goal, Query.Algorithm, OutResult, Query.OpenList);
+	Search.SetCancelFlag(nullptr);
+	return bFound;
+}
@@ -0,0 +1,110 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "GridTypes.h"
+#include "GridSearch.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+class FGridGraph;
+
+enum class EGridQueryPriority : uint8
+{
+	Low,
+	Normal,
+	High,
+};
+
+/** One queued search. The graph is a snapshot shared by every query made before the next edit, so workers never see a half-edited board */
+struct FGridQuery
+{
+	int32 Handle = 0;
+	int32 Start = GridInvalidIndex;
+	int32 Goal = GridInvalidIndex;
+	EGridSearchAlgorithm Algorithm = EGridSearchAlgorithm::AStar;
+	EGridOpenList OpenList = EGridOpenList::Heap;
+	EGridQueryPriority Priority = EGridQueryPriority::Normal;
+	std::shared_ptr<const FGridGraph> Graph;
+
+	/** Owner's board version when the snapshot was taken, handed back untouched */
+	uint32 GraphVersion = 0;
+
+	/** Set by Cancel, polled by the search while it runs */
+	std::shared_ptr<std::atomic<bool>> CancelFlag;
+};
+
+/**
+ * Thread safe queue of path queries.
+ * Whoever schedules work pushes a query and then starts one worker task per query; each task pops whatever query is
+ * most urgent when it gets to run (highest priority, then oldest), so priorities hold no matter how the tasks are
+ * scheduled. Cancelled queries are dropped when popped and stop early if they are already running.
+ */
+class FGridQueryQueue
+{
+public:
+	/** Queue a query and return its handle. Handle, CancelFlag and ordering are filled in here */
+	int32 Push(FGridQuery Query);
+
+	/** Take the most urgent query that hasn't been cancelled. Returns false once nothing is left */
+	bool Pop(FGridQuery& OutQuery);
+
+	/** Cancel a queued or running query. Returns false if the handle already finished */
+	bool Cancel(int32 Handle);
+
+	/** Cancel everything, used when the owner goes away */
+	void CancelAll();
+
+	/** Forget a query once its worker is done with it */
+	void Finish(int32 Handle);
+
+	int32 NumPending() const;
+
+	/** Run a query's search on the calling thread with the given scratch */
+	static bool Execute(const FGridQuery& Query, FGridSearch& Search, FGridSearchResult& OutResult);
+
+	/**
+	 * Borrow search scratch for one worker, reusing what an earlier worker returned. The pool only grows to the most
+	 * queries that ran at once, rather than one full-board set of buffers per pool thread for good
+	 */
+	std::unique_ptr<FGridSearch> AcquireSearch();
+
+	/** Give scratch back for the next query, or free it if ReleaseSearches was called */
+	void ReleaseSearch(std::unique_ptr<FGridSearch> Search);
+
+	/** Free the idle scratch and everything returned from now on, for when the owner goes away */
+	void ReleaseSearches();
+
+	/** Heap bytes held by idle scratch */
+	int64 GetIdleSearchBytes() const;
+
+private:
+	struct FPending
+	{
+		FGridQuery Query;
+		uint64 Sequence;
+
+		/** Heap order: lower priority, then later sequence, sinks */
+		bool operator<(const FPending& Other) const
+		{
+			return Query.Priority != Other.Query.Priority ? Query.Priority < Other.Query.Priority : Sequence > Other.Sequence;
+		}
+	};
+
+	mutable std::mutex Mutex;
+
+	/** Max-heap on FPending::operator< */
+	std::vector<FPending> Pending;
+
+	/** Cancel flags of every query that was pushed and not finished yet */
+	std::unordered_map<int32, std::shared_ptr<std::atomic<bool>>> Active;
+
+	int32 NextHandle = 1;
+	uint64 NextSequence = 0;
+
+	std::vector<std::unique_ptr<FGridSearch>> IdleSearches;
+	bool bKeepSearches = true;
+};
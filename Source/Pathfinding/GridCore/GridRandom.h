@@ -0,0 +1,39 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "GridTypes.h"
+
+/**
+ * Small seedable random stream (SplitMix64) for the grid code.
+ * The same seed gives the same numbers on every platform and compiler, which FMath::Rand and std::uniform_int_distribution
+ * don't promise, so generated boards can be reproduced from their seed alone.
+ */
+class FGridRandom
+{
+public:
+	explicit FGridRandom(uint64 InSeed = 0) : State(InSeed) {}
+
+	void Seed(uint64 InSeed) { State = InSeed; }
+
+	uint64 Next64()
+	{
+		uint64 Z = (State += 0x9e3779b97f4a7c15ull);
+		Z = (Z ^ (Z >> 30)) * 0xbf58476d1ce4e5b9ull;
+		Z = (Z ^ (Z >> 27)) * 0x94d049bb133111ebull;
+		return Z ^ (Z >> 31);
+	}
+
+	uint32 Next() { return (uint32)(Next64() >> 32); }
+
+	/** Uniform in [0, Max), Max > 0 */
+	int32 RandRange(int32 Max) { return (int32)(((uint64)Next() * (uint32)Max) >> 32); }
+
+	/** Uniform in [0, 1) */
+	float FRand() { return (Next() >> 8) * (1.f / 16777216.f); }
+
+	bool RandBool() { return (Next64() >> 63) != 0; }
+
+private:
+	uint64 State;
+};
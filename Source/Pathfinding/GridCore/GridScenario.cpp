@@ -0,0 +1,327 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "GridScenario.h"
+#include "GridGraph.h"
+#include "GridSearch.h"
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+
+namespace GridScenario
+{
+	/** Published lengths are printed with 8 decimals, and 577 / 408 is off sqrt(2) by a few parts per million */
+	constexpr double LengthTolerance = 1e-4;
+	constexpr double RelativeLengthTolerance = 1e-5;
+
+	/** Octile length of a path of orthogonal and diagonal steps */
+	double GetOctileLength(const FGridGraph& Graph, const std::vector<int32>& Path)
+	{
+		double Length = 0.0;
+		for (size_t i = 1; i < Path.size(); i++)
+		{
+			Length += Graph.GetManhattanDistance(Path[i - 1], Path[i]) == 1 ? 1.0 : std::sqrt(2.0);
+		}
+		return Length;
+	}
+
+	bool ReadText(const char* Path, std::string& OutText)
+	{
+		FILE* File = fopen(Path, "rb");
+		if (File == nullptr)
+		{
+			return false;
+		}
+
+		OutText.clear();
+		char Buffer[65536];
+		size_t Read;
+		while ((Read = fread(Buffer, 1, sizeof(Buffer), File)) > 0)
+		{
+			OutText.append(Buffer, Read);
+		}
+		const bool bError = ferror(File) != 0;
+		fclose(File);
+		return !bError;
+	}
+
+	/** Next line of Text from Offset on, without its line break. Returns false at the end */
+	bool NextLine(const std::string& Text, size_t& Offset, std::string& OutLine)
+	{
+		if (Offset >= Text.size())
+		{
+			return false;
+		}
+
+		size_t End = Text.find('\n', Offset);
+		End = End == std::string::npos ? Text.size() : End;
+		OutLine.assign(Text, Offset, End - Offset);
+		if (!OutLine.empty() && (OutLine.back() == '\r'))
+		{
+			OutLine.pop_back();
+		}
+		Offset = End + 1;
+		return true;
+	}
+
+	/** Empty if Result walks from Start to Goal over walkable neighbors and adds up to its cost, why not otherwise */
+	const char* CheckPath(const FGridGraph& Graph, int32 Start, int32 Goal, const FGridSearchResult& Result)
+	{
+		const std::vector<int32>& Path = Result.Path;
+		if (Path.empty() || (Path.front() != Start) || (Path.back() != Goal))
+		{
+			return "path doesn't join start and goal";
+		}
+
+		int32 Cost = 0;
+		for (size_t i = 1; i < Path.size(); i++)
+		{
+			const int32 Distance = Graph.GetManhattanDistance(Path[i - 1], Path[i]);
+			if (!Graph.IsValidIndex(Path[i]) || Graph.IsWall(Path[i]) || (Distance != 1))
+			{
+				return "path steps through a wall or skips cells";
+			}
+			Cost += Graph.GetCost(Path[i]);
+		}
+		return Cost == Result.Cost ? "" : "path cost differs from the reported cost";
+	}
+}
+
+bool FGridScenario::ParseMap(const std::string& Text, FGridGraph& OutGraph)
+{
+	size_t Offset = 0;
+	std::string Line;
+	int32 Width = -1;
+	int32 Height = -1;
+	bool bMap = false;
+	while (!bMap && GridScenario::NextLine(Text, Offset, Line))
+	{
+		int32 Value = 0;
+		if (sscanf(Line.c_str(), "height %d", &Value) == 1)
+		{
+			Height = Value;
+		}
+		else if (sscanf(Line.c_str(), "width %d", &Value) == 1)
+		{
+			Width = Value;
+		}
+		else if (Line == "map")
+		{
+			bMap = true;
+		}
+	}
+	if (!bMap || (Width <= 0) || (Height <= 0) || ((int64)Width * Height > 0x7fffffff))
+	{
+		return false;
+	}
+
+	OutGraph.Init(Width, Height);
+	for (int32 Y = 0; Y < Height; Y++)
+	{
+		if (!GridScenario::NextLine(Text, Offset, Line) || ((int32)Line.size() < Width))
+		{
+			return false;
+		}
+
+		for (int32 X = 0; X < Width; X++)
+		{
+			const char Terrain = Line[X];
+			if ((Terrain != '.') && (Terrain != 'G') && (Terrain != 'S'))
+			{
+				OutGraph.SetWall(OutGraph.GetIndex(X, Y), true);
+			}
+		}
+	}
+	return true;
+}
+
+bool FGridScenario::ReadMap(const char* Path, FGridGraph& OutGraph)
+{
+	std::string Text;
+	return GridScenario::ReadText(Path, Text) && ParseMap(Text, OutGraph);
+}
+
+bool FGridScenario::ParseScenario(const std::string& Text, std::vector<FGridScenarioQuery>& OutQueries)
+{
+	OutQueries.clear();
+	size_t Offset = 0;
+	std::string Line;
+	char Map[1024];
+	while (GridScenario::NextLine(Text, Offset, Line))
+	{
+		if (Line.empty() || (Line.compare(0, 7, "version") == 0))
+		{
+			continue;
+		}
+
+		FGridScenarioQuery Query;
+		if (sscanf(Line.c_str(), "%d %1023s %d %d %d %d %d %d %lf", &Query.Bucket, Map, &Query.MapWidth, &Query.MapHeight,
+			&Query.StartX, &Query.StartY, &Query.GoalX, &Query.GoalY, &Query.OptimalLength) != 9)
+		{
+			return false;
+		}
+		Query.Map = Map;
+		OutQueries.push_back(Query);
+	}
+	return true;
+}
+
+bool FGridScenario::ReadScenario(const char* Path, std::vector<FGridScenarioQuery>& OutQueries)
+{
+	std::string Text;
+	return GridScenario::ReadText(Path, Text) && ParseScenario(Text, OutQueries);
+}
+
+FGridScenarioReport FGridScenario::Run(const FGridGraph& Graph, const std::vector<FGridScenarioQuery>& Queries, const std::vector<EGridBenchmarkMode>& Modes)
+{
+	FGridScenarioReport Report;
+	auto Fail = [&Report](int32 Query, const char* Mode, int32 Cost, int32 ReferenceCost, const char* Reason)
+	{
+		Report.Failures.push_back(FGridScenarioFailure{ Query, Mode, Cost, ReferenceCost, Reason });
+	};
+
+	//Exact 4-connected costs every mode is held to, GridUnreachable for queries that don't hold up
+	std::vector<int32> ReferenceCosts(Queries.size(), GridUnreachable);
+	FGridBenchmarkSearcher Reference;
+	Reference.Init(Graph, EGridBenchmarkMode::DijkstraHeap);
+	FGridSearch OctileReference;
+	OctileReference.SetTopology(EGridTopology::Eight);
+	OctileReference.SetRecordVisitedOrder(false);
+	FGridSearchResult Result;
+	for (int32 i = 0; i < (int32)Queries.size(); i++)
+	{
+		const FGridScenarioQuery& Query = Queries[i];
+		if ((Query.MapWidth != Graph.GetWidth()) || (Query.MapHeight != Graph.GetHeight()))
+		{
+			Fail(i, "Reference", GridUnreachable, GridUnreachable, "query is for a map of another size");
+			continue;
+		}
+		if (!Graph.IsValidCoord(Query.StartX, Query.StartY) || !Graph.IsValidCoord(Query.GoalX, Query.GoalY)
+			|| Graph.IsWall(Graph.GetIndex(Query.StartX, Query.StartY)) || Graph.IsWall(Graph.GetIndex(Query.GoalX, Query.GoalY)))
+		{
+			Fail(i, "Reference", GridUnreachable, GridUnreachable, "start or goal is off the map or on a wall");
+			continue;
+		}
+
+		//Octile reachability without corner cutting is the same as 4-connected reachability
+		const int32 Start = Graph.GetIndex(Query.StartX, Query.StartY);
+		const int32 Goal = Graph.GetIndex(Query.GoalX, Query.GoalY);
+		Reference.Run(Start, Goal, Result);
+		if (!Result.bFound)
+		{
+			Fail(i, "Reference", GridUnreachable, GridUnreachable, "goal can't be reached");
+			continue;
+		}
+		const int32 ReferenceCost = Result.Cost;
+
+		//The 8-connected search answers the query the way it was published, so its length has to match
+		OctileReference.Run(Graph, Start, Goal, EGridSearchAlgorithm::AStar, Result);
+		const double Length = GridScenario::GetOctileLength(Graph, Result.Path);
+		if (std::abs(Length - Query.OptimalLength) > GridScenario::LengthTolerance + GridScenario::RelativeLengthTolerance * Query.OptimalLength)
+		{
+			Fail(i, "Reference", ReferenceCost, ReferenceCost, "octile length differs from the published optimum, the map or query was misread");
+		}
+		else
+		{
+			ReferenceCosts[i] = ReferenceCost;
+		}
+	}
+
+	std::map<std::pair<int32, int32>, FGridScenarioBucketStats> Buckets;
+	for (EGridBenchmarkMode Mode : Modes)
+	{
+		FGridBenchmarkSearcher Searcher;
+		if (!Searcher.Init(Graph, Mode))
+		{
+			continue;
+		}
+
+		const char* ModeName = GetBenchmarkModeName(Mode);
+		bool bWarm = false;
+		for (int32 i = 0; i < (int32)Queries.size(); i++)
+		{
+			const FGridScenarioQuery& Query = Queries[i];
+			const int32 ReferenceCost = ReferenceCosts[i];
+			if (ReferenceCost == GridUnreachable)
+			{
+				continue;
+			}
+
+			const int32 Start = Graph.GetIndex(Query.StartX, Query.StartY);
+			const int32 Goal = Graph.GetIndex(Query.GoalX, Query.GoalY);
+			if (!bWarm)
+			{
+				//One untimed run so buffer allocation isn't counted
+				Searcher.Run(Start, Goal, Result);
+				bWarm = true;
+			}
+
+			const auto StartTime = std::chrono::steady_clock::now();
+			Searcher.Run(Start, Goal, Result);
+			const std::chrono::duration<double, std::milli> Elapsed = std::chrono::steady_clock::now() - StartTime;
+
+			FGridScenarioBucketStats& Stats = Buckets[std::make_pair((int32)Mode, Query.Bucket)];
+			Stats.Map = Query.Map;
+			Stats.Mode = Mode;
+			Stats.Bucket = Query.Bucket;
+			Stats.NumQueries++;
+			Stats.TotalMilliseconds += Elapsed.count();
+			Stats.MaxMilliseconds = std::max(Stats.MaxMilliseconds, Elapsed.count());
+			Stats.NodesExpanded += Result.NodesExpanded;
+			Stats.TotalReferenceCost += ReferenceCost;
+
+			if (!Result.bFound)
+			{
+				Fail(i, ModeName, GridUnreachable, ReferenceCost, "no path found");
+				continue;
+			}
+			Stats.TotalCost += Result.Cost;
+
+			const char* PathError = GridScenario::CheckPath(Graph, Start, Goal, Result);
+			if (PathError[0] != '\0')
+			{
+				Fail(i, ModeName, Result.Cost, ReferenceCost, PathError);
+			}
+			else if (Result.Cost < ReferenceCost)
+			{
+				Fail(i, ModeName, Result.Cost, ReferenceCost, "cheaper than the reference");
+			}
+			else if (Result.Cost > ReferenceCost)
+			{
+				Stats.NumSuboptimal++;
+				if (FGridBenchmarkSearcher::IsExact(Mode))
+				{
+					Fail(i, ModeName, Result.Cost, ReferenceCost, "suboptimal path");
+				}
+			}
+		}
+	}
+
+	for (const auto& Bucket : Buckets)
+	{
+		Report.Buckets.push_back(Bucket.second);
+	}
+	return Report;
+}
+
+bool FGridScenario::WriteCsv(const char* Path, const FGridScenarioReport& Report)
+{
+	FILE* File = fopen(Path, "w");
+	if (File == nullptr)
+	{
+		return false;
+	}
+
+	fprintf(File, "map,mode,bucket,queries,total_milliseconds,mean_milliseconds,max_milliseconds,nodes_expanded,mean_nodes_expanded,suboptimal,cost_ratio\n");
+	for (const FGridScenarioBucketStats& Stats : Report.Buckets)
+	{
+		const double NumQueries = Stats.NumQueries > 0 ? Stats.NumQueries : 1;
+		fprintf(File, "%s,%s,%d,%d,%.6f,%.6f,%.6f,%" PRId64 ",%.1f,%d,%.6f\n", Stats.Map.c_str(), GetBenchmarkModeName(Stats.Mode), Stats.Bucket, Stats.NumQueries,
+			Stats.TotalMilliseconds, Stats.TotalMilliseconds / NumQueries, Stats.MaxMilliseconds, (int64_t)Stats.NodesExpanded,
+			Stats.NodesExpanded / NumQueries, Stats.NumSuboptimal, Stats.TotalReferenceCost > 0 ? (double)Stats.TotalCost / Stats.TotalReferenceCost : 1.0);
+	}
+	return fclose(File) == 0;
+}
@@ -0,0 +1,99 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "GridTypes.h"
+#include "GridBenchmark.h"
+#include <string>
+#include <vector>
+
+class FGridGraph;
+
+/** One query of a MovingAI .scen file */
+struct FGridScenarioQuery
+{
+	/** Published queries are grouped in buckets of similar optimal length */
+	int32 Bucket = 0;
+	std::string Map;
+	int32 MapWidth = 0;
+	int32 MapHeight = 0;
+	int32 StartX = 0;
+	int32 StartY = 0;
+	int32 GoalX = 0;
+	int32 GoalY = 0;
+
+	/** Published optimal length, for octile moves that don't cut corners */
+	double OptimalLength = 0.0;
+};
+
+/** Totals of one mode over one bucket */
+struct FGridScenarioBucketStats
+{
+	std::string Map;
+	EGridBenchmarkMode Mode = EGridBenchmarkMode::DijkstraHeap;
+	int32 Bucket = 0;
+	int32 NumQueries = 0;
+	double TotalMilliseconds = 0.0;
+	double MaxMilliseconds = 0.0;
+	int64 NodesExpanded = 0;
+
+	/** Costs summed over the bucket, the mode's and the reference search's */
+	int64 TotalCost = 0;
+	int64 TotalReferenceCost = 0;
+
+	/** Queries answered with a dearer path than the reference. Only HPA* may have any without failing */
+	int32 NumSuboptimal = 0;
+};
+
+/** A query some mode got wrong */
+struct FGridScenarioFailure
+{
+	/** Index into the queries passed to FGridScenario::Run */
+	int32 Query = 0;
+
+	/** Mode name, or "Reference" when the query itself doesn't hold up */
+	std::string Mode;
+	int32 Cost = GridUnreachable;
+	int32 ReferenceCost = GridUnreachable;
+	std::string Reason;
+};
+
+struct FGridScenarioReport
+{
+	/** Sorted by mode, then bucket */
+	std::vector<FGridScenarioBucketStats> Buckets;
+	std::vector<FGridScenarioFailure> Failures;
+};
+
+/**
+ * Importer and runner for the MovingAI grid benchmarks (movingai.com/benchmarks). Maps become graphs with uniform cost
+ * 1: '.', 'G' and 'S' are open, '@', 'O', 'T' and 'W' are walls, so water only joins water in the originals and is
+ * left out here. Scenario coordinates are x = column, y = row from the top, the same as GetIndex.
+ * The published lengths are for 8-connected octile moves. The runner checks each against an 8-connected FGridSearch to
+ * catch a bad import, and holds every mode, all 4-connected, to an exact 4-connected Dijkstra.
+ */
+class FGridScenario
+{
+public:
+	/** Fill OutGraph from the text of a .map file. Returns false on a malformed header or missing rows */
+	static bool ParseMap(const std::string& Text, FGridGraph& OutGraph);
+
+	/** Read and parse a .map file */
+	static bool ReadMap(const char* Path, FGridGraph& OutGraph);
+
+	/** Parse the text of a .scen file, version 1 or the older unversioned kind */
+	static bool ParseScenario(const std::string& Text, std::vector<FGridScenarioQuery>& OutQueries);
+
+	/** Read and parse a .scen file */
+	static bool ReadScenario(const char* Path, std::vector<FGridScenarioQuery>& OutQueries);
+
+	/**
+	 * Answer every query on Graph with every mode, timing each search once, and check each path against the reference.
+	 * Modes that can't run on Graph's costs are skipped. A wrong cost from an exact mode, a missing or broken path, or a
+	 * query whose cells or published length don't fit Graph is a failure
+	 */
+	static FGridScenarioReport Run(const FGridGraph& Graph, const std::vector<FGridScenarioQuery>& Queries, const std::vector<EGridBenchmarkMode>& Modes);
+
+	/** Write the bucket statistics as CSV with a header row. Returns false if the file can't be written */
+	static bool WriteCsv(const char* Path, const FGridScenarioReport& Report);
+};
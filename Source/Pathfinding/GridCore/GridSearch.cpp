@@ -0,0 +1,389 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "GridSearch.h"
+#include "GridGraph.h"
+#include "GridMemory.h"
+#include <algorithm>
+
+void FGridSearchResult::Reset()
+{
+	bFound = false;
+	Cost = GridUnreachable;
+	NodesExpanded = 0;
+	PeakOpenListSize = 0;
+	bCancelled = false;
+	bTooLarge = false;
+	VisitedOrder.clear();
+	VisitedFromGoal.clear();
+	Path.clear();
+}
+
+bool FGridSearch::Run(const FGridGraph& Graph, EGridSearchAlgorithm Algorithm, FGridSearchResult& OutResult, EGridOpenList OpenListType)
+{
+	return Run(Graph, Graph.GetStart(), Graph.GetGoal(), Algorithm, OutResult, OpenListType);
+}
+
+bool FGridSearch::Run(const FGridGraph& Graph, int32 Start, int32 Goal, EGridSearchAlgorithm Algorithm, FGridSearchResult& OutResult, EGridOpenList OpenListType)
+{
+	if (Algorithm == EGridSearchAlgorithm::JumpPoint)
+	{
+		return RunJumpPoint(Graph, Start, Goal, nullptr, OutResult);
+	}
+
+	OutResult.Reset();
+	Prepare(Graph);
+
+	if (!Graph.IsValidIndex(Start) || !Graph.IsValidIndex(Goal) || Graph.IsWall(Start) || Graph.IsWall(Goal))
+	{
+		return false;
+	}
+
+	//Dijkstra is A* with a zero heuristic
+	const bool bUseHeuristic = (Algorithm == EGridSearchAlgorithm::AStar) || (Algorithm == EGridSearchAlgorithm::BidirectionalAStar);
+	const int32 HeuristicScale = bUseHeuristic ? Graph.GetMinCost() : 0;
+
+	const bool bBidirectional = (Algorithm == EGridSearchAlgorithm::BidirectionalDijkstra) || (Algorithm == EGridSearchAlgorithm::BidirectionalAStar);
+
+	//The only runtime dispatch on the topology, once per search
+	switch (Topology)
+	{
+	case EGridTopology::Eight:
+		return RunTopology<FGridTopology8>(Graph, Start, Goal, HeuristicScale, bBidirectional, OpenListType, OutResult);
+	case EGridTopology::Hex:
+		return RunTopology<FGridTopologyHex>(Graph, Start, Goal, HeuristicScale, bBidirectional, OpenListType, OutResult);
+	default:
+		return RunTopology<FGridTopology4>(Graph, Start, Goal, HeuristicScale, bBidirectional, OpenListType, OutResult);
+	}
+}
+
+template <typename TopologyType>
+bool FGridSearch::FitsDistances(const FGridGraph& Graph, bool bBidirectional)
+{
+	//A shortest path enters a cell at most once and the heuristic adds less than one more crossing of the board.
+	//Bidirectional keys are twice a distance plus a heuristic difference
+	const int64 MaxDistance = (int64)(Graph.Num() + Graph.GetWidth() + Graph.GetHeight()) * Graph.GetMaxCost() * TopologyType::MaxStepWeight;
+	return (bBidirectional ? 2 * MaxDistance : MaxDistance) < GridUnreachable;
+}
+
+template <typename TopologyType>
+bool FGridSearch::RunTopology(const FGridGraph& Graph, int32 Start, int32 Goal, int32 HeuristicScale, bool bBidirectional, EGridOpenList OpenListType, FGridSearchResult& OutResult)
+{
+	//Refused rather than risking a wrapped distance, which would give a wrong path without any sign of it
+	if (!FitsDistances<TopologyType>(Graph, bBidirectional))
+	{
+		OutResult.bTooLarge = true;
+		return false;
+	}
+
+	if (bBidirectional)
+	{
+		return RunBidirectional<TopologyType>(Graph, Start, Goal, HeuristicScale, OpenListType, OutResult);
+	}
+
+	if (OpenListType == EGridOpenList::Buckets)
+	{
+		//One step changes g by at most MaxCost and the heuristic by at most HeuristicScale, both times the heaviest step
+		Buckets.Reset(Graph.Num(), (Graph.GetMaxCost() + HeuristicScale) * TopologyType::MaxStepWeight);
+		return Expand<TopologyType>(Graph, Start, Goal, HeuristicScale, Buckets, OutResult);
+	}
+
+	Heap.Reset(Graph.Num());
+	return Expand<TopologyType>(Graph, Start, Goal, HeuristicScale, Heap, OutResult);
+}
+
+template <typename TopologyType, typename OpenListType>
+bool FGridSearch::Expand(const FGridGraph& Graph, int32 Start, int32 Goal, int32 HeuristicScale, OpenListType& OpenList, FGridSearchResult& OutResult)
+{
+	SetDistance(Start, 0);
+	OpenList.Push(Start, TopologyType::GetDistance(Graph, Start, Goal) * HeuristicScale);
+
+	while (!OpenList.IsEmpty())
+	{
+		if (ShouldCancel(OutResult))
+		{
+			return false;
+		}
+
+		OutResult.PeakOpenListSize = std::max(OutResult.PeakOpenListSize, OpenList.Num());
+		const int32 Current = OpenList.Pop();
+		Closed[Current] = 1;
+		OutResult.NodesExpanded++;
+		if (bRecordVisitedOrder)
+		{
+			OutResult.VisitedOrder.push_back(Current);
+		}
+
+		if (Current == Goal)
+		{
+			BuildPath(Goal, OutResult);
+			return true;
+		}
+
+		const int32 CurrentDistance = Distance[Current];
+		TopologyType::ForEachNeighbor(Graph, Current, [&](int32 Neighbor, int32 Weight)
+		{
+			const int32 NewDistance = CurrentDistance + Graph.GetCost(Neighbor) * Weight;
+			if (!Closed[Neighbor] && NewDistance < Distance[Neighbor])
+			{
+				SetDistance(Neighbor, NewDistance);
+				Parent[Neighbor] = Current;
+				OpenList.Push(Neighbor, NewDistance + TopologyType::GetDistance(Graph, Neighbor, Goal) * HeuristicScale);
+			}
+		});
+	}
+
+	//Open list ran dry, everything left is unreachable
+	return false;
+}
+
+template <typename TopologyType>
+bool FGridSearch::RunBidirectional(const FGridGraph& Graph, int32 Start, int32 Goal, int32 HeuristicScale, EGridOpenList OpenListType, FGridSearchResult& OutResult)
+{
+	//Prepare left the backward buffers clean if they already had the right size
+	if (DistanceBack.size() != Distance.size())
+	{
+		DistanceBack.assign(Graph.Num(), GridUnreachable);
+		ParentBack.assign(Graph.Num(), GridInvalidIndex);
+		ClosedBack.assign(Graph.Num(), 0);
+	}
+	bHasBackward = true;
+
+	if (OpenListType == EGridOpenList::Buckets)
+	{
+		//Keys are doubled (see ExpandBidirectional), so one step moves them by at most twice the single direction spread
+		const int32 MaxSpread = 2 * (Graph.GetMaxCost() + HeuristicScale) * TopologyType::MaxStepWeight;
+		Buckets.Reset(Graph.Num(), MaxSpread);
+		BucketsBack.Reset(Graph.Num(), MaxSpread);
+		return ExpandBidirectional<TopologyType>(Graph, Start, Goal, HeuristicScale, Buckets, BucketsBack, OutResult);
+	}
+
+	Heap.Reset(Graph.Num());
+	HeapBack.Reset(Graph.Num());
+	return ExpandBidirectional<TopologyType>(Graph, Start, Goal, HeuristicScale, Heap, HeapBack, OutResult);
+}
+
+template <typename TopologyType, typename OpenListType>
+bool FGridSearch::ExpandBidirectional(const FGridGraph& Graph, int32 Start, int32 Goal, int32 HeuristicScale, OpenListType& Forward, OpenListType& Backward, FGridSearchResult& OutResult)
+{
+	//Each side uses half the difference of the two heuristics as its potential, the forward side +P and the backward side -P.
+	//That keeps the reduced step costs non-negative on both sides, so the plain bidirectional Dijkstra stopping rule holds.
+	//Keys are doubled to keep P whole: forward 2 * g + P, backward 2 * g - P
+	auto Potential = [&Graph, Start, Goal, HeuristicScale](int32 Index)
+	{
+		return (TopologyType::GetDistance(Graph, Index, Goal) - TopologyType::GetDistance(Graph, Index, Start)) * HeuristicScale;
+	};
+
+	//Shortest start to goal cost seen so far and the cell where the two searches met on it
+	int32 Best = GridUnreachable;
+	int32 Meeting = GridInvalidIndex;
+	if (Start == Goal)
+	{
+		Best = 0;
+		Meeting = Start;
+	}
+
+	SetDistance(Start, 0);
+	SetDistanceBack(Goal, 0);
+	Forward.Push(Start, Potential(Start));
+	Backward.Push(Goal, -Potential(Goal));
+
+	while (!Forward.IsEmpty() && !Backward.IsEmpty())
+	{
+		//Any path not found yet costs at least half the sum of the two smallest keys
+		if ((int64)Forward.TopKey() + Backward.TopKey() >= 2 * (int64)Best)
+		{
+			break;
+		}
+
+		if (ShouldCancel(OutResult))
+		{
+			return false;
+		}
+
+		//Grow the smaller frontier, it is the cheaper one to expand
+		OutResult.PeakOpenListSize = std::max(OutResult.PeakOpenListSize, Forward.Num() + Backward.Num());
+		const bool bExpandForward = Forward.Num() <= Backward.Num();
+		const int32 Current = bExpandForward ? Forward.Pop() : Backward.Pop();
+		OutResult.NodesExpanded++;
+		if (bRecordVisitedOrder)
+		{
+			OutResult.VisitedOrder.push_back(Current);
+			OutResult.VisitedFromGoal.push_back(bExpandForward ? 0 : 1);
+		}
+
+		if (bExpandForward)
+		{
+			Closed[Current] = 1;
+			TopologyType::ForEachNeighbor(Graph, Current, [&](int32 Neighbor, int32 Weight)
+			{
+				const int32 NewDistance = Distance[Current] + Graph.GetCost(Neighbor) * Weight;
+				if (!Closed[Neighbor] && NewDistance < Distance[Neighbor])
+				{
+					SetDistance(Neighbor, NewDistance);
+					Parent[Neighbor] = Current;
+					Forward.Push(Neighbor, 2 * NewDistance + Potential(Neighbor));
+				}
+
+				if ((DistanceBack[Neighbor] != GridUnreachable) && (NewDistance + DistanceBack[Neighbor] < Best))
+				{
+					Best = NewDistance + DistanceBack[Neighbor];
+					Meeting = Neighbor;
+				}
+			});
+		}
+		else
+		{
+			//Walking backwards from Neighbor onto Current costs Current's cost, steps weigh the same both ways
+			ClosedBack[Current] = 1;
+			TopologyType::ForEachNeighbor(Graph, Current, [&](int32 Neighbor, int32 Weight)
+			{
+				const int32 NewDistance = DistanceBack[Current] + Graph.GetCost(Current) * Weight;
+				if (!ClosedBack[Neighbor] && NewDistance < DistanceBack[Neighbor])
+				{
+					SetDistanceBack(Neighbor, NewDistance);
+					ParentBack[Neighbor] = Current;
+					Backward.Push(Neighbor, 2 * NewDistance - Potential(Neighbor));
+				}
+
+				if ((Distance[Neighbor] != GridUnreachable) && (Distance[Neighbor] + NewDistance < Best))
+				{
+					Best = Distance[Neighbor] + NewDistance;
+					Meeting = Neighbor;
+				}
+			});
+		}
+	}
+
+	if (Meeting == GridInvalidIndex)
+	{
+		return false;
+	}
+
+	BuildBidirectionalPath(Meeting, Best, OutResult);
+	return true;
+}
+
+int32 FGridSearch::GetHeuristic(const FGridGraph& Graph, int32 Index, int32 Goal)
+{
+	return Graph.GetManhattanDistance(Index, Goal) * Graph.GetMinCost();
+}
+
+void FGridSearch::Prepare(const FGridGraph& Graph)
+{
+	const size_t NumCells = Graph.Num();
+	bHasBackward = false;
+
+	//Undo only what the last search wrote, unless it touched so much that refilling is cheaper
+	if ((Distance.size() == NumCells) && (Touched.size() < NumCells / 8))
+	{
+		for (int32 Index : Touched)
+		{
+			Distance[Index] = GridUnreachable;
+			Parent[Index] = GridInvalidIndex;
+			Closed[Index] = 0;
+		}
+
+		if (DistanceBack.size() == NumCells)
+		{
+			for (int32 Index : Touched)
+			{
+				DistanceBack[Index] = GridUnreachable;
+				ParentBack[Index] = GridInvalidIndex;
+				ClosedBack[Index] = 0;
+			}
+		}
+	}
+	else
+	{
+		Distance.assign(NumCells, GridUnreachable);
+		Parent.assign(NumCells, GridInvalidIndex);
+		Closed.assign(NumCells, 0);
+
+		//Only bidirectional runs use these, they are refilled on demand
+		DistanceBack.clear();
+		ParentBack.clear();
+		ClosedBack.clear();
+	}
+	Touched.clear();
+}
+
+void FGridSearch::BuildPath(int32 Goal, FGridSearchResult& OutResult) const
+{
+	OutResult.bFound = true;
+	OutResult.Cost = Distance[Goal];
+
+	for (int32 Index = Goal; Index != GridInvalidIndex; Index = Parent[Index])
+	{
+		OutResult.Path.push_back(Index);
+	}
+	std::reverse(OutResult.Path.begin(), OutResult.Path.end());
+}
+
+void FGridSearch::BuildBidirectionalPath(int32 Meeting, int32 Cost, FGridSearchResult& OutResult) const
+{
+	OutResult.bFound = true;
+	OutResult.Cost = Cost;
+
+	for (int32 Index = Meeting; Index != GridInvalidIndex; Index = Parent[Index])
+	{
+		OutResult.Path.push_back(Index);
+	}
+	std::reverse(OutResult.Path.begin(), OutResult.Path.end());
+
+	for (int32 Index = ParentBack[Meeting]; Index != GridInvalidIndex; Index = ParentBack[Index])
+	{
+		OutResult.Path.push_back(Index);
+	}
+}
+
+int64 FGridSearch::GetAllocatedBytes() const
+{
+	return GridMemory::GetAllocatedBytes(Distance) + GridMemory::GetAllocatedBytes(Parent) + GridMemory::GetAllocatedBytes(Closed)
+		+ GridMemory::GetAllocatedBytes(DistanceBack) + GridMemory::GetAllocatedBytes(ParentBack) + GridMemory::GetAllocatedBytes(ClosedBack)
+		+ GridMemory::GetAllocatedBytes(Touched) + Heap.GetAllocatedBytes() + Buckets.GetAllocatedBytes()
+		+ HeapBack.GetAllocatedBytes() + BucketsBack.GetAllocatedBytes();
+}
+
+const char* GetAlgorithmName(EGridSearchAlgorithm Algorithm)
+{
+	switch (Algorithm)
+	{
+	case EGridSearchAlgorithm::Dijkstra:
+		return "Dijkstra";
+	case EGridSearchAlgorithm::AStar:
+		return "AStar";
+	case EGridSearchAlgorithm::JumpPoint:
+		return "JumpPoint";
+	case EGridSearchAlgorithm::BidirectionalDijkstra:
+		return "BidirectionalDijkstra";
+	case EGridSearchAlgorithm::BidirectionalAStar:
+		return "BidirectionalAStar";
+	}
+	return "Unknown";
+}
+
+const char* GetOpenListName(EGridOpenList OpenList)
+{
+	switch (OpenList)
+	{
+	case EGridOpenList::Heap:
+		return "Heap";
+	case EGridOpenList::Buckets:
+		return "Buckets";
+	}
+	return "Unknown";
+}
+
+const char* GetTopologyName(EGridTopology Topology)
+{
+	switch (Topology)
+	{
+	case EGridTopology::Four:
+		return "Four";
+	case EGridTopology::Eight:
+		return "Eight";
+	case EGridTopology::Hex:
+		return "Hex";
+	}
+	return "Unknown";
+}
@@ -0,0 +1,212 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "GridTypes.h"
+#include "IndexedHeap.h"
+#include "BucketQueue.h"
+#include "GridTopology.h"
+#include <atomic>
+#include <vector>
+
+class FGridGraph;
+class FJumpPointTable;
+
+enum class EGridSearchAlgorithm : uint8
+{
+	Dijkstra,
+	AStar,
+	/** Jump Point Search, uniform costs only (falls back to A*) */
+	JumpPoint,
+	/** Dijkstra from the start and the goal at the same time */
+	BidirectionalDijkstra,
+	/** A* from both ends with averaged heuristics so the two frontiers stay consistent */
+	BidirectionalAStar,
+};
+
+/** Priority queue used for the open list */
+enum class EGridOpenList : uint8
+{
+	/** Indexed 4-ary heap, works for any costs */
+	Heap,
+	/** Dial's bucket queue, O(1) push/pop for the small integer costs the grid uses */
+	Buckets,
+};
+
+const char* GetAlgorithmName(EGridSearchAlgorithm Algorithm);
+const char* GetOpenListName(EGridOpenList OpenList);
+const char* GetTopologyName(EGridTopology Topology);
+
+/** Output of a single search */
+struct FGridSearchResult
+{
+	/** Did the search reach the goal */
+	bool bFound = false;
+
+	/** Path cost from start to goal, GridUnreachable if there is no path */
+	int32 Cost = GridUnreachable;
+
+	/** Number of cells taken off the open list */
+	int32 NodesExpanded = 0;
+
+	/** Most cells the open list held at once, both directions together for bidirectional searches */
+	int32 PeakOpenListSize = 0;
+
+	/** The search was stopped through its cancel flag before it finished */
+	bool bCancelled = false;
+
+	/** Nothing was searched, a path on this board could overflow the int32 distances of the topology (see FGridSearch::SetTopology) */
+	bool bTooLarge = false;
+
+	/** Cells in the order they were visited, start first */
+	std::vector<int32> VisitedOrder;
+
+	/** Parallel to VisitedOrder for bidirectional searches, 1 where the backward search visited the cell. Empty otherwise */
+	std::vector<uint8> VisitedFromGoal;
+
+	/** Cells on the shortest path, start first and goal last */
+	std::vector<int32> Path;
+
+	void Reset();
+};
+
+/**
+ * Runs searches over an FGridGraph.
+ * The per-cell distance and parent buffers stay valid after Run so callers can read them back, and are reused by the next run.
+ */
+class FGridSearch
+{
+public:
+	/** Search from the graph's start to its goal */
+	bool Run(const FGridGraph& Graph, EGridSearchAlgorithm Algorithm, FGridSearchResult& OutResult, EGridOpenList OpenListType = EGridOpenList::Heap);
+
+	/** Search between two explicit cells */
+	bool Run(const FGridGraph& Graph, int32 Start, int32 Goal, EGridSearchAlgorithm Algorithm, FGridSearchResult& OutResult, EGridOpenList OpenListType = EGridOpenList::Heap);
+
+	/**
+	 * Jump Point Search between two cells. With a built table this is JPS+, otherwise jumps are scanned cell by cell.
+	 * Needs every cell to cost the same, otherwise it runs A* instead.
+	 */
+	bool RunJumpPoint(const FGridGraph& Graph, int32 Start, int32 Goal, const FJumpPointTable* Table, FGridSearchResult& OutResult);
+
+	/** Distance from the start of the last search, GridUnreachable if the cell was never reached */
+	int32 GetDistance(int32 Index) const { return Distance[Index]; }
+
+	/** Cell we came from in the last search, GridInvalidIndex for the start or unreached cells */
+	int32 GetParent(int32 Index) const { return Parent[Index]; }
+
+	/** Distance to the goal found by the backward half of the last bidirectional search, GridUnreachable otherwise */
+	int32 GetDistanceFromGoal(int32 Index) const { return bHasBackward ? DistanceBack[Index] : GridUnreachable; }
+
+	/** Batch callers that only want paths can skip filling VisitedOrder */
+	void SetRecordVisitedOrder(bool bRecord) { bRecordVisitedOrder = bRecord; }
+
+	/**
+	 * Neighbors the Dijkstra, A* and bidirectional searches step to, 4-connected by default. Jump Point Search only runs
+	 * 4-connected and becomes A* otherwise. 8-connected costs are in 408ths of an orthogonal step, so distances run out
+	 * of int32 far sooner: a search refuses a board whose longest possible path could overflow them and sets bTooLarge,
+	 * e.g. above about 1.8 million cells at cost 1 or 14 thousand at cost 127 for the bidirectional searches
+	 */
+	void SetTopology(EGridTopology InTopology) { Topology = InTopology; }
+	EGridTopology GetTopology() const { return Topology; }
+
+	/** Searches poll this flag while they run and give up once it is set. Null (the default) never cancels */
+	void SetCancelFlag(const std::atomic<bool>* InCancelFlag) { CancelFlag = InCancelFlag; }
+
+	/** Heap bytes held by the per-cell buffers and open lists */
+	int64 GetAllocatedBytes() const;
+
+	/** Admissible estimate of the remaining cost from Index to Goal */
+	static int32 GetHeuristic(const FGridGraph& Graph, int32 Index, int32 Goal);
+
+private:
+	/** Reset the buffers for a search on Graph, in time proportional to what the last search touched */
+	void Prepare(const FGridGraph& Graph);
+
+	/** Every write to Distance goes through here so Prepare knows which cells to reset */
+	void SetDistance(int32 Index, int32 NewDistance)
+	{
+		if (Distance[Index] == GridUnreachable)
+		{
+			Touched.push_back(Index);
+		}
+		Distance[Index] = NewDistance;
+	}
+
+	void SetDistanceBack(int32 Index, int32 NewDistance)
+	{
+		if (DistanceBack[Index] == GridUnreachable)
+		{
+			Touched.push_back(Index);
+		}
+		DistanceBack[Index] = NewDistance;
+	}
+
+	/** Checked every CancelCheckInterval expansions so the atomic load stays off the hot path */
+	bool ShouldCancel(FGridSearchResult& OutResult) const
+	{
+		if ((CancelFlag != nullptr) && ((OutResult.NodesExpanded & (CancelCheckInterval - 1)) == 0) && CancelFlag->load(std::memory_order_relaxed))
+		{
+			OutResult.bCancelled = true;
+			return true;
+		}
+		return false;
+	}
+
+	enum : int32
+	{
+		CancelCheckInterval = 1024
+	};
+
+	/** Can every distance and open list key of a search on Graph be held in an int32, even for a path through every cell */
+	template <typename TopologyType>
+	static bool FitsDistances(const FGridGraph& Graph, bool bBidirectional);
+
+	/** Run compiled for one topology, every loop below it resolves neighbors and heuristics at compile time */
+	template <typename TopologyType>
+	bool RunTopology(const FGridGraph& Graph, int32 Start, int32 Goal, int32 HeuristicScale, bool bBidirectional, EGridOpenList OpenListType, FGridSearchResult& OutResult);
+
+	template <typename TopologyType, typename OpenListType>
+	bool Expand(const FGridGraph& Graph, int32 Start, int32 Goal, int32 HeuristicScale, OpenListType& OpenList, FGridSearchResult& OutResult);
+
+	void BuildPath(int32 Goal, FGridSearchResult& OutResult) const;
+
+	template <typename TopologyType>
+	bool RunBidirectional(const FGridGraph& Graph, int32 Start, int32 Goal, int32 HeuristicScale, EGridOpenList OpenListType, FGridSearchResult& OutResult);
+
+	template <typename TopologyType, typename OpenListType>
+	bool ExpandBidirectional(const FGridGraph& Graph, int32 Start, int32 Goal, int32 HeuristicScale, OpenListType& Forward, OpenListType& Backward, FGridSearchResult& OutResult);
+
+	/** Join the forward parents up to Meeting with the backward parents from Meeting to the goal */
+	void BuildBidirectionalPath(int32 Meeting, int32 Cost, FGridSearchResult& OutResult) const;
+
+	/** Expand jump point parent links into every cell along the path */
+	void BuildJumpPath(const FGridGraph& Graph, int32 Goal, int32 StepCost, FGridSearchResult& OutResult);
+
+	std::vector<int32> Distance;
+	std::vector<int32> Parent;
+	std::vector<uint8> Closed;
+
+	/** Backward search buffers, DistanceBack is the cost from a cell to the goal and ParentBack the next cell towards it */
+	std::vector<int32> DistanceBack;
+	std::vector<int32> ParentBack;
+	std::vector<uint8> ClosedBack;
+
+	/** Cells the current search wrote to, in either direction */
+	std::vector<int32> Touched;
+
+	/** Was the last search bidirectional, i.e. is DistanceBack meaningful */
+	bool bHasBackward = false;
+	bool bRecordVisitedOrder = true;
+	EGridTopology Topology = EGridTopology::Four;
+
+	/** Discovered cells keyed on distance (Dijkstra) or distance + heuristic (A*) */
+	TIndexedHeap<int32> Heap;
+	FBucketQueue Buckets;
+
+	/** Open lists of the backward search */
+	TIndexedHeap<int32> HeapBack;
+	FBucketQueue BucketsBack;
+
+	const std::atomic<bool>* CancelFlag = nullptr;
+};
@@ -0,0 +1,163 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "GridTypes.h"
+#include "GridGraph.h"
+#include <algorithm>
+#include <cstdlib>
+
+/** How cells connect in FGridSearch's Dijkstra and A* searches */
+enum class EGridTopology : uint8
+{
+	/** Orthogonal steps only, what every other search and structure in GridCore assumes */
+	Four,
+	/** Orthogonal and diagonal steps at octile weights. A diagonal needs both cells it passes between open, so it never cuts a corner */
+	Eight,
+	/** Six neighbors in axial coordinates, X is q and Y is r, so the stored rectangle is a rhombus of hexes */
+	Hex,
+};
+
+/**
+ * Topology policies the search kernels are compiled for, so neighbor offsets, step weights and the heuristic inline
+ * into the expansion loop. ForEachNeighbor calls Visit(Neighbor, Weight) for every open neighbor of Index, and stepping
+ * onto a cell costs the cell's cost times the step's weight. GetDistance is the cost of the cheapest path over open
+ * ground of cost 1, so it times the graph's smallest cost is a consistent heuristic.
+ */
+struct FGridTopology4
+{
+	enum : int32
+	{
+		/** Heaviest step, so one step moves a distance by at most MaxCost * MaxStepWeight */
+		MaxStepWeight = 1
+	};
+
+	template <typename VisitorType>
+	static void ForEachNeighbor(const FGridGraph& Graph, int32 Index, VisitorType&& Visit)
+	{
+		const int32 Width = Graph.GetWidth();
+		const int32 X = Graph.GetX(Index);
+		const int32 Y = Graph.GetY(Index);
+
+		//Same order as FGridGraph::GetNeighbors: +Y row, -Y row, -X column, +X column
+		if ((Y + 1 < Graph.GetHeight()) && Graph.IsWalkable(Index + Width))
+		{
+			Visit(Index + Width, 1);
+		}
+		if ((Y > 0) && Graph.IsWalkable(Index - Width))
+		{
+			Visit(Index - Width, 1);
+		}
+		if ((X > 0) && Graph.IsWalkable(Index - 1))
+		{
+			Visit(Index - 1, 1);
+		}
+		if ((X + 1 < Width) && Graph.IsWalkable(Index + 1))
+		{
+			Visit(Index + 1, 1);
+		}
+	}
+
+	static int32 GetDistance(const FGridGraph& Graph, int32 A, int32 B)
+	{
+		return Graph.GetManhattanDistance(A, B);
+	}
+};
+
+struct FGridTopology8
+{
+	enum : int32
+	{
+		/** 577 / 408 is within 2e-6 of sqrt(2), so costs are octile lengths in 408ths of an orthogonal step */
+		OrthogonalWeight = 408,
+		DiagonalWeight = 577,
+		MaxStepWeight = DiagonalWeight
+	};
+
+	template <typename VisitorType>
+	static void ForEachNeighbor(const FGridGraph& Graph, int32 Index, VisitorType&& Visit)
+	{
+		const int32 Width = Graph.GetWidth();
+		const int32 X = Graph.GetX(Index);
+		const int32 Y = Graph.GetY(Index);
+		const bool bUp = (Y + 1 < Graph.GetHeight()) && Graph.IsWalkable(Index + Width);
+		const bool bDown = (Y > 0) && Graph.IsWalkable(Index - Width);
+		const bool bLeft = (X > 0) && Graph.IsWalkable(Index - 1);
+		const bool bRight = (X + 1 < Width) && Graph.IsWalkable(Index + 1);
+
+		//Orthogonal steps first, in FGridGraph::GetNeighbors' order, then the diagonals both of whose sides are open
+		if (bUp)
+		{
+			Visit(Index + Width, OrthogonalWeight);
+		}
+		if (bDown)
+		{
+			Visit(Index - Width, OrthogonalWeight);
+		}
+		if (bLeft)
+		{
+			Visit(Index - 1, OrthogonalWeight);
+		}
+		if (bRight)
+		{
+			Visit(Index + 1, OrthogonalWeight);
+		}
+		if (bUp && bRight && Graph.IsWalkable(Index + Width + 1))
+		{
+			Visit(Index + Width + 1, DiagonalWeight);
+		}
+		if (bUp && bLeft && Graph.IsWalkable(Index + Width - 1))
+		{
+			Visit(Index + Width - 1, DiagonalWeight);
+		}
+		if (bDown && bRight && Graph.IsWalkable(Index - Width + 1))
+		{
+			Visit(Index - Width + 1, DiagonalWeight);
+		}
+		if (bDown && bLeft && Graph.IsWalkable(Index - Width - 1))
+		{
+			Visit(Index - Width - 1, DiagonalWeight);
+		}
+	}
+
+	static int32 GetDistance(const FGridGraph& Graph, int32 A, int32 B)
+	{
+		const int32 DeltaX = std::abs(Graph.GetX(A) - Graph.GetX(B));
+		const int32 DeltaY = std::abs(Graph.GetY(A) - Graph.GetY(B));
+		return OrthogonalWeight * std::max(DeltaX, DeltaY) + (DiagonalWeight - OrthogonalWeight) * std::min(DeltaX, DeltaY);
+	}
+};
+
+struct FGridTopologyHex
+{
+	enum : int32
+	{
+		MaxStepWeight = 1
+	};
+
+	template <typename VisitorType>
+	static void ForEachNeighbor(const FGridGraph& Graph, int32 Index, VisitorType&& Visit)
+	{
+		//The four square neighbors plus (+q, -r) and (-q, +r). Hexes share an edge, so there are no corners to cut
+		FGridTopology4::ForEachNeighbor(Graph, Index, Visit);
+
+		const int32 Width = Graph.GetWidth();
+		const int32 X = Graph.GetX(Index);
+		const int32 Y = Graph.GetY(Index);
+		if ((Y > 0) && (X + 1 < Width) && Graph.IsWalkable(Index - Width + 1))
+		{
+			Visit(Index - Width + 1, 1);
+		}
+		if ((Y + 1 < Graph.GetHeight()) && (X > 0) && Graph.IsWalkable(Index + Width - 1))
+		{
+			Visit(Index + Width - 1, 1);
+		}
+	}
+
+	static int32 GetDistance(const FGridGraph& Graph, int32 A, int32 B)
+	{
+		const int32 DeltaQ = Graph.GetX(B) - Graph.GetX(A);
+		const int32 DeltaR = Graph.GetY(B) - Graph.GetY(A);
+		return (std::abs(DeltaQ) + std::abs(DeltaR) + std::abs(DeltaQ + DeltaR)) / 2;
+	}
+};
@@ -0,0 +1,23 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+/**
+ * Fixed width integer types for the engine-independent grid code.
+ * These match the engine's own typedefs exactly, so the same headers compile inside the
+ * game module and in a plain C++ build without pulling in CoreMinimal.
+ */
+typedef signed char int8;
+typedef unsigned char uint8;
+typedef signed short int int16;
+typedef unsigned short int uint16;
+typedef signed int int32;
+typedef unsigned int uint32;
+typedef signed long long int64;
+typedef unsigned long long uint64;
+
+/** Index used for "no cell" (no start, no goal, no parent) */
+static constexpr int32 GridInvalidIndex = -1;
+
+/** Distance of a cell that has not been reached */
+static constexpr int32 GridUnreachable = 0x7fffffff;
@@ -0,0 +1,508 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "HierarchicalSearch.h"
+#include "GridGraph.h"
+#include "GridSearch.h"
+#include <algorithm>
+#include <cstdlib>
+
+void FGridHierarchy::Build(const FGridGraph& Graph, int32 InClusterSize)
+{
+	//Node indices are stored as int16, so a cluster can't have more than 32767 border cells
+	ClusterSize = std::min(std::max(InClusterSize, 2), 8191);
+	Width = Graph.GetWidth();
+	Height = Graph.GetHeight();
+	ClustersX = (Width + ClusterSize - 1) / ClusterSize;
+	ClustersY = (Height + ClusterSize - 1) / ClusterSize;
+
+	//Each border cell can be a node at most once
+	MaxNodesPerCluster = 4 * ClusterSize;
+
+	Clusters.assign(ClustersX * ClustersY, FCluster());
+	for (int32 ClusterY = 0; ClusterY < ClustersY; ClusterY++)
+	{
+		for (int32 ClusterX = 0; ClusterX < ClustersX; ClusterX++)
+		{
+			FCluster& Cluster = Clusters[ClusterY * ClustersX + ClusterX];
+			Cluster.MinX = ClusterX * ClusterSize;
+			Cluster.MinY = ClusterY * ClusterSize;
+			Cluster.SizeX = std::min(ClusterSize, Width - Cluster.MinX);
+			Cluster.SizeY = std::min(ClusterSize, Height - Cluster.MinY);
+		}
+	}
+
+	CellToLocal.assign(Graph.Num(), -1);
+	DirtyClusters.clear();
+
+	const int32 NumIds = (int32)Clusters.size() * MaxNodesPerCluster + 2;
+	AbstractNodes.assign(NumIds, FAbstractNode());
+	CurrentStamp = 0;
+	AbstractHeap.Reset(NumIds);
+
+	for (int32 Cluster = 0; Cluster < (int32)Clusters.size(); Cluster++)
+	{
+		RebuildCluster(Graph, Cluster);
+	}
+	bBuilt = true;
+}
+
+void FGridHierarchy::OnCellChanged(int32 Index)
+{
+	if (!bBuilt || (Index < 0) || (Index >= Width * Height))
+	{
+		return;
+	}
+
+	const int32 X = Index % Width;
+	const int32 Y = Index / Width;
+	MarkDirty(GetClusterOf(X, Y));
+
+	//A border cell also decides the transitions the cluster on the other side sees
+	if ((X % ClusterSize == 0) && (X > 0))
+	{
+		MarkDirty(GetClusterOf(X - 1, Y));
+	}
+	if ((X % ClusterSize == ClusterSize - 1) && (X + 1 < Width))
+	{
+		MarkDirty(GetClusterOf(X + 1, Y));
+	}
+	if ((Y % ClusterSize == 0) && (Y > 0))
+	{
+		MarkDirty(GetClusterOf(X, Y - 1));
+	}
+	if ((Y % ClusterSize == ClusterSize - 1) && (Y + 1 < Height))
+	{
+		MarkDirty(GetClusterOf(X, Y + 1));
+	}
+}
+
+void FGridHierarchy::MarkDirty(int32 Cluster)
+{
+	if (!Clusters[Cluster].bDirty)
+	{
+		Clusters[Cluster].bDirty = true;
+		DirtyClusters.push_back(Cluster);
+	}
+}
+
+int32 FGridHierarchy::Update(const FGridGraph& Graph)
+{
+	if (!bBuilt || (Graph.GetWidth() != Width) || (Graph.GetHeight() != Height))
+	{
+		Build(Graph, ClusterSize);
+		return (int32)Clusters.size();
+	}
+
+	const int32 NumRebuilt = (int32)DirtyClusters.size();
+	for (int32 Cluster : DirtyClusters)
+	{
+		RebuildCluster(Graph, Cluster);
+	}
+	DirtyClusters.clear();
+	return NumRebuilt;
+}
+
+void FGridHierarchy::RebuildCluster(const FGridGraph& Graph, int32 ClusterIndex)
+{
+	FCluster& Cluster = Clusters[ClusterIndex];
+	for (int32 Index : Cluster.Nodes)
+	{
+		CellToLocal[Index] = -1;
+	}
+	Cluster.Nodes.clear();
+
+	AddBorderNodes(Graph, Cluster, 0, 1);
+	AddBorderNodes(Graph, Cluster, 0, -1);
+	AddBorderNodes(Graph, Cluster, -1, 0);
+	AddBorderNodes(Graph, Cluster, 1, 0);
+
+	const int32 NumNodes = (int32)Cluster.Nodes.size();
+	Cluster.Costs.assign(NumNodes * NumNodes, GridUnreachable);
+	for (int32 From = 0; From < NumNodes; From++)
+	{
+		SearchCluster(Graph, Cluster, Cluster.Nodes[From], GridInvalidIndex, false);
+		for (int32 To = 0; To < NumNodes; To++)
+		{
+			Cluster.Costs[From * NumNodes + To] = LocalDistance[GetLocalIndex(Cluster, Cluster.Nodes[To])];
+		}
+	}
+	Cluster.bDirty = false;
+}
+
+void FGridHierarchy::AddBorderNodes(const FGridGraph& Graph, FCluster& Cluster, int32 StepX, int32 StepY)
+{
+	//Walk the cells of this side of the border, in the same order the neighbor walks its side
+	int32 FirstX = Cluster.MinX;
+	int32 FirstY = Cluster.MinY;
+	int32 Length = 0;
+	if (StepY != 0)
+	{
+		FirstY = StepY > 0 ? Cluster.MinY + Cluster.SizeY - 1 : Cluster.MinY;
+		Length = Cluster.SizeX;
+	}
+	else
+	{
+		FirstX = StepX > 0 ? Cluster.MinX + Cluster.SizeX - 1 : Cluster.MinX;
+		Length = Cluster.SizeY;
+	}
+
+	if (!Graph.IsValidCoord(FirstX + StepX, FirstY + StepY))
+	{
+		return;
+	}
+
+	const int32 AlongX = StepY != 0 ? 1 : 0;
+	const int32 AlongY = 1 - AlongX;
+	const int32 Across = StepY * Graph.GetWidth() + StepX;
+
+	int32 RunStart = -1;
+	for (int32 i = 0; i <= Length; i++)
+	{
+		bool bOpen = false;
+		if (i < Length)
+		{
+			const int32 Inside = Graph.GetIndex(FirstX + i * AlongX, FirstY + i * AlongY);
+			bOpen = Graph.IsWalkable(Inside) && Graph.IsWalkable(Inside + Across);
+		}
+
+		if (bOpen && (RunStart < 0))
+		{
+			RunStart = i;
+		}
+		else if (!bOpen && (RunStart >= 0))
+		{
+			const int32 RunLength = i - RunStart;
+			if (RunLength >= LongEntranceLength)
+			{
+				AddNode(Cluster, Graph.GetIndex(FirstX + RunStart * AlongX, FirstY + RunStart * AlongY));
+				AddNode(Cluster, Graph.GetIndex(FirstX + (i - 1) * AlongX, FirstY + (i - 1) * AlongY));
+			}
+			else
+			{
+				const int32 Middle = RunStart + (RunLength - 1) / 2;
+				AddNode(Cluster, Graph.GetIndex(FirstX + Middle * AlongX, FirstY + Middle * AlongY));
+			}
+			RunStart = -1;
+		}
+	}
+}
+
+void FGridHierarchy::AddNode(FCluster& Cluster, int32 Index)
+{
+	//Corner cells can be picked by two borders
+	if (CellToLocal[Index] < 0)
+	{
+		CellToLocal[Index] = (int16)Cluster.Nodes.size();
+		Cluster.Nodes.push_back(Index);
+	}
+}
+
+void FGridHierarchy::SearchCluster(const FGridGraph& Graph, const FCluster& Cluster, int32 Source, int32 Target, bool bReverse)
+{
+	const int32 NumLocal = Cluster.SizeX * Cluster.SizeY;
+	LocalDistance.assign(NumLocal, GridUnreachable);
+	LocalParent.assign(NumLocal, GridInvalidIndex);
+	LocalClosed.assign(NumLocal, 0);
+
+	//Only a single target can be steered towards
+	const int32 HeuristicScale = Target != GridInvalidIndex ? Graph.GetMinCost() : 0;
+	LocalBuckets.Reset(NumLocal, Graph.GetMaxCost() + HeuristicScale);
+
+	const int32 SourceLocal = GetLocalIndex(Cluster, Source);
+	const int32 TargetLocal = Target != GridInvalidIndex ? GetLocalIndex(Cluster, Target) : GridInvalidIndex;
+	const int32 TargetX = TargetLocal != GridInvalidIndex ? TargetLocal % Cluster.SizeX : 0;
+	const int32 TargetY = TargetLocal != GridInvalidIndex ? TargetLocal / Cluster.SizeX : 0;
+	LocalDistance[SourceLocal] = 0;
+	LocalBuckets.Push(SourceLocal, 0);
+
+	while (!LocalBuckets.IsEmpty())
+	{
+		const int32 Local = LocalBuckets.Pop();
+		LocalClosed[Local] = 1;
+		if (Local == TargetLocal)
+		{
+			return;
+		}
+
+		//Neighbors are walked in cluster coordinates, same order as FGridGraph::GetNeighbors
+		const int32 X = Local % Cluster.SizeX;
+		const int32 Y = Local / Cluster.SizeX;
+		const int32 Current = Graph.GetIndex(Cluster.MinX + X, Cluster.MinY + Y);
+		const int32 Candidates[4][3] =
+		{
+			{ Y + 1 < Cluster.SizeY, Width, Cluster.SizeX },
+			{ Y > 0, -Width, -Cluster.SizeX },
+			{ X > 0, -1, -1 },
+			{ X + 1 < Cluster.SizeX, 1, 1 },
+		};
+
+		for (int32 i = 0; i < 4; i++)
+		{
+			const int32 Neighbor = Current + Candidates[i][1];
+			if (!Candidates[i][0] || Graph.IsWall(Neighbor))
+			{
+				continue;
+			}
+
+			//Going backwards the step from Neighbor onto Current is the one being paid for
+			const int32 NeighborLocal = Local + Candidates[i][2];
+			const int32 NewDistance = LocalDistance[Local] + Graph.GetCost(bReverse ? Current : Neighbor);
+			if (!LocalClosed[NeighborLocal] && (NewDistance < LocalDistance[NeighborLocal]))
+			{
+				LocalDistance[NeighborLocal] = NewDistance;
+				LocalParent[NeighborLocal] = Local;
+
+				int32 Heuristic = 0;
+				if (HeuristicScale != 0)
+				{
+					const int32 NeighborX = NeighborLocal % Cluster.SizeX;
+					const int32 NeighborY = NeighborLocal / Cluster.SizeX;
+					Heuristic = (std::abs(NeighborX - TargetX) + std::abs(NeighborY - TargetY)) * HeuristicScale;
+				}
+				LocalBuckets.Push(NeighborLocal, NewDistance + Heuristic);
+			}
+		}
+	}
+}
+
+void FGridHierarchy::AppendClusterPath(const FGridGraph& Graph, const FCluster& Cluster, int32 From, int32 To, std::vector<int32>& OutPath)
+{
+	SearchCluster(Graph, Cluster, From, To, false);
+
+	const size_t First = OutPath.size();
+	for (int32 Local = GetLocalIndex(Cluster, To); LocalParent[Local] != GridInvalidIndex; Local = LocalParent[Local])
+	{
+		OutPath.push_back(Graph.GetIndex(Cluster.MinX + Local % Cluster.SizeX, Cluster.MinY + Local / Cluster.SizeX));
+	}
+	std::reverse(OutPath.begin() + First, OutPath.end());
+}
+
+void FGridHierarchy::Relax(const FGridGraph& Graph, int32 Id, int32 Cell, int32 Parent, int32 NewDistance, int32 Goal, int32 HeuristicScale)
+{
+	FAbstractNode& Node = AbstractNodes[Id];
+	if (Node.Stamp != CurrentStamp)
+	{
+		Node.Stamp = CurrentStamp;
+		Node.Distance = GridUnreachable;
+		Node.bClosed = false;
+		Node.Cell = Cell;
+		Node.Heuristic = Graph.GetManhattanDistance(Cell, Goal) * HeuristicScale;
+	}
+
+	if (Node.bClosed || (NewDistance >= Node.Distance))
+	{
+		return;
+	}
+
+	Node.Distance = NewDistance;
+	Node.Parent = Parent;
+	AbstractHeap.Push(Id, FAbstractKey{ NewDistance + Node.Heuristic, Node.Heuristic });
+}
+
+bool FGridHierarchy::FindPath(const FGridGraph& Graph, int32 Start, int32 Goal, FGridSearchResult& OutResult, bool bRefine)
+{
+	OutResult.Reset();
+	Update(Graph);
+
+	//New stamp, so nothing from the last query is read back
+	CurrentStamp++;
+	if (CurrentStamp == 0)
+	{
+		for (FAbstractNode& Node : AbstractNodes)
+		{
+			Node.Stamp = 0;
+		}
+		CurrentStamp = 1;
+	}
+	LastStart = Start;
+	LastGoal = Goal;
+
+	if (!Graph.IsValidIndex(Start) || !Graph.IsValidIndex(Goal) || Graph.IsWall(Start) || Graph.IsWall(Goal))
+	{
+		return false;
+	}
+
+	const int32 StartCluster = GetClusterOfIndex(Start);
+	const int32 GoalCluster = GetClusterOfIndex(Goal);
+	const FCluster& StartNodes = Clusters[StartCluster];
+	const FCluster& GoalNodes = Clusters[GoalCluster];
+
+	//Link the start to the nodes of its cluster, and straight to the goal when they share one
+	SearchCluster(Graph, StartNodes, Start, GridInvalidIndex, false);
+	StartCosts.resize(StartNodes.Nodes.size());
+	for (int32 Local = 0; Local < (int32)StartNodes.Nodes.size(); Local++)
+	{
+		StartCosts[Local] = LocalDistance[GetLocalIndex(StartNodes, StartNodes.Nodes[Local])];
+	}
+	const int32 DirectCost = StartCluster == GoalCluster ? LocalDistance[GetLocalIndex(StartNodes, Goal)] : GridUnreachable;
+
+	SearchCluster(Graph, GoalNodes, Goal, GridInvalidIndex, true);
+	GoalCosts.resize(GoalNodes.Nodes.size());
+	for (int32 Local = 0; Local < (int32)GoalNodes.Nodes.size(); Local++)
+	{
+		GoalCosts[Local] = LocalDistance[GetLocalIndex(GoalNodes, GoalNodes.Nodes[Local])];
+	}
+
+	const int32 StartId = (int32)Clusters.size() * MaxNodesPerCluster;
+	const int32 GoalId = StartId + 1;
+	const int32 HeuristicScale = Graph.GetMinCost();
+
+	AbstractHeap.Clear();
+	Relax(Graph, StartId, Start, GridInvalidIndex, 0, Goal, HeuristicScale);
+
+	bool bFound = false;
+	while (!AbstractHeap.IsEmpty())
+	{
+		OutResult.PeakOpenListSize = std::max(OutResult.PeakOpenListSize, AbstractHeap.Num());
+		const int32 Id = AbstractHeap.Pop();
+		AbstractNodes[Id].bClosed = true;
+		OutResult.NodesExpanded++;
+		OutResult.VisitedOrder.push_back(AbstractNodes[Id].Cell);
+
+		if (Id == GoalId)
+		{
+			bFound = true;
+			break;
+		}
+
+		const int32 Distance = AbstractNodes[Id].Distance;
+		if (Id == StartId)
+		{
+			for (int32 Local = 0; Local < (int32)StartNodes.Nodes.size(); Local++)
+			{
+				if (StartCosts[Local] != GridUnreachable)
+				{
+					Relax(Graph, GetNodeId(StartCluster, Local), StartNodes.Nodes[Local], Id, Distance + StartCosts[Local], Goal, HeuristicScale);
+				}
+			}
+			if (DirectCost != GridUnreachable)
+			{
+				Relax(Graph, GoalId, Goal, Id, DirectCost, Goal, HeuristicScale);
+			}
+			continue;
+		}
+
+		const int32 ClusterIndex = Id / MaxNodesPerCluster;
+		const int32 NodeLocal = Id % MaxNodesPerCluster;
+		const FCluster& Cluster = Clusters[ClusterIndex];
+		const int32 NumNodes = (int32)Cluster.Nodes.size();
+		const int32 Cell = Cluster.Nodes[NodeLocal];
+
+		//Other nodes of the same cluster
+		for (int32 Local = 0; Local < NumNodes; Local++)
+		{
+			const int32 Cost = Cluster.Costs[NodeLocal * NumNodes + Local];
+			if ((Local != NodeLocal) && (Cost != GridUnreachable))
+			{
+				Relax(Graph, GetNodeId(ClusterIndex, Local), Cluster.Nodes[Local], Id, Distance + Cost, Goal, HeuristicScale);
+			}
+		}
+
+		//Single steps across the border onto the neighboring clusters' nodes
+		int32 Neighbors[4];
+		const int32 NumNeighbors = Graph.GetNeighbors(Cell, Neighbors);
+		for (int32 i = 0; i < NumNeighbors; i++)
+		{
+			const int32 Neighbor = Neighbors[i];
+			const int32 NeighborCluster = GetClusterOfIndex(Neighbor);
+			if ((CellToLocal[Neighbor] >= 0) && (NeighborCluster != ClusterIndex))
+			{
+				Relax(Graph, GetNodeId(NeighborCluster, CellToLocal[Neighbor]), Neighbor, Id, Distance + Graph.GetCost(Neighbor), Goal, HeuristicScale);
+			}
+		}
+
+		if ((ClusterIndex == GoalCluster) && (GoalCosts[NodeLocal] != GridUnreachable))
+		{
+			Relax(Graph, GoalId, Goal, Id, Distance + GoalCosts[NodeLocal], Goal, HeuristicScale);
+		}
+	}
+
+	if (!bFound)
+	{
+		return false;
+	}
+
+	std::vector<int32> Waypoints;
+	for (int32 Id = GoalId; Id != GridInvalidIndex; Id = AbstractNodes[Id].Parent)
+	{
+		Waypoints.push_back(AbstractNodes[Id].Cell);
+	}
+	std::reverse(Waypoints.begin(), Waypoints.end());
+
+	OutResult.bFound = true;
+	OutResult.Cost = AbstractNodes[GoalId].Distance;
+	if (!bRefine)
+	{
+		OutResult.Path = Waypoints;
+		return true;
+	}
+
+	//Hops between clusters are single steps, hops inside one are searched again within its bounds
+	OutResult.Path.push_back(Start);
+	for (size_t i = 1; i < Waypoints.size(); i++)
+	{
+		const int32 From = Waypoints[i - 1];
+		const int32 To = Waypoints[i];
+		const int32 FromCluster = GetClusterOfIndex(From);
+		if (From == To)
+		{
+			continue;
+		}
+		else if (FromCluster != GetClusterOfIndex(To))
+		{
+			OutResult.Path.push_back(To);
+		}
+		else
+		{
+			AppendClusterPath(Graph, Clusters[FromCluster], From, To, OutResult.Path);
+		}
+	}
+	return true;
+}
+
+int32 FGridHierarchy::GetDistance(int32 Index) const
+{
+	if (!bBuilt || (Index < 0) || (Index >= Width * Height))
+	{
+		return GridUnreachable;
+	}
+
+	if (CellToLocal[Index] >= 0)
+	{
+		return GetAbstractDistance(GetNodeId(GetClusterOfIndex(Index), CellToLocal[Index]));
+	}
+
+	const int32 StartId = (int32)Clusters.size() * MaxNodesPerCluster;
+	if (Index == LastStart)
+	{
+		return GetAbstractDistance(StartId);
+	}
+	if (Index == LastGoal)
+	{
+		return GetAbstractDistance(StartId + 1);
+	}
+	return GridUnreachable;
+}
+
+int32 FGridHierarchy::GetNumNodes() const
+{
+	int32 NumNodes = 0;
+	for (const FCluster& Cluster : Clusters)
+	{
+		NumNodes += (int32)Cluster.Nodes.size();
+	}
+	return NumNodes;
+}
+
+int64 FGridHierarchy::GetAllocatedBytes() const
+{
+	int64 Bytes = GridMemory::GetAllocatedBytes(Clusters);
+	for (const FCluster& Cluster : Clusters)
+	{
+		Bytes += GridMemory::GetAllocatedBytes(Cluster.Nodes) + GridMemory::GetAllocatedBytes(Cluster.Costs);
+	}
+	return Bytes + GridMemory::GetAllocatedBytes(CellToLocal) + GridMemory::GetAllocatedBytes(DirtyClusters)
+		+ GridMemory::GetAllocatedBytes(LocalDistance) + GridMemory::GetAllocatedBytes(LocalParent) + GridMemory::GetAllocatedBytes(LocalClosed)
+		+ LocalBuckets.GetAllocatedBytes() + GridMemory::GetAllocatedBytes(AbstractNodes) + AbstractHeap.GetAllocatedBytes()
+		+ GridMemory::GetAllocatedBytes(StartCosts) + GridMemory::GetAllocatedBytes(GoalCosts);
+}
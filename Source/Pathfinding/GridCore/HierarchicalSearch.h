@@ -0,0 +1,166 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "GridTypes.h"
+#include "IndexedHeap.h"
+#include "BucketQueue.h"
+#include <vector>
+
+class FGridGraph;
+struct FGridSearchResult;
+
+/**
+ * HPA* abstraction of an FGridGraph.
+ *
+ * The grid is cut into square clusters. Wherever two neighboring clusters share a run of open cells, one transition
+ * (two for long runs) is placed across the border; its two cells become abstract nodes. Every cluster stores the
+ * costs between its own nodes, measured with searches that never leave the cluster. A query links the start and
+ * goal into their clusters, runs A* over the abstract nodes, and then refines each abstract hop with a small search
+ * inside one cluster.
+ *
+ * Paths are near optimal rather than optimal, since they must pass through the chosen transitions.
+ * Edited cells only mark their cluster (and the neighbors sharing that border) dirty; dirty clusters are rebuilt
+ * on the next query.
+ */
+class FGridHierarchy
+{
+public:
+	enum : int32
+	{
+		DefaultClusterSize = 32,
+		/** Entrances at least this long get a transition at each end instead of one in the middle */
+		LongEntranceLength = 6
+	};
+
+	/** Build every cluster from scratch */
+	void Build(const FGridGraph& Graph, int32 InClusterSize = DefaultClusterSize);
+
+	/** Drop everything so the next query does a full build, for bulk edits */
+	void Invalidate() { bBuilt = false; }
+
+	bool IsBuilt() const { return bBuilt; }
+
+	/** Mark the clusters a changed cell (wall or cost) can affect */
+	void OnCellChanged(int32 Index);
+
+	/** Rebuild the dirty clusters, or everything if the graph was resized. Returns how many clusters were rebuilt */
+	int32 Update(const FGridGraph& Graph);
+
+	/**
+	 * Find a path with the abstraction, updating it first.
+	 * With bRefine the result holds every cell of the path, otherwise only start, the abstract nodes used and goal.
+	 * VisitedOrder lists the abstract nodes in the order they were expanded.
+	 */
+	bool FindPath(const FGridGraph& Graph, int32 Start, int32 Goal, FGridSearchResult& OutResult, bool bRefine = true);
+
+	/** Abstract search distance of a node cell in the last query, GridUnreachable for other cells */
+	int32 GetDistance(int32 Index) const;
+
+	int32 GetClusterSize() const { return ClusterSize; }
+	int32 GetNumClusters() const { return (int32)Clusters.size(); }
+
+	/** Number of abstract nodes over all clusters */
+	int32 GetNumNodes() const;
+
+	/** Heap bytes held by the clusters and the query scratch */
+	int64 GetAllocatedBytes() const;
+
+private:
+	struct FCluster
+	{
+		int32 MinX = 0;
+		int32 MinY = 0;
+		int32 SizeX = 0;
+		int32 SizeY = 0;
+
+		/** Cells of the abstract nodes in this cluster */
+		std::vector<int32> Nodes;
+
+		/** Nodes.size() squared costs, row = from, column = to, GridUnreachable when not connected inside the cluster */
+		std::vector<int32> Costs;
+
+		bool bDirty = false;
+	};
+
+	int32 GetClusterOf(int32 X, int32 Y) const { return (Y / ClusterSize) * ClustersX + X / ClusterSize; }
+	int32 GetClusterOfIndex(int32 Index) const { return GetClusterOf(Index % Width, Index / Width); }
+
+	/** Position of a cell inside its cluster, used to index the SearchCluster scratch */
+	int32 GetLocalIndex(const FCluster& Cluster, int32 Index) const { return (Index / Width - Cluster.MinY) * Cluster.SizeX + (Index % Width - Cluster.MinX); }
+
+	/** Abstract node id of a node cell, ids are stable while the cell's cluster isn't rebuilt */
+	int32 GetNodeId(int32 Cluster, int32 Local) const { return Cluster * MaxNodesPerCluster + Local; }
+
+	void MarkDirty(int32 Cluster);
+	void RebuildCluster(const FGridGraph& Graph, int32 Cluster);
+
+	/** Add this cluster's side of every transition across one of its borders (StepX/StepY point at the neighbor) */
+	void AddBorderNodes(const FGridGraph& Graph, FCluster& Cluster, int32 StepX, int32 StepY);
+	void AddNode(FCluster& Cluster, int32 Index);
+
+	/**
+	 * Search confined to one cluster from Source. Without a Target every cell is reached, with one it stops there.
+	 * bReverse measures costs towards Source instead of away from it.
+	 */
+	void SearchCluster(const FGridGraph& Graph, const FCluster& Cluster, int32 Source, int32 Target, bool bReverse);
+
+	/** Append the cells from From (excluded) to To (included) found inside one cluster */
+	void AppendClusterPath(const FGridGraph& Graph, const FCluster& Cluster, int32 From, int32 To, std::vector<int32>& OutPath);
+
+	/** Abstract search bookkeeping, entries are only valid when their stamp matches the current query */
+	int32 GetAbstractDistance(int32 Id) const { return AbstractNodes[Id].Stamp == CurrentStamp ? AbstractNodes[Id].Distance : GridUnreachable; }
+	void Relax(const FGridGraph& Graph, int32 Id, int32 Cell, int32 Parent, int32 NewDistance, int32 Goal, int32 HeuristicScale);
+
+	/** Abstract open list key, ties on F go to the node closer to the goal so open areas don't expand every equal-F node */
+	struct FAbstractKey
+	{
+		int32 F;
+		int32 H;
+
+		bool operator<(const FAbstractKey& Other) const { return F < Other.F || (F == Other.F && H < Other.H); }
+	};
+
+	std::vector<FCluster> Clusters;
+	int32 ClustersX = 0;
+	int32 ClustersY = 0;
+	int32 ClusterSize = DefaultClusterSize;
+	int32 MaxNodesPerCluster = 0;
+	int32 Width = 0;
+	int32 Height = 0;
+	bool bBuilt = false;
+
+	/** Index into its cluster's Nodes for every node cell, -1 for the rest */
+	std::vector<int16> CellToLocal;
+
+	std::vector<int32> DirtyClusters;
+
+	/** Scratch for SearchCluster, indexed by cell position inside the cluster */
+	std::vector<int32> LocalDistance;
+	std::vector<int32> LocalParent;
+	std::vector<uint8> LocalClosed;
+	FBucketQueue LocalBuckets;
+
+	/** Everything the abstract search keeps per node, packed so a relaxation touches one cache line */
+	struct FAbstractNode
+	{
+		int32 Distance = GridUnreachable;
+		int32 Parent = GridInvalidIndex;
+		int32 Cell = GridInvalidIndex;
+		int32 Heuristic = 0;
+		uint32 Stamp = 0;
+		bool bClosed = false;
+	};
+
+	/** Scratch for the abstract search, indexed by node id. Start and goal get the two ids after the last cluster */
+	std::vector<FAbstractNode> AbstractNodes;
+	uint32 CurrentStamp = 0;
+	TIndexedHeap<FAbstractKey> AbstractHeap;
+
+	/** Costs from the start to each node of its cluster, and from each node of the goal's cluster to the goal */
+	std::vector<int32> StartCosts;
+	std::vector<int32> GoalCosts;
+
+	int32 LastStart = GridInvalidIndex;
+	int32 LastGoal = GridInvalidIndex;
+};
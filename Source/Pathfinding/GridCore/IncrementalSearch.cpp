@@ -0,0 +1,221 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "IncrementalSearch.h"
+#include "GridGraph.h"
+#include <algorithm>
+
+void FGridIncrementalSearch::Initialize(const FGridGraph& Graph, int32 InStart, int32 InGoal)
+{
+	const int32 NumCells = Graph.Num();
+	G.assign(NumCells, GridUnreachable);
+	Rhs.assign(NumCells, GridUnreachable);
+	Queue.Reset(NumCells);
+
+	Start = InStart;
+	Goal = InGoal;
+	LastStart = InStart;
+	KeyOffset = 0;
+	HeuristicScale = Graph.GetMinCost();
+	bNeedsRestart = false;
+
+	if (Goal != GridInvalidIndex && !Graph.IsWall(Goal))
+	{
+		Rhs[Goal] = 0;
+		Queue.Push(Goal, CalculateKey(Graph, Goal));
+	}
+}
+
+void FGridIncrementalSearch::SetStart(const FGridGraph& Graph, int32 NewStart)
+{
+	if (NewStart == Start)
+	{
+		return;
+	}
+
+	//Queued keys were measured from LastStart, they underestimate new keys by at most the distance the start moved
+	if (Start != GridInvalidIndex && NewStart != GridInvalidIndex)
+	{
+		KeyOffset += Graph.GetManhattanDistance(LastStart, NewStart) * HeuristicScale;
+		LastStart = NewStart;
+	}
+	else
+	{
+		bNeedsRestart = true;
+	}
+	Start = NewStart;
+}
+
+void FGridIncrementalSearch::OnCellChanged(const FGridGraph& Graph, int32 Index)
+{
+	if (!IsInitialized() || bNeedsRestart)
+	{
+		return;
+	}
+
+	if (Graph.GetMinCost() < HeuristicScale)
+	{
+		bNeedsRestart = true;
+		return;
+	}
+
+	//Only the edges into and out of the cell changed
+	UpdateCell(Graph, Index);
+
+	int32 Neighbors[4];
+	const int32 NumNeighbors = Graph.GetNeighbors(Index, Neighbors);
+	for (int32 i = 0; i < NumNeighbors; i++)
+	{
+		UpdateCell(Graph, Neighbors[i]);
+	}
+}
+
+bool FGridIncrementalSearch::Replan(const FGridGraph& Graph, FGridSearchResult& OutResult)
+{
+	OutResult.Reset();
+	if (!IsInitialized() || Start == GridInvalidIndex)
+	{
+		return false;
+	}
+
+	if (bNeedsRestart || (int32)G.size() != Graph.Num())
+	{
+		Initialize(Graph, Start, Goal);
+	}
+
+	while (!Queue.IsEmpty() && (Queue.TopKey() < CalculateKey(Graph, Start) || Rhs[Start] != G[Start]))
+	{
+		const int32 Current = Queue.Top();
+		const FKey OldKey = Queue.TopKey();
+		const FKey NewKey = CalculateKey(Graph, Current);
+
+		if (OldKey < NewKey)
+		{
+			//Queued before the start moved
+			Queue.Update(Current, NewKey);
+			continue;
+		}
+
+		Queue.Pop();
+		OutResult.NodesExpanded++;
+		OutResult.VisitedOrder.push_back(Current);
+
+		int32 Neighbors[4];
+		const int32 NumNeighbors = Graph.GetNeighbors(Current, Neighbors);
+		if (G[Current] > Rhs[Current])
+		{
+			//Got cheaper, settle it and let the neighbors through it
+			G[Current] = Rhs[Current];
+			for (int32 i = 0; i < NumNeighbors; i++)
+			{
+				UpdateCell(Graph, Neighbors[i]);
+			}
+		}
+		else
+		{
+			//Got dearer, drop it and let it and its neighbors find their way again
+			G[Current] = GridUnreachable;
+			UpdateCell(Graph, Current);
+			for (int32 i = 0; i < NumNeighbors; i++)
+			{
+				UpdateCell(Graph, Neighbors[i]);
+			}
+		}
+	}
+
+	BuildPath(Graph, OutResult);
+	return OutResult.bFound;
+}
+
+FGridIncrementalSearch::FKey FGridIncrementalSearch::CalculateKey(const FGridGraph& Graph, int32 Index) const
+{
+	const int32 Best = std::min(G[Index], Rhs[Index]);
+	if (Best == GridUnreachable)
+	{
+		return FKey{ GridUnreachable, GridUnreachable };
+	}
+	return FKey{ Best + Graph.GetManhattanDistance(LastStart, Index) * HeuristicScale + KeyOffset, Best };
+}
+
+void FGridIncrementalSearch::UpdateCell(const FGridGraph& Graph, int32 Index)
+{
+	if (Index != Goal)
+	{
+		Rhs[Index] = GetLookahead(Graph, Index);
+	}
+	else
+	{
+		Rhs[Index] = Graph.IsWall(Index) ? GridUnreachable : 0;
+	}
+
+	if (G[Index] != Rhs[Index])
+	{
+		Queue.Push(Index, CalculateKey(Graph, Index));
+	}
+	else
+	{
+		Queue.Remove(Index);
+	}
+}
+
+int32 FGridIncrementalSearch::GetLookahead(const FGridGraph& Graph, int32 Index) const
+{
+	if (Graph.IsWall(Index))
+	{
+		return GridUnreachable;
+	}
+
+	int32 Best = GridUnreachable;
+	int32 Neighbors[4];
+	const int32 NumNeighbors = Graph.GetNeighbors(Index, Neighbors);
+	for (int32 i = 0; i < NumNeighbors; i++)
+	{
+		const int32 Neighbor = Neighbors[i];
+		if (G[Neighbor] != GridUnreachable)
+		{
+			Best = std::min(Best, G[Neighbor] + Graph.GetCost(Neighbor));
+		}
+	}
+	return Best;
+}
+
+void FGridIncrementalSearch::BuildPath(const FGridGraph& Graph, FGridSearchResult& OutResult) const
+{
+	if (G[Start] == GridUnreachable)
+	{
+		return;
+	}
+
+	OutResult.bFound = true;
+	OutResult.Cost = G[Start];
+
+	//Step to the neighbour with the cheapest cost to go, the way rhs is computed
+	int32 Current = Start;
+	OutResult.Path.push_back(Current);
+	while (Current != Goal)
+	{
+		int32 Next = GridInvalidIndex;
+		int32 NextDistance = GridUnreachable;
+		int32 Neighbors[4];
+		const int32 NumNeighbors = Graph.GetNeighbors(Current, Neighbors);
+		for (int32 i = 0; i < NumNeighbors; i++)
+		{
+			const int32 Neighbor = Neighbors[i];
+			if (G[Neighbor] != GridUnreachable && G[Neighbor] + Graph.GetCost(Neighbor) < NextDistance)
+			{
+				Next = Neighbor;
+				NextDistance = G[Neighbor] + Graph.GetCost(Neighbor);
+			}
+		}
+
+		if (Next == GridInvalidIndex || (int32)OutResult.Path.size() > Graph.Num())
+		{
+			//Can only happen with a corrupt table, report no path rather than a broken one
+			OutResult.bFound = false;
+			OutResult.Cost = GridUnreachable;
+			OutResult.Path.clear();
+			return;
+		}
+		OutResult.Path.push_back(Next);
+		Current = Next;
+	}
+}
@@ -0,0 +1,86 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "GridTypes.h"
+#include "GridSearch.h"
+#include "IndexedHeap.h"
+#include <vector>
+
+class FGridGraph;
+
+/**
+ * D* Lite: a shortest path that is repaired instead of searched again after edits.
+ * Distances run from each cell to the goal and are kept between calls. OnCellChanged only requeues the edited cell and
+ * its neighbors, and the next Replan expands just the cells whose distance actually changed. Moving the start only
+ * shifts the key offset, so an agent walking the path costs nothing extra. Changing the goal starts over.
+ */
+class FGridIncrementalSearch
+{
+public:
+	/** Forget everything and plan from InStart to InGoal on the next Replan */
+	void Initialize(const FGridGraph& Graph, int32 InStart, int32 InGoal);
+
+	bool IsInitialized() const { return Goal != GridInvalidIndex; }
+	int32 GetStart() const { return Start; }
+	int32 GetGoal() const { return Goal; }
+
+	/** Move the start, e.g. as an agent walks along the path. Keeps the distances */
+	void SetStart(const FGridGraph& Graph, int32 NewStart);
+
+	/** Call after a cell's wall state or cost changed in Graph */
+	void OnCellChanged(const FGridGraph& Graph, int32 Index);
+
+	/**
+	 * Bring the path up to date with every change since the last call. NodesExpanded and VisitedOrder only cover the
+	 * cells this call had to fix, Path and Cost are the full current path
+	 */
+	bool Replan(const FGridGraph& Graph, FGridSearchResult& OutResult);
+
+	/** Cost from Index to the goal as of the last Replan, GridUnreachable if there is no way */
+	int32 GetDistanceToGoal(int32 Index) const { return G[Index]; }
+
+	/** Heap bytes held by the distances and the queue */
+	int64 GetAllocatedBytes() const { return GridMemory::GetAllocatedBytes(G) + GridMemory::GetAllocatedBytes(Rhs) + Queue.GetAllocatedBytes(); }
+
+private:
+	/** Lexicographic queue key, K1 = min(g, rhs) + h + KeyOffset, K2 = min(g, rhs) */
+	struct FKey
+	{
+		int32 K1;
+		int32 K2;
+
+		bool operator<(const FKey& Other) const { return K1 != Other.K1 ? K1 < Other.K1 : K2 < Other.K2; }
+	};
+
+	FKey CalculateKey(const FGridGraph& Graph, int32 Index) const;
+
+	/** Recompute rhs from the neighbors and requeue the cell if it is inconsistent */
+	void UpdateCell(const FGridGraph& Graph, int32 Index);
+
+	/** rhs of a cell: the cheapest neighbor's g plus the cost of stepping onto it */
+	int32 GetLookahead(const FGridGraph& Graph, int32 Index) const;
+
+	void BuildPath(const FGridGraph& Graph, FGridSearchResult& OutResult) const;
+
+	/** Current distance to the goal */
+	std::vector<int32> G;
+
+	/** One step lookahead of G, cells with G != Rhs are queued */
+	std::vector<int32> Rhs;
+
+	TIndexedHeap<FKey> Queue;
+
+	int32 Start = GridInvalidIndex;
+	int32 Goal = GridInvalidIndex;
+
+	/** Start the heuristic in the queued keys was measured from */
+	int32 LastStart = GridInvalidIndex;
+
+	/** Sum of the heuristic shifts from moving the start, added to new keys so old keys stay lower bounds */
+	int32 KeyOffset = 0;
+
+	/** Min cost the heuristic was scaled by. A cheaper cell makes it inadmissible and forces a restart */
+	int32 HeuristicScale = 1;
+	bool bNeedsRestart = false;
+};
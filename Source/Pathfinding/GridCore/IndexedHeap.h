@@ -0,0 +1,193 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "GridTypes.h"
+#include "GridMemory.h"
+#include <vector>
+
+/**
+ * Min-heap of cell indices with an Arity-ary tree and a position table, so a cell's key can be
+ * lowered (or raised) in place instead of pushing a duplicate.
+ * KeyType only needs operator<.
+ */
+template <typename KeyType, int32 Arity = 4>
+class TIndexedHeap
+{
+	static_assert(Arity >= 2, "A heap needs at least two children per node");
+
+public:
+	/** Make room for items 0..NumItems-1 and empty the heap */
+	void Reset(int32 NumItems)
+	{
+		Clear();
+		if ((int32)Positions.size() < NumItems)
+		{
+			Positions.resize(NumItems, InvalidPosition);
+		}
+	}
+
+	/** Empty the heap. Only touches the items that were in it */
+	void Clear()
+	{
+		for (const FEntry& Entry : Entries)
+		{
+			Positions[Entry.Item] = InvalidPosition;
+		}
+		Entries.clear();
+	}
+
+	bool IsEmpty() const { return Entries.empty(); }
+	int32 Num() const { return (int32)Entries.size(); }
+
+	int64 GetAllocatedBytes() const { return GridMemory::GetAllocatedBytes(Entries) + GridMemory::GetAllocatedBytes(Positions); }
+	bool Contains(int32 Item) const { return Positions[Item] != InvalidPosition; }
+
+	int32 Top() const { return Entries[0].Item; }
+	const KeyType& TopKey() const { return Entries[0].Key; }
+	const KeyType& GetKey(int32 Item) const { return Entries[Positions[Item]].Key; }
+
+	/** Insert Item, or move it to Key if it is already in the heap */
+	void Push(int32 Item, const KeyType& Key)
+	{
+		if (Contains(Item))
+		{
+			Update(Item, Key);
+			return;
+		}
+
+		Positions[Item] = (int32)Entries.size();
+		Entries.push_back(FEntry{ Key, Item });
+		SiftUp(Positions[Item]);
+	}
+
+	/** Change the key of an item already in the heap */
+	void Update(int32 Item, const KeyType& Key)
+	{
+		const int32 Position = Positions[Item];
+		const bool bDecrease = Key < Entries[Position].Key;
+		Entries[Position].Key = Key;
+		if (bDecrease)
+		{
+			SiftUp(Position);
+		}
+		else
+		{
+			SiftDown(Position);
+		}
+	}
+
+	/** Remove and return the item with the smallest key */
+	int32 Pop()
+	{
+		const int32 Item = Entries[0].Item;
+		RemoveAt(0);
+		return Item;
+	}
+
+	/** Remove an item if it is in the heap */
+	void Remove(int32 Item)
+	{
+		if (Contains(Item))
+		{
+			RemoveAt(Positions[Item]);
+		}
+	}
+
+private:
+	enum : int32
+	{
+		InvalidPosition = -1
+	};
+
+	struct FEntry
+	{
+		KeyType Key;
+		int32 Item;
+	};
+
+	void RemoveAt(int32 Position)
+	{
+		Positions[Entries[Position].Item] = InvalidPosition;
+
+		const int32 Last = (int32)Entries.size() - 1;
+		if (Position != Last)
+		{
+			const bool bDecrease = Entries[Last].Key < Entries[Position].Key;
+			Entries[Position] = Entries[Last];
+			Positions[Entries[Position].Item] = Position;
+			Entries.pop_back();
+			if (bDecrease)
+			{
+				SiftUp(Position);
+			}
+			else
+			{
+				SiftDown(Position);
+			}
+		}
+		else
+		{
+			Entries.pop_back();
+		}
+	}
+
+	void SiftUp(int32 Position)
+	{
+		const FEntry Moving = Entries[Position];
+		while (Position > 0)
+		{
+			const int32 ParentPosition = (Position - 1) / Arity;
+			if (!(Moving.Key < Entries[ParentPosition].Key))
+			{
+				break;
+			}
+			Entries[Position] = Entries[ParentPosition];
+			Positions[Entries[Position].Item] = Position;
+			Position = ParentPosition;
+		}
+		Entries[Position] = Moving;
+		Positions[Moving.Item] = Position;
+	}
+
+	void SiftDown(int32 Position)
+	{
+		const int32 Count = (int32)Entries.size();
+		const FEntry Moving = Entries[Position];
+		while (true)
+		{
+			const int32 FirstChild = Position * Arity + 1;
+			if (FirstChild >= Count)
+			{
+				break;
+			}
+
+			//Find the smallest child
+			const int32 LastChild = FirstChild + Arity < Count ? FirstChild + Arity : Count;
+			int32 BestChild = FirstChild;
+			for (int32 Child = FirstChild + 1; Child < LastChild; Child++)
+			{
+				if (Entries[Child].Key < Entries[BestChild].Key)
+				{
+					BestChild = Child;
+				}
+			}
+
+			if (!(Entries[BestChild].Key < Moving.Key))
+			{
+				break;
+			}
+			Entries[Position] = Entries[BestChild];
+			Positions[Entries[Position].Item] = Position;
+			Position = BestChild;
+		}
+		Entries[Position] = Moving;
+		Positions[Moving.Item] = Position;
+	}
+
+	/** Heap ordered entries */
+	std::vector<FEntry> Entries;
+
+	/** Slot of each item in Entries, InvalidPosition when it isn't in the heap */
+	std::vector<int32> Positions;
+};
@@ -0,0 +1,480 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "JumpPointSearch.h"
+#include "GridGraph.h"
+#include "GridSearch.h"
+#include "GridMemory.h"
+#include <algorithm>
+
+namespace JumpPoint
+{
+	const int32 DirectionX[(int32)EJumpDirection::Count] = { 0, 0, -1, 1 };
+	const int32 DirectionY[(int32)EJumpDirection::Count] = { 1, -1, 0, 0 };
+
+	bool IsOpen(const FGridGraph& Graph, int32 X, int32 Y)
+	{
+		return Graph.IsValidCoord(X, Y) && Graph.IsWalkable(Graph.GetIndex(X, Y));
+	}
+
+	/** Arriving at X,Y with a horizontal step, is the cell StepY above/below only reachable through here */
+	bool HasForcedVertical(const FGridGraph& Graph, int32 X, int32 Y, int32 StepX, int32 StepY)
+	{
+		return IsOpen(Graph, X, Y + StepY) && !IsOpen(Graph, X - StepX, Y + StepY);
+	}
+
+	int32 JumpHorizontal(const FGridGraph& Graph, int32 X, int32 Y, int32 StepX, int32 Goal)
+	{
+		while (true)
+		{
+			X += StepX;
+			if (!IsOpen(Graph, X, Y))
+			{
+				return GridInvalidIndex;
+			}
+
+			const int32 Index = Graph.GetIndex(X, Y);
+			if ((Index == Goal) || HasForcedVertical(Graph, X, Y, StepX, 1) || HasForcedVertical(Graph, X, Y, StepX, -1))
+			{
+				return Index;
+			}
+		}
+	}
+
+	int32 JumpVertical(const FGridGraph& Graph, int32 X, int32 Y, int32 StepY, int32 Goal)
+	{
+		while (true)
+		{
+			Y += StepY;
+			if (!IsOpen(Graph, X, Y))
+			{
+				return GridInvalidIndex;
+			}
+
+			//Vertical steps stop wherever a sideways scan would find something
+			const int32 Index = Graph.GetIndex(X, Y);
+			if ((Index == Goal) || (JumpHorizontal(Graph, X, Y, 1, Goal) != GridInvalidIndex) || (JumpHorizontal(Graph, X, Y, -1, Goal) != GridInvalidIndex))
+			{
+				return Index;
+			}
+		}
+	}
+
+	/** Same jump as JumpHorizontal/JumpVertical, but read from the JPS+ table */
+	int32 JumpWithTable(const FGridGraph& Graph, const FJumpPointTable& Table, int32 Index, EJumpDirection Direction, int32 Goal)
+	{
+		const int32 X = Graph.GetX(Index);
+		const int32 Y = Graph.GetY(Index);
+		const int32 StepX = DirectionX[(int32)Direction];
+		const int32 StepY = DirectionY[(int32)Direction];
+		const int32 Jump = Table.GetJump(Index, Direction);
+		const int32 OpenSteps = Jump > 0 ? Jump : -Jump;
+
+		if (StepX != 0)
+		{
+			//The goal sits on this row before the next jump point or wall
+			const int32 GoalSteps = (Graph.GetX(Goal) - X) * StepX;
+			if ((Graph.GetY(Goal) == Y) && (GoalSteps > 0) && (GoalSteps <= OpenSteps))
+			{
+				return Goal;
+			}
+			return Jump > 0 ? Graph.GetIndex(X + Jump * StepX, Y) : GridInvalidIndex;
+		}
+
+		//Stop on the goal's row so the sideways scan from there can find it
+		const int32 GoalSteps = (Graph.GetY(Goal) - Y) * StepY;
+		if ((GoalSteps > 0) && (GoalSteps <= OpenSteps))
+		{
+			return Graph.GetIndex(X, Graph.GetY(Goal));
+		}
+		return Jump > 0 ? Graph.GetIndex(X, Y + Jump * StepY) : GridInvalidIndex;
+	}
+}
+
+void FJumpPointTable::Rebuild(const FGridGraph& Graph)
+{
+	Width = Graph.GetWidth();
+	Height = Graph.GetHeight();
+
+	//Jump lengths are stored as int16
+	bBuilt = (Width < 0x7fff) && (Height < 0x7fff);
+	if (!bBuilt)
+	{
+		return;
+	}
+
+	for (std::vector<int16>& DirectionJumps : Jumps)
+	{
+		DirectionJumps.assign(Graph.Num(), 0);
+	}
+
+	//Vertical jumps depend on the horizontal ones, so every row goes first
+	for (int32 Y = 0; Y < Height; Y++)
+	{
+		BuildRow(Graph, Y);
+	}
+	for (int32 X = 0; X < Width; X++)
+	{
+		BuildColumn(Graph, X);
+	}
+}
+
+int64 FJumpPointTable::GetAllocatedBytes() const
+{
+	int64 Bytes = 0;
+	for (const std::vector<int16>& DirectionJumps : Jumps)
+	{
+		Bytes += GridMemory::GetAllocatedBytes(DirectionJumps);
+	}
+	return Bytes;
+}
+
+void FJumpPointTable::EnsureBuilt(const FGridGraph& Graph)
+{
+	if (!bBuilt || (Width != Graph.GetWidth()) || (Height != Graph.GetHeight()))
+	{
+		Rebuild(Graph);
+	}
+}
+
+void FJumpPointTable::UpdateCell(const FGridGraph& Graph, int32 Index)
+{
+	if (!bBuilt)
+	{
+		return;
+	}
+
+	const int32 CellX = Graph.GetX(Index);
+	const int32 CellY = Graph.GetY(Index);
+	const int32 MinY = std::max(CellY - 1, 0);
+	const int32 MaxY = std::min(CellY + 1, Height - 1);
+
+	//Forced neighbors look one row up and down, so the edited row and both of its neighbors can change
+	std::vector<uint8> HadJump;
+	HadJump.reserve((MaxY - MinY + 1) * Width);
+	for (int32 Y = MinY; Y <= MaxY; Y++)
+	{
+		for (int32 X = 0; X < Width; X++)
+		{
+			HadJump.push_back(HasHorizontalJump(Graph.GetIndex(X, Y)));
+		}
+	}
+
+	for (int32 Y = MinY; Y <= MaxY; Y++)
+	{
+		BuildRow(Graph, Y);
+	}
+
+	//Columns only need repairing where the cell itself changed or a horizontal jump point appeared/disappeared
+	std::vector<int32> ChangedMinY(Width, Height);
+	std::vector<int32> ChangedMaxY(Width, -1);
+	ChangedMinY[CellX] = CellY;
+	ChangedMaxY[CellX] = CellY;
+	int32 Slot = 0;
+	for (int32 Y = MinY; Y <= MaxY; Y++)
+	{
+		for (int32 X = 0; X < Width; X++, Slot++)
+		{
+			if (HadJump[Slot] != (uint8)HasHorizontalJump(Graph.GetIndex(X, Y)))
+			{
+				ChangedMinY[X] = std::min(ChangedMinY[X], Y);
+				ChangedMaxY[X] = std::max(ChangedMaxY[X], Y);
+			}
+		}
+	}
+
+	for (int32 X = 0; X < Width; X++)
+	{
+		if (ChangedMaxY[X] >= 0)
+		{
+			RepairColumn(Graph, X, ChangedMinY[X], ChangedMaxY[X]);
+		}
+	}
+}
+
+void FJumpPointTable::BuildRow(const FGridGraph& Graph, int32 Y)
+{
+	std::vector<int16>& East = Jumps[(int32)EJumpDirection::East];
+	std::vector<int16>& West = Jumps[(int32)EJumpDirection::West];
+
+	//Each cell's jump is its neighbor's plus one step, so sweep against the direction of travel
+	for (int32 X = Width - 1; X >= 0; X--)
+	{
+		const int32 Index = Graph.GetIndex(X, Y);
+		if (!JumpPoint::IsOpen(Graph, X + 1, Y))
+		{
+			East[Index] = 0;
+		}
+		else if (JumpPoint::HasForcedVertical(Graph, X + 1, Y, 1, 1) || JumpPoint::HasForcedVertical(Graph, X + 1, Y, 1, -1))
+		{
+			East[Index] = 1;
+		}
+		else
+		{
+			East[Index] = (int16)(East[Index + 1] > 0 ? East[Index + 1] + 1 : East[Index + 1] - 1);
+		}
+	}
+
+	for (int32 X = 0; X < Width; X++)
+	{
+		const int32 Index = Graph.GetIndex(X, Y);
+		if (!JumpPoint::IsOpen(Graph, X - 1, Y))
+		{
+			West[Index] = 0;
+		}
+		else if (JumpPoint::HasForcedVertical(Graph, X - 1, Y, -1, 1) || JumpPoint::HasForcedVertical(Graph, X - 1, Y, -1, -1))
+		{
+			West[Index] = 1;
+		}
+		else
+		{
+			West[Index] = (int16)(West[Index - 1] > 0 ? West[Index - 1] + 1 : West[Index - 1] - 1);
+		}
+	}
+}
+
+void FJumpPointTable::BuildColumn(const FGridGraph& Graph, int32 X)
+{
+	std::vector<int16>& North = Jumps[(int32)EJumpDirection::North];
+	std::vector<int16>& South = Jumps[(int32)EJumpDirection::South];
+
+	for (int32 Y = Height - 1; Y >= 0; Y--)
+	{
+		const int32 Index = Graph.GetIndex(X, Y);
+		const int32 Next = Index + Width;
+		if (!JumpPoint::IsOpen(Graph, X, Y + 1))
+		{
+			North[Index] = 0;
+		}
+		else if (HasHorizontalJump(Next))
+		{
+			North[Index] = 1;
+		}
+		else
+		{
+			North[Index] = (int16)(North[Next] > 0 ? North[Next] + 1 : North[Next] - 1);
+		}
+	}
+
+	for (int32 Y = 0; Y < Height; Y++)
+	{
+		const int32 Index = Graph.GetIndex(X, Y);
+		const int32 Next = Index - Width;
+		if (!JumpPoint::IsOpen(Graph, X, Y - 1))
+		{
+			South[Index] = 0;
+		}
+		else if (HasHorizontalJump(Next))
+		{
+			South[Index] = 1;
+		}
+		else
+		{
+			South[Index] = (int16)(South[Next] > 0 ? South[Next] + 1 : South[Next] - 1);
+		}
+	}
+}
+
+void FJumpPointTable::RepairColumn(const FGridGraph& Graph, int32 X, int32 ChangedMinY, int32 ChangedMaxY)
+{
+	std::vector<int16>& North = Jumps[(int32)EJumpDirection::North];
+	std::vector<int16>& South = Jumps[(int32)EJumpDirection::South];
+
+	//A vertical jump only depends on the cell after it, so a change at row Y ripples away from Y
+	//until the recomputed value matches the old one
+	for (int32 Y = ChangedMaxY - 1; Y >= 0; Y--)
+	{
+		const int32 Index = Graph.GetIndex(X, Y);
+		const int32 Next = Index + Width;
+		int16 Jump;
+		if (!JumpPoint::IsOpen(Graph, X, Y + 1))
+		{
+			Jump = 0;
+		}
+		else if (HasHorizontalJump(Next))
+		{
+			Jump = 1;
+		}
+		else
+		{
+			Jump = (int16)(North[Next] > 0 ? North[Next] + 1 : North[Next] - 1);
+		}
+
+		if ((Jump == North[Index]) && (Y < ChangedMinY))
+		{
+			break;
+		}
+		North[Index] = Jump;
+	}
+
+	for (int32 Y = ChangedMinY + 1; Y < Height; Y++)
+	{
+		const int32 Index = Graph.GetIndex(X, Y);
+		const int32 Next = Index - Width;
+		int16 Jump;
+		if (!JumpPoint::IsOpen(Graph, X, Y - 1))
+		{
+			Jump = 0;
+		}
+		else if (HasHorizontalJump(Next))
+		{
+			Jump = 1;
+		}
+		else
+		{
+			Jump = (int16)(South[Next] > 0 ? South[Next] + 1 : South[Next] - 1);
+		}
+
+		if ((Jump == South[Index]) && (Y > ChangedMaxY))
+		{
+			break;
+		}
+		South[Index] = Jump;
+	}
+}
+
+bool FJumpPointTable::HasHorizontalJump(int32 Index) const
+{
+	return (Jumps[(int32)EJumpDirection::East][Index] > 0) || (Jumps[(int32)EJumpDirection::West][Index] > 0);
+}
+
+bool FGridSearch::RunJumpPoint(const FGridGraph& Graph, int32 Start, int32 Goal, const FJumpPointTable* Table, FGridSearchResult& OutResult)
+{
+	//Jumping over cells only works when every step costs the same, and the jumps are 4-connected
+	if ((Graph.GetMinCost() != Graph.GetMaxCost()) || (Topology != EGridTopology::Four))
+	{
+		return Run(Graph, Start, Goal, EGridSearchAlgorithm::AStar, OutResult);
+	}
+
+	OutResult.Reset();
+	Prepare(Graph);
+
+	if (!Graph.IsValidIndex(Start) || !Graph.IsValidIndex(Goal) || Graph.IsWall(Start) || Graph.IsWall(Goal))
+	{
+		return false;
+	}
+
+	if ((Table != nullptr) && !Table->IsBuilt())
+	{
+		Table = nullptr;
+	}
+
+	const int32 StepCost = Graph.GetMinCost();
+	Heap.Reset(Graph.Num());
+	SetDistance(Start, 0);
+	Heap.Push(Start, Graph.GetManhattanDistance(Start, Goal) * StepCost);
+
+	while (!Heap.IsEmpty())
+	{
+		if (ShouldCancel(OutResult))
+		{
+			return false;
+		}
+
+		OutResult.PeakOpenListSize = std::max(OutResult.PeakOpenListSize, Heap.Num());
+		const int32 Current = Heap.Pop();
+		Closed[Current] = 1;
+		OutResult.NodesExpanded++;
+		if (bRecordVisitedOrder)
+		{
+			OutResult.VisitedOrder.push_back(Current);
+		}
+
+		if (Current == Goal)
+		{
+			BuildJumpPath(Graph, Goal, StepCost, OutResult);
+			return true;
+		}
+
+		const int32 X = Graph.GetX(Current);
+		const int32 Y = Graph.GetY(Current);
+
+		//Prune the directions by how we got here: vertical arrivals go on and scan sideways,
+		//horizontal arrivals go on and only turn where a neighbor is forced
+		EJumpDirection Directions[4];
+		int32 NumDirections = 0;
+		const int32 From = Parent[Current];
+		if (From == GridInvalidIndex)
+		{
+			Directions[NumDirections++] = EJumpDirection::North;
+			Directions[NumDirections++] = EJumpDirection::South;
+			Directions[NumDirections++] = EJumpDirection::West;
+			Directions[NumDirections++] = EJumpDirection::East;
+		}
+		else if (Graph.GetX(From) == X)
+		{
+			Directions[NumDirections++] = Y > Graph.GetY(From) ? EJumpDirection::North : EJumpDirection::South;
+			Directions[NumDirections++] = EJumpDirection::West;
+			Directions[NumDirections++] = EJumpDirection::East;
+		}
+		else
+		{
+			const int32 StepX = X > Graph.GetX(From) ? 1 : -1;
+			Directions[NumDirections++] = StepX > 0 ? EJumpDirection::East : EJumpDirection::West;
+			if (JumpPoint::HasForcedVertical(Graph, X, Y, StepX, 1))
+			{
+				Directions[NumDirections++] = EJumpDirection::North;
+			}
+			if (JumpPoint::HasForcedVertical(Graph, X, Y, StepX, -1))
+			{
+				Directions[NumDirections++] = EJumpDirection::South;
+			}
+		}
+
+		for (int32 i = 0; i < NumDirections; i++)
+		{
+			const EJumpDirection Direction = Directions[i];
+			int32 Jump;
+			if (Table != nullptr)
+			{
+				Jump = JumpPoint::JumpWithTable(Graph, *Table, Current, Direction, Goal);
+			}
+			else if (JumpPoint::DirectionX[(int32)Direction] != 0)
+			{
+				Jump = JumpPoint::JumpHorizontal(Graph, X, Y, JumpPoint::DirectionX[(int32)Direction], Goal);
+			}
+			else
+			{
+				Jump = JumpPoint::JumpVertical(Graph, X, Y, JumpPoint::DirectionY[(int32)Direction], Goal);
+			}
+
+			if ((Jump == GridInvalidIndex) || Closed[Jump])
+			{
+				continue;
+			}
+
+			const int32 NewDistance = Distance[Current] + Graph.GetManhattanDistance(Current, Jump) * StepCost;
+			if (NewDistance < Distance[Jump])
+			{
+				SetDistance(Jump, NewDistance);
+				Parent[Jump] = Current;
+				Heap.Push(Jump, NewDistance + Graph.GetManhattanDistance(Jump, Goal) * StepCost);
+			}
+		}
+	}
+
+	return false;
+}
+
+void FGridSearch::BuildJumpPath(const FGridGraph& Graph, int32 Goal, int32 StepCost, FGridSearchResult& OutResult)
+{
+	OutResult.bFound = true;
+	OutResult.Cost = Distance[Goal];
+
+	//Parent links join jump points with straight lines, fill in the cells between them
+	int32 Index = Goal;
+	for (; Parent[Index] != GridInvalidIndex; Index = Parent[Index])
+	{
+		const int32 From = Parent[Index];
+		const int32 Step = Graph.GetY(Index) == Graph.GetY(From) ? (Index > From ? 1 : -1) : (Index > From ? Graph.GetWidth() : -Graph.GetWidth());
+		for (int32 Cell = Index; Cell != From; Cell -= Step)
+		{
+			if (Cell != Index)
+			{
+				SetDistance(Cell, Distance[From] + Graph.GetManhattanDistance(From, Cell) * StepCost);
+			}
+			OutResult.Path.push_back(Cell);
+		}
+	}
+	OutResult.Path.push_back(Index);
+	std::reverse(OutResult.Path.begin(), OutResult.Path.end());
+}
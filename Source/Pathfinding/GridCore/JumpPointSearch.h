@@ -0,0 +1,71 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "GridTypes.h"
+#include <vector>
+
+class FGridGraph;
+
+/**
+ * Jump Point Search on the 4-connected grid.
+ *
+ * Paths are made canonical by going vertical first: a vertical step scans left and right and stops when either
+ * scan finds a jump point, while a horizontal step only stops at the goal, a wall, or a cell with a forced neighbor
+ * (the cell above/below is open but the one behind it is blocked). Only those cells reach the open list, which
+ * gives the same path lengths as A* while expanding far fewer nodes on open, uniform-cost boards.
+ */
+enum class EJumpDirection : uint8
+{
+	North,	// +Y
+	South,	// -Y
+	West,	// -X
+	East,	// +X
+	Count
+};
+
+/**
+ * Precomputed jump distances for JPS+.
+ * For each cell and direction: a positive value is the number of steps to the next jump point, zero or a negative
+ * value is minus the number of open steps before a wall. Goal checks are still done at query time.
+ * Kept up to date cell by cell with UpdateCell, which redoes the three affected rows and repairs columns only
+ * where their jump points moved.
+ */
+class FJumpPointTable
+{
+public:
+	/** Compute every distance from scratch */
+	void Rebuild(const FGridGraph& Graph);
+
+	/** Repair the table after the wall state of one cell changed */
+	void UpdateCell(const FGridGraph& Graph, int32 Index);
+
+	/** Mark the table stale so the next EnsureBuilt does a full rebuild, for bulk edits */
+	void Invalidate() { bBuilt = false; }
+
+	/** Rebuild if the table is stale or was built for a different size */
+	void EnsureBuilt(const FGridGraph& Graph);
+
+	bool IsBuilt() const { return bBuilt; }
+
+	int32 GetJump(int32 Index, EJumpDirection Direction) const { return Jumps[(int32)Direction][Index]; }
+
+	int64 GetAllocatedBytes() const;
+
+private:
+	void BuildRow(const FGridGraph& Graph, int32 Y);
+	void BuildColumn(const FGridGraph& Graph, int32 X);
+
+	/** Recompute the vertical jumps of column X around rows ChangedMinY..ChangedMaxY, stopping once values settle */
+	void RepairColumn(const FGridGraph& Graph, int32 X, int32 ChangedMinY, int32 ChangedMaxY);
+
+	/** Does a horizontal jump from this cell lead to a jump point in either direction */
+	bool HasHorizontalJump(int32 Index) const;
+
+	/** One array per EJumpDirection */
+	std::vector<int16> Jumps[(int32)EJumpDirection::Count];
+
+	int32 Width = 0;
+	int32 Height = 0;
+	bool bBuilt = false;
+};
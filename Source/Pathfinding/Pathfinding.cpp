@@ -1,6 +1,34 @@
 // Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
 
 #include "Pathfinding.h"
+#include "PathfindingStats.h"
 #include "Modules/ModuleManager.h"
 
+DEFINE_STAT(STAT_PathfindingRenderStateRebuilds);
+DEFINE_STAT(STAT_PathfindingParameterWrites);
+DEFINE_STAT(STAT_PathfindingCrowdUpdate);
+DEFINE_STAT(STAT_PathfindingCrowdRender);
+DEFINE_STAT(STAT_PathfindingCrowdAgents);
+DEFINE_STAT(STAT_PathfindingCrowdMoving);
+DEFINE_STAT(STAT_PathfindingCrowdWaiting);
+DEFINE_STAT(STAT_PathfindingSearch);
+DEFINE_STAT(STAT_PathfindingShowSearch);
+DEFINE_STAT(STAT_PathfindingShortestPath);
+DEFINE_STAT(STAT_PathfindingGenerateMaze);
+DEFINE_STAT(STAT_PathfindingResetBoard);
+DEFINE_STAT(STAT_PathfindingFlowFieldBuild);
+DEFINE_STAT(STAT_PathfindingGridTick);
+DEFINE_STAT(STAT_PathfindingPlayback);
+DEFINE_STAT(STAT_PathfindingLivePath);
+DEFINE_STAT(STAT_PathfindingPawnTrace);
+DEFINE_STAT(STAT_PathfindingNodesExpanded);
+DEFINE_STAT(STAT_PathfindingTraces);
+DEFINE_STAT(STAT_PathfindingMaterialSwaps);
+DEFINE_STAT(STAT_PathfindingGraphMemory);
+DEFINE_STAT(STAT_PathfindingSearchMemory);
+DEFINE_STAT(STAT_PathfindingFlowFieldMemory);
+DEFINE_STAT(STAT_PathfindingCrowdMemory);
+DEFINE_STAT(STAT_PathfindingPathCacheMemory);
+DEFINE_STAT(STAT_PathfindingStreamingMemory);
+
 IMPLEMENT_PRIMARY_GAME_MODULE(FDefaultGameModuleImpl, Pathfinding, "Pathfinding");
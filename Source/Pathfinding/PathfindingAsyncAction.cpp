@@ -0,0 +1,56 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "PathfindingAsyncAction.h"
+
+UFindPathAsyncAction* UFindPathAsyncAction::FindPathAsync(UObject* WorldContextObject, APathfindingBlockGrid* Grid, APathfindingBlock* StartBlock, APathfindingBlock* EndBlock,
+	EPathAlgorithm Algorithm, EPathQueryPriority Priority)
+{
+	UFindPathAsyncAction* Action = NewObject<UFindPathAsyncAction>();
+	Action->Grid = Grid;
+	Action->StartBlock = StartBlock;
+	Action->EndBlock = EndBlock;
+	Action->Algorithm = Algorithm;
+	Action->Priority = Priority;
+	Action->RegisterWithGameInstance(WorldContextObject);
+	return Action;
+}
+
+void UFindPathAsyncAction::Activate()
+{
+	if ((Grid == nullptr) || (StartBlock == nullptr) || (EndBlock == nullptr))
+	{
+		Failed.Broadcast(FPathQueryResult());
+		SetReadyToDestroy();
+		return;
+	}
+
+	//The grid only calls back while it is alive, and RegisterWithGameInstance keeps us alive until then
+	TWeakObjectPtr<UFindPathAsyncAction> WeakAction(this);
+	Handle = Grid->RequestPath(StartBlock->GridIndex, EndBlock->GridIndex, static_cast<EGridSearchAlgorithm>(Algorithm), static_cast<EGridQueryPriority>(Priority),
+		[WeakAction](const FPathQueryResult& Result)
+		{
+			UFindPathAsyncAction* Action = WeakAction.Get();
+			if (Action == nullptr)
+			{
+				return;
+			}
+
+			if (Result.bFound)
+			{
+				Action->Found.Broadcast(Result);
+			}
+			else
+			{
+				Action->Failed.Broadcast(Result);
+			}
+			Action->SetReadyToDestroy();
+		});
+}
+
+void UFindPathAsyncAction::Cancel()
+{
+	if ((Grid != nullptr) && (Handle != 0))
+	{
+		Grid->CancelPathQuery(Handle);
+	}
+}
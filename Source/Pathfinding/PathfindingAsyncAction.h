@@ -0,0 +1,50 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "PathfindingBlockGrid.h"
+#include "PathfindingAsyncAction.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FPathQueryOutputPin, const FPathQueryResult&, Result);
+
+/** Latent Blueprint node for APathfindingBlockGrid::FindPathAsync */
+UCLASS()
+class UFindPathAsyncAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+
+public:
+	/** Search between two blocks on a worker thread, Found or Failed fires on the game thread when it is done */
+	UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"))
+	static UFindPathAsyncAction* FindPathAsync(UObject* WorldContextObject, APathfindingBlockGrid* Grid, APathfindingBlock* StartBlock, APathfindingBlock* EndBlock,
+		EPathAlgorithm Algorithm = EPathAlgorithm::AStar, EPathQueryPriority Priority = EPathQueryPriority::Normal);
+
+	/** Stop the query, Failed fires with bCancelled set */
+	UFUNCTION(BlueprintCallable)
+	void Cancel();
+
+	UPROPERTY(BlueprintAssignable)
+	FPathQueryOutputPin Found;
+
+	/** No path, or the query was cancelled */
+	UPROPERTY(BlueprintAssignable)
+	FPathQueryOutputPin Failed;
+
+	virtual void Activate() override;
+
+private:
+	UPROPERTY()
+	APathfindingBlockGrid* Grid;
+
+	UPROPERTY()
+	APathfindingBlock* StartBlock;
+
+	UPROPERTY()
+	APathfindingBlock* EndBlock;
+
+	EPathAlgorithm Algorithm;
+	EPathQueryPriority Priority;
+	int32 Handle = 0;
+};
@@ -0,0 +1,200 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "PathfindingBenchmarkCommandlet.h"
+#include "GridCore/GridBenchmark.h"
+#include "GridCore/GridGraph.h"
+#include "GridCore/GridScenario.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+namespace PathfindingBenchmark
+{
+	/** Parse a comma separated -Name=1,2,3 list, Values is left alone if the switch isn't there */
+	template <typename ValueType>
+	void ParseList(const FString& Params, const TCHAR* Name, std::vector<ValueType>& Values)
+	{
+		FString List;
+		if (!FParse::Value(*Params, Name, List, false))
+		{
+			return;
+		}
+
+		TArray<FString> Items;
+		List.ParseIntoArray(Items, TEXT(","));
+		Values.clear();
+		for (const FString& Item : Items)
+		{
+			Values.push_back((ValueType)FCString::Atoi(*Item));
+		}
+	}
+
+	/** Check every query of a MovingAI scenario with every mode, see the class comment. Returns the commandlet's exit code */
+	int32 RunScenario(const FString& Params, const FString& ScenarioPath, const FString& OutputDirectory)
+	{
+		std::vector<FGridScenarioQuery> Queries;
+		if (!FGridScenario::ReadScenario(TCHAR_TO_UTF8(*FPaths::ConvertRelativePathToFull(ScenarioPath)), Queries))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Couldn't read the scenario %s"), *ScenarioPath);
+			return 1;
+		}
+
+		//Maps are looked up by file name next to the scenario unless -mapdir says otherwise
+		FString MapDirectory = FPaths::GetPath(ScenarioPath);
+		FString CsvPath = OutputDirectory / TEXT("Scenario.csv");
+		FParse::Value(*Params, TEXT("mapdir="), MapDirectory);
+		FParse::Value(*Params, TEXT("csv="), CsvPath);
+
+		std::vector<EGridBenchmarkMode> Modes;
+		for (int32 Mode = 0; Mode < (int32)EGridBenchmarkMode::Num; Mode++)
+		{
+			Modes.push_back(static_cast<EGridBenchmarkMode>(Mode));
+		}
+
+		//Scenario files usually cover one map, each map is loaded once however the queries are spread
+		FGridScenarioReport Report;
+		std::vector<bool> bDone(Queries.size(), false);
+		for (size_t First = 0; First < Queries.size(); First++)
+		{
+			if (bDone[First])
+			{
+				continue;
+			}
+
+			std::vector<FGridScenarioQuery> MapQueries;
+			std::vector<int32> QueryIndices;
+			for (size_t i = First; i < Queries.size(); i++)
+			{
+				if (Queries[i].Map == Queries[First].Map)
+				{
+					MapQueries.push_back(Queries[i]);
+					QueryIndices.push_back((int32)i);
+					bDone[i] = true;
+				}
+			}
+
+			const FString MapPath = FPaths::ConvertRelativePathToFull(MapDirectory / FPaths::GetCleanFilename(ANSI_TO_TCHAR(Queries[First].Map.c_str())));
+			FGridGraph Graph;
+			if (!FGridScenario::ReadMap(TCHAR_TO_UTF8(*MapPath), Graph))
+			{
+				UE_LOG(LogTemp, Error, TEXT("Couldn't read the map %s"), *MapPath);
+				return 1;
+			}
+
+			const FGridScenarioReport MapReport = FGridScenario::Run(Graph, MapQueries, Modes);
+			Report.Buckets.insert(Report.Buckets.end(), MapReport.Buckets.begin(), MapReport.Buckets.end());
+			for (FGridScenarioFailure Failure : MapReport.Failures)
+			{
+				Failure.Query = QueryIndices[Failure.Query];
+				Report.Failures.push_back(Failure);
+			}
+		}
+
+		for (const FGridScenarioBucketStats& Stats : Report.Buckets)
+		{
+			const double NumQueries = FMath::Max(Stats.NumQueries, 1);
+			UE_LOG(LogTemp, Display, TEXT("%s %s bucket %d: %d queries, %.3f ms mean, %.3f ms max, %.0f expanded mean, %d suboptimal"),
+				ANSI_TO_TCHAR(Stats.Map.c_str()), ANSI_TO_TCHAR(GetBenchmarkModeName(Stats.Mode)), Stats.Bucket, Stats.NumQueries,
+				Stats.TotalMilliseconds / NumQueries, Stats.MaxMilliseconds, Stats.NodesExpanded / NumQueries, Stats.NumSuboptimal);
+		}
+		for (const FGridScenarioFailure& Failure : Report.Failures)
+		{
+			const FGridScenarioQuery& Query = Queries[Failure.Query];
+			UE_LOG(LogTemp, Error, TEXT("Query %d on %s, (%d, %d) -> (%d, %d), published %.4f: %s gave %d, reference %d, %s"),
+				Failure.Query, ANSI_TO_TCHAR(Query.Map.c_str()), Query.StartX, Query.StartY, Query.GoalX, Query.GoalY, Query.OptimalLength,
+				ANSI_TO_TCHAR(Failure.Mode.c_str()), Failure.Cost, Failure.ReferenceCost, ANSI_TO_TCHAR(Failure.Reason.c_str()));
+		}
+
+		CsvPath = FPaths::ConvertRelativePathToFull(CsvPath);
+		if (!FGridScenario::WriteCsv(TCHAR_TO_UTF8(*CsvPath), Report))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Couldn't write the results to %s"), *CsvPath);
+			return 1;
+		}
+		UE_LOG(LogTemp, Display, TEXT("%d queries, %d failures, buckets written to %s"), (int32)Queries.size(), (int32)Report.Failures.size(), *CsvPath);
+		return Report.Failures.empty() ? 0 : 1;
+	}
+}
+
+UPathfindingBenchmarkCommandlet::UPathfindingBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+	ShowErrorCount = true;
+}
+
+int32 UPathfindingBenchmarkCommandlet::Main(const FString& Params)
+{
+	const FString OutputDirectory = FPaths::ProjectSavedDir() / TEXT("Pathfinding");
+	IFileManager::Get().MakeDirectory(*OutputDirectory, true);
+
+	FString ScenarioPath;
+	if (FParse::Value(*Params, TEXT("scen="), ScenarioPath))
+	{
+		return PathfindingBenchmark::RunScenario(Params, ScenarioPath, OutputDirectory);
+	}
+
+	FGridBenchmarkSuiteSettings Settings;
+	PathfindingBenchmark::ParseList(Params, TEXT("sizes="), Settings.Sizes);
+	PathfindingBenchmark::ParseList(Params, TEXT("seeds="), Settings.Seeds);
+	FParse::Value(*Params, TEXT("iterations="), Settings.Iterations);
+	FParse::Value(*Params, TEXT("density="), Settings.ObstacleDensity);
+	FParse::Value(*Params, TEXT("braid="), Settings.BraidFraction);
+
+	FString CsvPath = OutputDirectory / TEXT("Benchmark.csv");
+	FString JsonPath = OutputDirectory / TEXT("Benchmark.json");
+	FString BaselinePath;
+	FParse::Value(*Params, TEXT("csv="), CsvPath);
+	FParse::Value(*Params, TEXT("json="), JsonPath);
+	FParse::Value(*Params, TEXT("baseline="), BaselinePath);
+
+	const std::vector<FGridBenchmarkRecord> Records = FGridBenchmark::RunSuite(Settings, [](const FGridBenchmarkRecord& Record)
+	{
+		UE_LOG(LogTemp, Display, TEXT("%s %d seed %u %s: %.3f ms, %d expanded, peak open %d, %lld bytes, cost %d"),
+			ANSI_TO_TCHAR(Record.Map.c_str()), Record.Size, Record.Seed, ANSI_TO_TCHAR(Record.Mode.c_str()), Record.Milliseconds,
+			Record.NodesExpanded, Record.PeakOpenListSize, Record.Bytes, Record.bFound ? Record.Cost : -1);
+	});
+
+	CsvPath = FPaths::ConvertRelativePathToFull(CsvPath);
+	JsonPath = FPaths::ConvertRelativePathToFull(JsonPath);
+	if (!FGridBenchmark::WriteCsv(TCHAR_TO_UTF8(*CsvPath), Records) || !FGridBenchmark::WriteJson(TCHAR_TO_UTF8(*JsonPath), Records))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Couldn't write the results to %s and %s"), *CsvPath, *JsonPath);
+		return 1;
+	}
+	UE_LOG(LogTemp, Display, TEXT("%d cases written to %s and %s"), (int32)Records.size(), *CsvPath, *JsonPath);
+
+	if (BaselinePath.IsEmpty())
+	{
+		return 0;
+	}
+
+	std::vector<FGridBenchmarkRecord> Baseline;
+	if (!FGridBenchmark::ReadCsv(TCHAR_TO_UTF8(*FPaths::ConvertRelativePathToFull(BaselinePath)), Baseline))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Couldn't read the baseline %s"), *BaselinePath);
+		return 1;
+	}
+
+	FGridBenchmarkThresholds Thresholds;
+	FParse::Value(*Params, TEXT("maxtimeratio="), Thresholds.MaxTimeRatio);
+	FParse::Value(*Params, TEXT("mingatedms="), Thresholds.MinGatedMilliseconds);
+	FParse::Value(*Params, TEXT("maxnodesratio="), Thresholds.MaxNodesRatio);
+	FParse::Value(*Params, TEXT("maxpeakratio="), Thresholds.MaxPeakOpenListRatio);
+	FParse::Value(*Params, TEXT("maxbytesratio="), Thresholds.MaxBytesRatio);
+
+	const std::vector<FGridBenchmarkRegression> Regressions = FGridBenchmark::FindRegressions(Records, Baseline, Thresholds);
+	for (const FGridBenchmarkRegression& Regression : Regressions)
+	{
+		if (Regression.Metric == "missing")
+		{
+			UE_LOG(LogTemp, Error, TEXT("Regression in %s: in the baseline but not run"), ANSI_TO_TCHAR(Regression.Key.c_str()));
+			continue;
+		}
+		UE_LOG(LogTemp, Error, TEXT("Regression in %s: %s went from %.3f to %.3f"),
+			ANSI_TO_TCHAR(Regression.Key.c_str()), ANSI_TO_TCHAR(Regression.Metric.c_str()), Regression.Baseline, Regression.Current);
+	}
+	UE_LOG(LogTemp, Display, TEXT("%d regressions against %s"), (int32)Regressions.size(), *BaselinePath);
+	return Regressions.empty() ? 0 : 1;
+}
@@ -0,0 +1,31 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "PathfindingBenchmarkCommandlet.generated.h"
+
+/**
+ * Runs FGridBenchmark::RunSuite headless and writes CSV and JSON results, no world or renderer needed:
+ *   UE4Editor-Cmd Pathfinding.uproject -run=PathfindingBenchmark -nullrhi [-sizes=25,256,4096] [-seeds=1,2] [-iterations=3]
+ *     [-csv=Out.csv] [-json=Out.json] [-baseline=Old.csv] [-maxtimeratio=1.25] [-maxnodesratio=1] [-maxpeakratio=1] [-maxbytesratio=1.1]
+ * Results default to Saved/Pathfinding/Benchmark.csv/.json. With -baseline every regression is logged as an error and
+ * the commandlet returns 1, so a build step can gate on it.
+ * With -scen=Arena.map.scen it checks a MovingAI scenario instead, see FGridScenario:
+ *   UE4Editor-Cmd Pathfinding.uproject -run=PathfindingBenchmark -nullrhi -scen=scen/arena.map.scen [-mapdir=maps] [-csv=Out.csv]
+ * Every query runs with every mode, per bucket timing and expansions go to Saved/Pathfinding/Scenario.csv, and any
+ * wrong or broken path is logged as an error and makes the commandlet return 1.
+ */
+UCLASS()
+class UPathfindingBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UPathfindingBenchmarkCommandlet();
+
+	// Begin UCommandlet interface
+	virtual int32 Main(const FString& Params) override;
+	// End UCommandlet interface
+};
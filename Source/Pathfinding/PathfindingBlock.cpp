@@ -2,12 +2,14 @@
 
 #include "PathfindingBlock.h"
 #include "PathfindingBlockGrid.h"
+#include "PathfindingCellMaterial.h"
 #include "UObject/ConstructorHelpers.h"
 #include "Components/StaticMeshComponent.h"
 #include "Engine/StaticMesh.h"
 #include "Materials/MaterialInstance.h"
 #include "UObject/NameTypes.h"
 #include "InputCoreTypes.h"
+#include "PathfindingStats.h"
 
 APathfindingBlock::APathfindingBlock()
 {
@@ -21,6 +23,7 @@ APathfindingBlock::APathfindingBlock()
 		ConstructorHelpers::FObjectFinderOptional<UMaterialInstance> StartMaterial;
 		ConstructorHelpers::FObjectFinderOptional<UMaterialInstance> EndMaterial;
 		ConstructorHelpers::FObjectFinderOptional<UMaterialInstance> PathMaterial;
+		ConstructorHelpers::FObjectFinderOptional<UMaterial> GoalFrontierMaterial;
 		FConstructorStatics()
 			: PlaneMesh(TEXT("/Game/Puzzle/Meshes/PuzzleCube.PuzzleCube"))
 			, BaseMaterial(TEXT("/Game/Puzzle/Meshes/BaseMaterial.BaseMaterial"))
@@ -29,6 +32,7 @@ APathfindingBlock::APathfindingBlock()
 			, StartMaterial(TEXT("/Game/Puzzle/Meshes/GoldMaterial.GoldMaterial"))
 			, EndMaterial(TEXT("/Game/Puzzle/Meshes/M_Tech_Hex_Tile_Pulse_Inst.M_Tech_Hex_Tile_Pulse_Inst"))
 			, PathMaterial(TEXT("/Game/Puzzle/Meshes/PathMaterial.PathMaterial"))
+			, GoalFrontierMaterial(TEXT("/Game/StarterContent/Materials/M_Metal_Copper.M_Metal_Copper"))
 		{
 		}
 	};
@@ -56,48 +60,23 @@ APathfindingBlock::APathfindingBlock()
 	StartMaterial = ConstructorStatics.StartMaterial.Get();
 	EndMaterial = ConstructorStatics.EndMaterial.Get();
 	PathMaterial = ConstructorStatics.PathMaterial.Get();
+	GoalFrontierMaterial = ConstructorStatics.GoalFrontierMaterial.Get();
+	//Found in BeginPlay, the shared material may have to be built and that can't happen in a constructor
+	CellMaterial = nullptr;
+	Visual = EPathCellVisual::Open;
 
-	PrimaryActorTick.bCanEverTick = true;
-	bIsHighlightTimeSet = false;
-	SetActorTickEnabled(false);
+	//The grid's playback drives search highlighting, blocks never tick
+	PrimaryActorTick.bCanEverTick = false;
 
 	Distance = 9999;
 	bVisited = false;
+	bVisitedFromGoal = false;
 	bIsWall = false;
 	bIsStart = false;
 	bIsEnd = false;
 	bIsEdgeWall = false;
-	bMazeVisited = false;
-}
-
-//Called every frame
-void APathfindingBlock::Tick(float DeltaTime)
-{
-	//Need to update to also be based on heuristic, to highlight when it is visited/looked at?
-	if (!bIsHighlightTimeSet)
-	{
-		bIsHighlightTimeSet = true;
-		HighlightTime = Distance - (Distance / 1.15);
-		PathStartTime = OwningGrid->EndDistance - (OwningGrid->EndDistance / 1.15) + 0.5;
-		PathTime = PathStartTime + (HighlightTime - (HighlightTime/2));
-	}
-
-	RunningTime += DeltaTime;
-
-	if ((bIsHighlightTimeSet) && (RunningTime >= HighlightTime))
-	{
-		Highlight(true);
-	}
-	else
-	{
-		//UE_LOG(LogTemp, Warning, TEXT("Highlight Time Set = %s"), bIsHighlightTimeSet ? TEXT("true") : TEXT("false"));
-		//UE_LOG(LogTemp, Warning, TEXT("Running Time = %f"), RunningTime);
-	}
-
-	if (bIsShortestPath && (RunningTime > PathTime))
-	{
-		BlockMesh->SetMaterial(0, PathMaterial);
-	}
+	GridIndex = 0;
+	Cost = 1;
 }
 
 void APathfindingBlock::BlockClicked(UPrimitiveComponent* ClickedComp, FKey ButtonClicked)
@@ -122,9 +101,15 @@ void APathfindingBlock::HandleClicked(FString HighlightType)
 		// Change material
 		if (HighlightType == "Wall")
 		{
-			BlockMesh->SetMaterial(0, WallMaterial);
+			SetVisual(EPathCellVisual::Wall);
 			BlockMesh->SetCollisionResponseToChannel(ECC_GameTraceChannel4, ECR_Ignore);
 			bIsWall = true;
+
+			if (OwningGrid != nullptr)
+			{
+				OwningGrid->Graph.SetWall(GridIndex, true);
+				OwningGrid->OnCellChanged(GridIndex);
+			}
 		}
 		else if (HighlightType == "Start")
 		{
@@ -133,16 +118,21 @@ void APathfindingBlock::HandleClicked(FString HighlightType)
 				if (Block->bIsStart == true)
 				{
 					Block->bIsStart = false;
-					Block->BlockMesh->SetMaterial(0, BlueMaterial);
+					Block->SetVisual(EPathCellVisual::Open);
 					Block->bIsActive = false;
 					Block->Distance = 9999;
 				}
 
 			}
 
-			BlockMesh->SetMaterial(0, StartMaterial);
+			SetVisual(EPathCellVisual::Start);
 			Distance = 0;
 			bIsStart = true;
+
+			if (OwningGrid != nullptr)
+			{
+				OwningGrid->Graph.SetStart(GridIndex);
+			}
 		}
 		else if (HighlightType == "End")
 		{
@@ -152,38 +142,31 @@ void APathfindingBlock::HandleClicked(FString HighlightType)
 				if (Block->bIsEnd == true)
 				{
 					Block->bIsEnd = false;
-					Block->BlockMesh->SetMaterial(0, BlueMaterial);
+					Block->SetVisual(EPathCellVisual::Open);
 					Block->bIsActive = false;
 				}
 				
 			}
 
-			BlockMesh->SetMaterial(0, EndMaterial);
+			SetVisual(EPathCellVisual::End);
 			bIsEnd = true;
 			OwningGrid->EndBlock = this;
 			OwningGrid->EndLocation = GetActorLocation();
-			
+			OwningGrid->Graph.SetGoal(GridIndex);
 		}
 		else if (HighlightType == "Reset")
 		{
-			SetActorTickEnabled(false);
-			HighlightTime = 0;
-			PathTime = 0;
-			PathStartTime = 0;
-			bIsHighlightTimeSet = false;
-			RunningTime = 0;
-			bIsShortestPath = false;
-			bVisited = false;
-
-			BlockMesh->SetMaterial(0, BlueMaterial);
-			bIsActive = false;
-			bIsWall = false;
-			bIsStart = false;
-			bIsEnd = false;
-			bIsEdgeWall = false;
-			bMazeVisited = false;
-			Distance = 9999;
-			MazeIndex = 0;
+			const bool bWasWall = bIsWall;
+			ClearState();
+
+			if (OwningGrid != nullptr)
+			{
+				OwningGrid->Graph.ResetCell(GridIndex);
+				if (bWasWall)
+				{
+					OwningGrid->OnCellChanged(GridIndex);
+				}
+			}
 		}
 
 		// Tell the Grid
@@ -196,24 +179,17 @@ void APathfindingBlock::HandleClicked(FString HighlightType)
 	{
 		if (HighlightType == "Reset")
 		{
-			SetActorTickEnabled(false);
-			HighlightTime = 0;
-			PathTime = 0;
-			PathStartTime = 0;
-			bIsHighlightTimeSet = false;
-			RunningTime = 0;
-			bIsShortestPath = false;
-			bVisited = false;
-
-			BlockMesh->SetMaterial(0, BlueMaterial);
-			bIsActive = false;
-			bIsWall = false;
-			bIsStart = false;
-			bIsEnd = false;
-			bIsEdgeWall = false;
-			bMazeVisited = false;
-			Distance = 9999;
-			MazeIndex = 0;
+			const bool bWasWall = bIsWall;
+			ClearState();
+
+			if (OwningGrid != nullptr)
+			{
+				OwningGrid->Graph.ResetCell(GridIndex);
+				if (bWasWall)
+				{
+					OwningGrid->OnCellChanged(GridIndex);
+				}
+			}
 		}
 	}
 }
@@ -228,10 +204,172 @@ void APathfindingBlock::Highlight(bool bOn)
 
 	if (bOn)
 	{
-		BlockMesh->SetMaterial(0, BaseMaterial);
+		SetVisual(bVisitedFromGoal ? EPathCellVisual::VisitedFromGoal : EPathCellVisual::Visited);
+	}
+	else
+	{
+		SetVisual(EPathCellVisual::Open);
+	}
+}
+
+void APathfindingBlock::ShowLivePath(bool bOn)
+{
+	if (bIsActive)
+	{
+		return;
+	}
+
+	if (bOn)
+	{
+		SetVisual(EPathCellVisual::Path);
+	}
+	else
+	{
+		Highlight(bVisited);
+	}
+}
+
+void APathfindingBlock::SetSearchVisual(EPathCellVisual NewVisual)
+{
+	if (bIsActive)
+	{
+		return;
+	}
+
+	bIsShortestPath = NewVisual == EPathCellVisual::Path;
+	SetVisual(NewVisual);
+}
+
+void APathfindingBlock::SetVisual(EPathCellVisual NewVisual)
+{
+	if (Visual != NewVisual)
+	{
+		Visual = NewVisual;
+		ApplyVisual();
+	}
+}
+
+void APathfindingBlock::SetHeat(float Heat)
+{
+	if (CellMaterial != nullptr)
+	{
+		BlockMesh->SetCustomPrimitiveDataFloat(PathfindingCellData::Heat, Heat);
+		INC_DWORD_STAT(STAT_PathfindingParameterWrites);
+	}
+}
+
+void APathfindingBlock::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (CellMaterial == nullptr)
+	{
+		CellMaterial = PathfindingCellMaterial::Get();
+	}
+	if (CellMaterial != nullptr)
+	{
+		//The only material the block gets, every look change after this is a custom data write
+		BlockMesh->SetMaterial(0, CellMaterial);
+	}
+
+	//Custom data starts out empty
+	ApplyVisual();
+}
+
+void APathfindingBlock::ApplyVisual()
+{
+	if (CellMaterial != nullptr)
+	{
+		//Updates the primitive's uniform data in place, the mesh draw commands stay cached
+		const FLinearColor Color = UPathfindingCellRenderer::GetDefaultCellColor(Visual);
+		BlockMesh->SetCustomPrimitiveDataVector3(PathfindingCellData::Red, FVector(Color.R, Color.G, Color.B));
+		INC_DWORD_STAT(STAT_PathfindingParameterWrites);
 	}
 	else
 	{
-		BlockMesh->SetMaterial(0, BlueMaterial);
+		BlockMesh->SetMaterial(0, GetVisualMaterial(Visual));
+		INC_DWORD_STAT(STAT_PathfindingRenderStateRebuilds);
+		INC_DWORD_STAT(STAT_PathfindingMaterialSwaps);
 	}
-}
\ No newline at end of file
+}
+
+UMaterialInterface* APathfindingBlock::GetVisualMaterial(EPathCellVisual ForVisual) const
+{
+	switch (ForVisual)
+	{
+	case EPathCellVisual::Wall:
+		return WallMaterial;
+	case EPathCellVisual::Start:
+		return StartMaterial;
+	case EPathCellVisual::End:
+		return EndMaterial;
+	case EPathCellVisual::Visited:
+		return BaseMaterial;
+	case EPathCellVisual::VisitedFromGoal:
+		return GoalFrontierMaterial;
+	case EPathCellVisual::Path:
+		return PathMaterial;
+	default:
+		return BlueMaterial;
+	}
+}
+
+void APathfindingBlock::SetCost(int32 NewCost)
+{
+	Cost = FMath::Clamp(NewCost, 1, (int32)FGridGraph::MaxCellCost);
+	ApplyCostHeight();
+
+	if (OwningGrid != nullptr)
+	{
+		OwningGrid->Graph.SetCost(GridIndex, Cost);
+		OwningGrid->OnCellCostChanged(GridIndex);
+	}
+}
+
+void APathfindingBlock::ApplyGraphState(const FGridGraph& Graph)
+{
+	if (Graph.IsWall(GridIndex))
+	{
+		//Same look and flags a wall click gives, without SetWall and OnCellChanged
+		const int32 X = Graph.GetX(GridIndex);
+		const int32 Y = Graph.GetY(GridIndex);
+		bIsActive = true;
+		bIsWall = true;
+		bIsEdgeWall = (X == 0) || (Y == 0) || (X == Graph.GetWidth() - 1) || (Y == Graph.GetHeight() - 1);
+		SetVisual(EPathCellVisual::Wall);
+		BlockMesh->SetCollisionResponseToChannel(ECC_GameTraceChannel4, ECR_Ignore);
+	}
+	else if (bIsWall)
+	{
+		bIsActive = false;
+		bIsWall = false;
+		bIsEdgeWall = false;
+		SetVisual(EPathCellVisual::Open);
+		BlockMesh->SetCollisionResponseToChannel(ECC_GameTraceChannel4, ECR_Block);
+	}
+
+	Cost = Graph.GetCost(GridIndex);
+	ApplyCostHeight();
+}
+
+void APathfindingBlock::ClearState()
+{
+	bIsShortestPath = false;
+	bVisited = false;
+	bVisitedFromGoal = false;
+
+	SetVisual(EPathCellVisual::Open);
+	SetHeat(0.f);
+	bIsActive = false;
+	bIsWall = false;
+	bIsStart = false;
+	bIsEnd = false;
+	bIsEdgeWall = false;
+	Distance = 9999;
+}
+
+void APathfindingBlock::ApplyCostHeight()
+{
+	// Costlier blocks stand taller so painted terrain is visible
+	BlockMesh->SetRelativeScale3D(FVector(0.25f, 0.25f, 1.0f + (Cost - 1) * 0.05f));
+}
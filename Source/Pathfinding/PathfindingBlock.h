@@ -4,8 +4,11 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "PathfindingCellRenderer.h"
 #include "PathfindingBlock.generated.h"
 
+class FGridGraph;
+
 /** A block that can be clicked */
 UCLASS(minimalapi)
 class APathfindingBlock : public AActor
@@ -23,30 +26,16 @@ class APathfindingBlock : public AActor
 public:
 	APathfindingBlock();
 
-	// Called every frame
-	virtual void Tick(float DeltaTime) override;
-
-	UPROPERTY(Category = Highlight, VisibleAnywhere, BlueprintReadWrite)
-	float HighlightTime = 0;
-
-	UPROPERTY(Category = Highlight, VisibleAnywhere, BlueprintReadWrite)
-	float PathTime = 0;
-
-	UPROPERTY(Category = Highlight, VisibleAnywhere, BlueprintReadWrite)
-	float PathStartTime = 0;
-
-	UPROPERTY(Category = Highlight, VisibleAnywhere, BlueprintReadWrite)
-	bool bIsHighlightTimeSet;
-
-	UPROPERTY(Category = Highlight, VisibleAnywhere, BlueprintReadWrite)
-	float RunningTime;
-
 	/** Are we currently active? */
 	bool bIsActive;
 
 	UPROPERTY(Category = Algorithm, VisibleAnywhere, BlueprintReadWrite)
 	bool bVisited;
 
+	/** Reached by the backward half of a bidirectional search, highlighted with GoalFrontierMaterial */
+	UPROPERTY(Category = Algorithm, VisibleAnywhere, BlueprintReadWrite)
+	bool bVisitedFromGoal;
+
 	UPROPERTY(Category = Algorithm, VisibleAnywhere, BlueprintReadWrite)
 	float Distance;
 
@@ -68,11 +57,13 @@ public:
 	UPROPERTY(Category = Algorithm, VisibleAnywhere, BlueprintReadOnly)
 	bool bIsShortestPath;
 
+	/** Index of this block in the owning grid's BlockArray and graph */
 	UPROPERTY(Category = Algorithm, VisibleAnywhere, BlueprintReadOnly)
-	bool bMazeVisited;
+	int32 GridIndex;
 
+	/** Cost of stepping onto this block in weighted searches */
 	UPROPERTY(Category = Algorithm, VisibleAnywhere, BlueprintReadOnly)
-	int MazeIndex;
+	int32 Cost;
 
 	/** Pointer to white material used on the focused block */
 	UPROPERTY()
@@ -98,6 +89,21 @@ public:
 	UPROPERTY()
 	class UMaterialInstance* PathMaterial;
 
+	/** Pointer to copper material used on blocks the backward search of a bidirectional search visited */
+	UPROPERTY()
+	class UMaterial* GoalFrontierMaterial;
+
+	/**
+	 * Shared material reading color and heat from custom primitive data, laid out as in PathfindingCellData, see
+	 * PathfindingCellMaterial. When it is there every look change is a data write; without it blocks swap between the materials above
+	 */
+	UPROPERTY()
+	class UMaterialInterface* CellMaterial;
+
+	/** What the block shows right now */
+	UPROPERTY(Category = Highlight, VisibleAnywhere, BlueprintReadOnly)
+	EPathCellVisual Visual;
+
 	/** Grid that owns us */
 	UPROPERTY()
 	class APathfindingBlockGrid* OwningGrid;
@@ -114,6 +120,44 @@ public:
 
 	void Highlight(bool bOn);
 
+	/** Put the path material on or take it off again, for the grid's live path. Start, end and walls keep theirs */
+	void ShowLivePath(bool bOn);
+
+	/** Show a step of the grid's search playback. Start, end and walls keep their materials */
+	void SetSearchVisual(EPathCellVisual NewVisual);
+
+	/** Change what the block shows, through CellMaterial's data if there is one */
+	void SetVisual(EPathCellVisual NewVisual);
+
+	/** Distance shading of a visited block, 0 to 1. Only shows with CellMaterial */
+	void SetHeat(float Heat);
+
+	/** Set the traversal cost, mirror it into the grid graph and raise the block to show it */
+	void SetCost(int32 NewCost);
+
+	/**
+	 * Show the wall state and cost Graph already holds for this block: look, collision, flags and height. Unlike
+	 * HandleClicked and SetCost nothing is written back and the grid isn't told, for boards filled in one go
+	 */
+	void ApplyGraphState(const FGridGraph& Graph);
+
+	/** Drop the search marks, heat and start or end flags. Leaves the graph alone, HandleClicked("Reset") clears the cell there too */
+	void ClearState();
+
+protected:
+	// Begin AActor interface
+	virtual void BeginPlay() override;
+	// End AActor interface
+
+private:
+	/** Write Visual to the mesh, as custom data or as a material */
+	void ApplyVisual();
+
+	/** Scale the block to Cost's height */
+	void ApplyCostHeight();
+
+	class UMaterialInterface* GetVisualMaterial(EPathCellVisual ForVisual) const;
+
 public:
 	/** Returns DummyRoot subobject **/
 	FORCEINLINE class USceneComponent* GetDummyRoot() const { return DummyRoot; }
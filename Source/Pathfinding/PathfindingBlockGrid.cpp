@@ -2,12 +2,24 @@
 
 #include "PathfindingBlockGrid.h"
 #include "PathfindingBlock.h"
+#include "PathfindingStats.h"
 #include "Components/TextRenderComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
 #include "Engine/World.h"
 #include "Kismet/GameplayStatics.h"
 #include "DrawDebugHelpers.h"
 #include "GameFramework/Actor.h"
 #include "TimerManager.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "GridCore/GridBenchmark.h"
+#include "GridCore/GridFile.h"
+#include "GridCore/GridScenario.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Async/MappedFileHandle.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
 
 #define LOCTEXT_NAMESPACE "PuzzleBlockGrid"
 
@@ -24,251 +36,1225 @@ APathfindingBlockGrid::APathfindingBlockGrid()
 	ScoreText->SetText(FText::Format(LOCTEXT("ScoreFmt", "Score: {0}"), FText::AsNumber(0)));
 	ScoreText->SetupAttachment(DummyRoot);
 
+	// Create instanced cells, only filled when bUseInstancedCells is set
+	CellRenderer = CreateDefaultSubobject<UPathfindingCellRenderer>(TEXT("CellRenderer0"));
+	CellRenderer->SetupAttachment(DummyRoot);
+
+	// Create the crowd's instances, filled by SpawnCrowd
+	CrowdRenderer = CreateDefaultSubobject<UInstancedStaticMeshComponent>(TEXT("CrowdRenderer0"));
+	CrowdRenderer->SetupAttachment(DummyRoot);
+	CrowdRenderer->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	CrowdRenderer->SetCastShadow(false);
+
 	// Set defaults
 	Size = 25;
 	BlockSpacing = 75.f;
+	bUseInstancedCells = false;
+	bDone = false;
+	OpenList = EPathOpenList::Heap;
+	Topology = EPathTopology::Four;
+	bUseJumpPointTable = true;
+	bUseBitsetSearch = false;
+	HierarchyClusterSize = FGridHierarchy::DefaultClusterSize;
+	PathCacheCapacity = FGridPathCache::DefaultCapacity;
+	StreamedChunkSize = 64;
+	MaxResidentChunks = 1024;
+	AgentSpeed = 4.f;
+	CrowdRepathInterval = 0.5f;
+	LivePathCost = 0;
+	LivePathNodesExpanded = 0;
+	PlaybackDuration = 4.f;
+	PlaybackSpeed = 0.f;
+	MaxPlaybackUpdatesPerFrame = 4096;
+
+	//Only ticks while a search plays back, a live path is shown or a crowd walks
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+	Queries = std::make_shared<FGridQueryQueue>();
+}
+
+void APathfindingBlockGrid::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Number of blocks
+	const int32 NumBlocks = Size * Size;
+	Graph.Init(Size, Size);
+	PathCache.Clear();
+	PathCache.SetCapacity(PathCacheCapacity);
+	Crowd.Reset(Graph);
+	if (CrowdRenderer->GetStaticMesh() == nullptr)
+	{
+		CrowdRenderer->SetStaticMesh(CellRenderer->GetStaticMesh());
+	}
+
+	if (bUseInstancedCells)
+	{
+		CellRenderer->BuildCells(Size, Size, BlockSpacing);
+		return;
+	}
+
+	// Loop to spawn each block
+	for(int32 BlockIndex=0; BlockIndex<NumBlocks; BlockIndex++)
+	{
+		const float XOffset = (BlockIndex/Size) * BlockSpacing; // Divide by dimension
+		const float YOffset = (BlockIndex%Size) * BlockSpacing; // Modulo gives remainder
+
+		// Make position vector, offset from Grid location
+		const FVector BlockLocation = FVector(XOffset, YOffset, 0.f) + GetActorLocation();
+
+		// Spawn a block
+		APathfindingBlock* NewBlock = GetWorld()->SpawnActor<APathfindingBlock>(BlockLocation, FRotator(0,0,0));
+		BlockArray.Add(NewBlock);
+
+		// Tell the block about its owner
+		if (NewBlock != nullptr)
+		{
+			NewBlock->OwningGrid = this;
+			NewBlock->GridIndex = BlockIndex;
+		}
+	}
+}
+
+void APathfindingBlockGrid::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	//Running workers stop at their next cancel check, their results are dropped since the grid is gone
+	Queries->CancelAll();
+	Queries->ReleaseSearches();
+	QueryCallbacks.Empty();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void APathfindingBlockGrid::Tick(float DeltaSeconds)
+{
+	PATHFINDING_SCOPE_CYCLE_COUNTER(STAT_PathfindingGridTick);
+	Super::Tick(DeltaSeconds);
+
+	if (!Playback.IsFinished())
+	{
+		PATHFINDING_SCOPE_CYCLE_COUNTER(STAT_PathfindingPlayback);
+		Playback.SetSpeed(GetPlaybackRate());
+		Playback.Advance(DeltaSeconds, MaxPlaybackUpdatesPerFrame, [this](int32 Index, EGridPlaybackVisual Visual)
+		{
+			ApplyPlaybackVisual(Index, Visual);
+		});
+	}
+
+	if (bLivePathActive)
+	{
+		TickLivePath();
+	}
+
+	if (bCrowdActive)
+	{
+		TickCrowd(DeltaSeconds);
+	}
+
+	UpdateTickEnabled();
+}
+
+void APathfindingBlockGrid::TickLivePath()
+{
+	PATHFINDING_SCOPE_CYCLE_COUNTER(STAT_PathfindingLivePath);
+
+	//Start and end are picked on the blocks without telling the grid, so follow them here
+	const int32 Start = Graph.GetStart();
+	const int32 Goal = Graph.GetGoal();
+	if (Start == GridInvalidIndex || Goal == GridInvalidIndex)
+	{
+		ShowLivePath(std::vector<int32>());
+		return;
+	}
+	if (!LivePlanner.IsInitialized() || LivePlanner.GetGoal() != Goal)
+	{
+		LivePlanner.Initialize(Graph, Start, Goal);
+		bLivePathDirty = true;
+		UpdateMemoryStats();
+	}
+	else if (LivePlanner.GetStart() != Start)
+	{
+		LivePlanner.SetStart(Graph, Start);
+		bLivePathDirty = true;
+	}
+
+	if (bLivePathDirty)
+	{
+		bLivePathDirty = false;
+
+		FGridSearchResult Result;
+		LivePlanner.Replan(Graph, Result);
+		LivePathCost = Result.Cost;
+		LivePathNodesExpanded = Result.NodesExpanded;
+		INC_DWORD_STAT_BY(STAT_PathfindingNodesExpanded, Result.NodesExpanded);
+		ShowLivePath(Result.Path);
+	}
+}
+
+void APathfindingBlockGrid::AddScore()
+{
+	// Increment score
+	Score++;
+}
+
+void APathfindingBlockGrid::OnCellChanged(int32 Index)
+{
+	JumpTable.UpdateCell(Graph, Index);
+	BitsetSearch.UpdateCell(Graph, Index);
+	FlowField.OnCellChanged(Graph, Index);
+	Hierarchy.OnCellChanged(Index);
+	PathCache.OnCellChanged(Graph, Index);
+	GraphSnapshot.reset();
+	WakeCrowd();
+
+	if (bLivePathActive)
+	{
+		LivePlanner.OnCellChanged(Graph, Index);
+		bLivePathDirty = true;
+	}
+}
+
+void APathfindingBlockGrid::OnCellCostChanged(int32 Index)
+{
+	//Jump tables only care about walls
+	Hierarchy.OnCellChanged(Index);
+	FlowField.OnCellChanged(Graph, Index);
+	PathCache.OnCellChanged(Graph, Index);
+	GraphSnapshot.reset();
+	WakeCrowd();
+
+	if (bLivePathActive)
+	{
+		LivePlanner.OnCellChanged(Graph, Index);
+		bLivePathDirty = true;
+	}
+}
+
+void APathfindingBlockGrid::ResetBoard()
+{
+	PATHFINDING_SCOPE_CYCLE_COUNTER(STAT_PathfindingResetBoard);
+
+	//Drop everything built from the graph first, so clearing it doesn't repair each structure cell by cell
+	JumpTable.Invalidate();
+	BitsetSearch.Invalidate();
+	FlowField.Clear();
+	Hierarchy.Invalidate();
+	PathCache.Clear();
+	GraphSnapshot.reset();
+	LivePlanner = FGridIncrementalSearch();
+	ShowLivePath(std::vector<int32>());
+	ClearCrowd();
+	Playback.Clear();
+	LastSearch.Reset();
+	VisitedNodesInOrder.Empty();
+	UnvisitedNodes.Empty();
+	bDone = false;
+	bPathAvailable = false;
+
+	//Clear the graph in one go, blocks only show it and write nothing back
+	Graph.Clear();
+	for (auto& Block : BlockArray)
+	{
+		Block->ApplyGraphState(Graph);
+		Block->ClearState();
+	}
+	if (bUseInstancedCells)
+	{
+		CellRenderer->BuildCells(Size, Size, BlockSpacing);
+	}
+	UpdateMemoryStats();
+}
+
+void APathfindingBlockGrid::UpdateMemoryStats()
+{
+	SET_MEMORY_STAT(STAT_PathfindingGraphMemory, Graph.Num());
+	SET_MEMORY_STAT(STAT_PathfindingSearchMemory,
+		Search.GetAllocatedBytes() + JumpTable.GetAllocatedBytes() + BitsetSearch.GetAllocatedBytes() + Hierarchy.GetAllocatedBytes()
+		+ LivePlanner.GetAllocatedBytes() + BatchSearch.GetAllocatedBytes() + Queries->GetIdleSearchBytes());
+	SET_MEMORY_STAT(STAT_PathfindingFlowFieldMemory, FlowField.GetAllocatedBytes());
+	SET_MEMORY_STAT(STAT_PathfindingCrowdMemory, Crowd.GetAllocatedBytes());
+	SET_MEMORY_STAT(STAT_PathfindingPathCacheMemory, PathCache.GetAllocatedBytes());
+	SET_MEMORY_STAT(STAT_PathfindingStreamingMemory, (StreamedMaze ? StreamedMaze->GetAllocatedBytes() : 0) + StreamedSearch.GetAllocatedBytes());
+}
+
+void APathfindingBlockGrid::ResetPathfinding()
+{
+	for (auto& Block : BlockArray)
+	{
+		if (!Block->bIsEnd && !Block->bIsStart && !Block->bIsWall)
+		{
+			Block->HandleClicked("Reset");
+		}
+	}
+
+	if (bUseInstancedCells)
+	{
+		for (int32 Index = 0; Index < CellRenderer->GetNumCells(); Index++)
+		{
+			const EPathCellVisual Visual = CellRenderer->GetCellVisual(Index);
+			if ((Visual == EPathCellVisual::Visited) || (Visual == EPathCellVisual::VisitedFromGoal) || (Visual == EPathCellVisual::Path))
+			{
+				CellRenderer->SetCellVisual(Index, EPathCellVisual::Open);
+				CellRenderer->SetCellHeat(Index, 0.f);
+			}
+		}
+	}
+
+	Playback.Clear();
+	LastSearch.Reset();
+	VisitedNodesInOrder.Empty();
+	UnvisitedNodes.Empty();
 	bDone = false;
+	bPathAvailable = false;
+}
+
+TArray<APathfindingBlock*> APathfindingBlockGrid::DijkstraAlgorithm(TArray<APathfindingBlock*> Array)
+{
+	//Array is kept for existing Blueprint callers, the search runs over every block through Graph
+	return RunSearch(EGridSearchAlgorithm::Dijkstra);
+}
+
+TArray<APathfindingBlock*> APathfindingBlockGrid::AStarAlgorithm(TArray<APathfindingBlock*> Array)
+{
+	return RunSearch(EGridSearchAlgorithm::AStar);
+}
+
+TArray<APathfindingBlock*> APathfindingBlockGrid::BidirectionalDijkstraAlgorithm(TArray<APathfindingBlock*> Array)
+{
+	return RunSearch(EGridSearchAlgorithm::BidirectionalDijkstra);
+}
+
+TArray<APathfindingBlock*> APathfindingBlockGrid::BidirectionalAStarAlgorithm(TArray<APathfindingBlock*> Array)
+{
+	return RunSearch(EGridSearchAlgorithm::BidirectionalAStar);
+}
+
+TArray<APathfindingBlock*> APathfindingBlockGrid::JumpPointSearch(TArray<APathfindingBlock*> Array)
+{
+	return RunSearch(EGridSearchAlgorithm::JumpPoint);
+}
+
+TArray<APathfindingBlock*> APathfindingBlockGrid::RunSearch(EGridSearchAlgorithm Algorithm)
+{
+	if (bDone)
+	{
+		return VisitedNodesInOrder;
+	}
+
+	PATHFINDING_SCOPE_CYCLE_COUNTER(STAT_PathfindingSearch);
+	const bool bFourConnected = Topology == EPathTopology::Four;
+	Search.SetTopology(static_cast<EGridTopology>(Topology));
+	if (Algorithm == EGridSearchAlgorithm::JumpPoint)
+	{
+		if (Graph.GetMinCost() != Graph.GetMaxCost())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Jump Point Search needs uniform costs, running A* instead"));
+		}
+		else if (!bFourConnected)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Jump Point Search is 4-connected, running A* instead"));
+		}
+
+		if (bUseJumpPointTable)
+		{
+			JumpTable.EnsureBuilt(Graph);
+		}
+		Search.RunJumpPoint(Graph, Graph.GetStart(), Graph.GetGoal(), bUseJumpPointTable ? &JumpTable : nullptr, LastSearch);
+	}
+	else if ((Algorithm == EGridSearchAlgorithm::Dijkstra) && bFourConnected && bUseBitsetSearch && (Graph.GetMinCost() == Graph.GetMaxCost()))
+	{
+		//With equal costs Dijkstra is a breadth-first search, and distances are layers times the cost
+		BitsetSearch.Run(Graph, Graph.GetStart(), Graph.GetGoal(), LastSearch);
+		const int32 CellCost = Graph.GetMinCost();
+		return ShowLastSearch(
+			[this, CellCost](int32 Index) { const int32 Layer = BitsetSearch.GetDistance(Index); return Layer != GridUnreachable ? Layer * CellCost : GridUnreachable; },
+			[](int32 Index) { return GridUnreachable; },
+			false);
+	}
+	else
+	{
+		Search.Run(Graph, Algorithm, LastSearch, static_cast<EGridOpenList>(OpenList));
+	}
+	if (LastSearch.bTooLarge)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("The board is too large for this topology's distances to fit in 32 bits, nothing was searched"));
+	}
+
+	//FindPathCached shares this searcher and stays 4-connected
+	Search.SetTopology(EGridTopology::Four);
+	return ShowLastSearch(
+		[this](int32 Index) { return Search.GetDistance(Index); },
+		[this](int32 Index) { return Search.GetDistanceFromGoal(Index); },
+		Algorithm != EGridSearchAlgorithm::Dijkstra);
+}
+
+TArray<APathfindingBlock*> APathfindingBlockGrid::HierarchicalSearch(TArray<APathfindingBlock*> Array)
+{
+	if (bDone)
+	{
+		return VisitedNodesInOrder;
+	}
+
+	PATHFINDING_SCOPE_CYCLE_COUNTER(STAT_PathfindingSearch);
+	if (!Hierarchy.IsBuilt() || (Hierarchy.GetClusterSize() != HierarchyClusterSize))
+	{
+		Hierarchy.Build(Graph, HierarchyClusterSize);
+	}
+	Hierarchy.FindPath(Graph, Graph.GetStart(), Graph.GetGoal(), LastSearch);
+
+	//Only cluster entrances are visited, so the path blocks are timed from their distance along the path
+	TArray<int32> PathDistances;
+	PathDistances.Init(GridUnreachable, Graph.Num());
+	int32 PathDistance = 0;
+	for (int32 Index : LastSearch.Path)
+	{
+		PathDistance += Index != Graph.GetStart() ? Graph.GetCost(Index) : 0;
+		PathDistances[Index] = PathDistance;
+	}
+
+	return ShowLastSearch(
+		[this, &PathDistances](int32 Index) { return FMath::Min(Hierarchy.GetDistance(Index), PathDistances[Index]); },
+		[](int32 Index) { return GridUnreachable; },
+		true);
+}
+
+TArray<APathfindingBlock*> APathfindingBlockGrid::ShowLastSearch(TFunctionRef<int32(int32)> GetDistanceFromStart, TFunctionRef<int32(int32)> GetDistanceFromGoal, bool bShowHeuristic)
+{
+	PATHFINDING_SCOPE_CYCLE_COUNTER(STAT_PathfindingShowSearch);
+	INC_DWORD_STAT_BY(STAT_PathfindingNodesExpanded, LastSearch.NodesExpanded);
+	UpdateMemoryStats();
+
+	TotalBlocksVisited = LastSearch.NodesExpanded;
+
+	const int32 Goal = Graph.GetGoal();
+
+	//Heat shades visited cells by their distance, relative to the farthest one
+	CellHeat.SetNumUninitialized(Graph.Num());
+	int32 MaxDistance = 1;
+	for (int32 Index = 0; Index < Graph.Num(); Index++)
+	{
+		const int32 Distance = FMath::Min(GetDistanceFromStart(Index), GetDistanceFromGoal(Index));
+		CellHeat[Index] = Distance != GridUnreachable ? (float)Distance : 0.f;
+		MaxDistance = FMath::Max(MaxDistance, Distance != GridUnreachable ? Distance : 0);
+	}
+	for (float& Heat : CellHeat)
+	{
+		Heat /= MaxDistance;
+	}
+
+	for (auto& Block : BlockArray)
+	{
+		//Blueprints sort on Distance, bidirectional searches measure it from the nearer end
+		const int32 DistanceFromStart = GetDistanceFromStart(Block->GridIndex);
+		const int32 DistanceFromGoal = GetDistanceFromGoal(Block->GridIndex);
+		const int32 BlockDistance = FMath::Min(DistanceFromStart, DistanceFromGoal);
+		if ((BlockDistance != GridUnreachable) && !Block->bIsStart)
+		{
+			Block->Distance = BlockDistance;
+			Block->bVisitedFromGoal = DistanceFromGoal < DistanceFromStart;
+		}
+
+		if (bShowHeuristic && (Goal != GridInvalidIndex))
+		{
+			Block->Heuristic = FGridSearch::GetHeuristic(Graph, Block->GridIndex, Goal);
+		}
+	}
+
+	for (int32 Index : LastSearch.VisitedOrder)
+	{
+		if (BlockArray.IsValidIndex(Index))
+		{
+			BlockArray[Index]->bVisited = true;
+			VisitedNodesInOrder.Add(BlockArray[Index]);
+		}
+	}
+
+	//The grid replays the search a bounded number of blocks per frame instead of every block ticking on its own
+	Playback.Build(LastSearch, Graph.Num(), Graph.GetStart(), Goal);
+	Playback.SetSpeed(GetPlaybackRate());
+	Playback.Play();
+	UpdateTickEnabled();
+
+	bDone = true;
+	if (LastSearch.bFound)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Found End at %i, %i"), Graph.GetX(Goal), Graph.GetY(Goal));
+		EndDistance = LastSearch.Cost;
+		bPathAvailable = true;
+		UE_LOG(LogTemp, Warning, TEXT("Number of Visited Blocks = %i"), TotalBlocksVisited);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Blocked Path"));
+	}
+
+	return VisitedNodesInOrder;
+}
+
+int32 APathfindingBlockGrid::FindPathAsync(APathfindingBlock* StartBlock, APathfindingBlock* EndBlock, EPathAlgorithm Algorithm, EPathQueryPriority Priority, const FOnPathQueryComplete& OnComplete)
+{
+	const int32 Start = StartBlock != nullptr ? StartBlock->GridIndex : GridInvalidIndex;
+	const int32 Goal = EndBlock != nullptr ? EndBlock->GridIndex : GridInvalidIndex;
+	return RequestPath(Start, Goal, static_cast<EGridSearchAlgorithm>(Algorithm), static_cast<EGridQueryPriority>(Priority),
+		[OnComplete](const FPathQueryResult& Result) { OnComplete.ExecuteIfBound(Result); });
+}
+
+int32 APathfindingBlockGrid::RequestPath(int32 Start, int32 Goal, EGridSearchAlgorithm Algorithm, EGridQueryPriority Priority, TFunction<void(const FPathQueryResult&)> OnComplete)
+{
+	FGridQuery Query;
+	Query.Start = Start;
+	Query.Goal = Goal;
+	Query.Algorithm = Algorithm;
+	Query.OpenList = static_cast<EGridOpenList>(OpenList);
+	Query.Priority = Priority;
+	Query.Graph = GetGraphSnapshot();
+	Query.GraphVersion = PathCache.GetVersion();
+
+	const int32 Handle = Queries->Push(MoveTemp(Query));
+	QueryCallbacks.Add(Handle, MoveTemp(OnComplete));
+
+	//One task per query, each runs whichever query is most urgent by the time it starts
+	std::shared_ptr<FGridQueryQueue> Queue = Queries;
+	TWeakObjectPtr<APathfindingBlockGrid> WeakGrid(this);
+	Async(EAsyncExecution::ThreadPool, [Queue, WeakGrid]()
+	{
+		FGridQuery Next;
+		if (!Queue->Pop(Next))
+		{
+			return;
+		}
+
+		//Scratch comes from the queue's pool, so it is shared by whichever tasks run and freed with the grid
+		std::unique_ptr<FGridSearch> Worker = Queue->AcquireSearch();
+		FGridSearchResult Result;
+		{
+			PATHFINDING_SCOPE_CYCLE_COUNTER(STAT_PathfindingSearch);
+			FGridQueryQueue::Execute(Next, *Worker, Result);
+		}
+		Queue->ReleaseSearch(std::move(Worker));
+		Queue->Finish(Next.Handle);
+
+		//Don't hold on to the snapshot while the result waits for the game thread
+		Next.Graph.reset();
+		AsyncTask(ENamedThreads::GameThread, [WeakGrid, Finished = MoveTemp(Next), Result = MoveTemp(Result)]()
+		{
+			if (APathfindingBlockGrid* Grid = WeakGrid.Get())
+			{
+				Grid->CompleteQuery(Finished, Result);
+			}
+		});
+	});
+
+	return Handle;
+}
+
+bool APathfindingBlockGrid::CancelPathQuery(int32 Handle)
+{
+	TFunction<void(const FPathQueryResult&)> Callback;
+	if (!QueryCallbacks.RemoveAndCopyValue(Handle, Callback))
+	{
+		return false;
+	}
+
+	Queries->Cancel(Handle);
+
+	FPathQueryResult Result;
+	Result.Handle = Handle;
+	Result.bCancelled = true;
+	Callback(Result);
+	return true;
+}
+
+void APathfindingBlockGrid::CompleteQuery(const FGridQuery& Query, const FGridSearchResult& Result)
+{
+	//Only kept if the board hasn't changed since the snapshot
+	PathCache.Add(Query.Start, Query.Goal, Query.Algorithm, Result, Query.GraphVersion);
+	INC_DWORD_STAT_BY(STAT_PathfindingNodesExpanded, Result.NodesExpanded);
+	UpdateMemoryStats();
+
+	//Cancelled queries already had their callback
+	TFunction<void(const FPathQueryResult&)> Callback;
+	if (!QueryCallbacks.RemoveAndCopyValue(Query.Handle, Callback))
+	{
+		return;
+	}
+
+	FPathQueryResult QueryResult;
+	FillQueryResult(Result, QueryResult);
+	QueryResult.Handle = Query.Handle;
+	Callback(QueryResult);
+}
+
+bool APathfindingBlockGrid::FindPathCached(APathfindingBlock* StartBlock, APathfindingBlock* EndBlock, EPathAlgorithm Algorithm, TArray<APathfindingBlock*>& OutPath, int32& OutCost)
+{
+	OutPath.Reset();
+	OutCost = 0;
+	if (StartBlock == nullptr || EndBlock == nullptr)
+	{
+		return false;
+	}
+
+	const int32 Start = StartBlock->GridIndex;
+	const int32 Goal = EndBlock->GridIndex;
+	const EGridSearchAlgorithm GridAlgorithm = static_cast<EGridSearchAlgorithm>(Algorithm);
+
+	const FGridCachedPath* Cached = PathCache.Find(Start, Goal, GridAlgorithm);
+	if (Cached == nullptr)
+	{
+		FGridSearchResult Result;
+		{
+			PATHFINDING_SCOPE_CYCLE_COUNTER(STAT_PathfindingSearch);
+			Search.SetRecordVisitedOrder(false);
+			Search.Run(Graph, Start, Goal, GridAlgorithm, Result, static_cast<EGridOpenList>(OpenList));
+			Search.SetRecordVisitedOrder(true);
+		}
+		INC_DWORD_STAT_BY(STAT_PathfindingNodesExpanded, Result.NodesExpanded);
+
+		PathCache.Add(Start, Goal, GridAlgorithm, Result, PathCache.GetVersion());
+		UpdateMemoryStats();
+
+		//Read from Result rather than finding the new entry, a second Find would count the miss as a hit too
+		OutCost = Result.Cost;
+		for (int32 Index : Result.Path)
+		{
+			if (BlockArray.IsValidIndex(Index))
+			{
+				OutPath.Add(BlockArray[Index]);
+			}
+		}
+		return Result.bFound;
+	}
+
+	OutCost = Cached->Cost;
+	for (int32 Index : Cached->Path)
+	{
+		if (BlockArray.IsValidIndex(Index))
+		{
+			OutPath.Add(BlockArray[Index]);
+		}
+	}
+	return Cached->bFound;
+}
+
+FPathCacheStats APathfindingBlockGrid::GetPathCacheStats() const
+{
+	const FGridPathCacheStats& CacheStats = PathCache.GetStats();
+
+	FPathCacheStats Stats;
+	Stats.Hits = (int32)CacheStats.Hits;
+	Stats.Misses = (int32)CacheStats.Misses;
+	Stats.Invalidations = (int32)CacheStats.Invalidations;
+	Stats.Evictions = (int32)CacheStats.Evictions;
+	Stats.NumCached = PathCache.Num();
+	Stats.Version = (int32)PathCache.GetVersion();
+	return Stats;
+}
+
+void APathfindingBlockGrid::ResetPathCacheStats()
+{
+	PathCache.ResetStats();
+}
+
+void APathfindingBlockGrid::FillQueryResult(const FGridSearchResult& Result, FPathQueryResult& OutResult) const
+{
+	OutResult.bFound = Result.bFound;
+	OutResult.bCancelled = Result.bCancelled;
+	OutResult.Cost = Result.Cost;
+
+	//The board may have been resized since the snapshot was taken
+	for (int32 Index : Result.Path)
+	{
+		if (BlockArray.IsValidIndex(Index))
+		{
+			OutResult.Path.Add(BlockArray[Index]);
+		}
+	}
+	for (int32 Index : Result.VisitedOrder)
+	{
+		if (BlockArray.IsValidIndex(Index))
+		{
+			OutResult.VisitedOrder.Add(BlockArray[Index]);
+		}
+	}
+}
+
+float APathfindingBlockGrid::SolvePathBatch(const TArray<APathfindingBlock*>& StartBlocks, const TArray<APathfindingBlock*>& EndBlocks, EPathAlgorithm Algorithm, TArray<FPathQueryResult>& OutResults)
+{
+	std::vector<FGridPathRequest> Requests;
+	Requests.reserve(FMath::Min(StartBlocks.Num(), EndBlocks.Num()));
+	for (int32 Index = 0; Index < StartBlocks.Num() && Index < EndBlocks.Num(); Index++)
+	{
+		FGridPathRequest Request;
+		Request.Start = StartBlocks[Index] != nullptr ? StartBlocks[Index]->GridIndex : GridInvalidIndex;
+		Request.Goal = EndBlocks[Index] != nullptr ? EndBlocks[Index]->GridIndex : GridInvalidIndex;
+		Requests.push_back(Request);
+	}
+
+	std::vector<FGridSearchResult> Results;
+	const FGridBatchStats Stats = RunBatch(Requests, static_cast<EGridSearchAlgorithm>(Algorithm), Results);
+
+	OutResults.Reset(Results.size());
+	for (const FGridSearchResult& Result : Results)
+	{
+		FillQueryResult(Result, OutResults.AddDefaulted_GetRef());
+	}
+
+	return (float)Stats.QueriesPerSecond;
+}
+
+void APathfindingBlockGrid::BenchmarkPathBatch(int32 NumQueries, EPathAlgorithm Algorithm)
+{
+	FRandomStream Random(NumQueries);
+	std::vector<FGridPathRequest> Requests(FMath::Max(NumQueries, 0));
+	for (FGridPathRequest& Request : Requests)
+	{
+		Request.Start = Random.RandHelper(Graph.Num());
+		Request.Goal = Random.RandHelper(Graph.Num());
+	}
+
+	std::vector<FGridSearchResult> Results;
+	const FGridBatchStats Stats = RunBatch(Requests, static_cast<EGridSearchAlgorithm>(Algorithm), Results);
+	UE_LOG(LogTemp, Warning, TEXT("%s batch: %i queries on %i workers in %.3f s, %.0f queries/s, %i found, %lld visited"),
+		ANSI_TO_TCHAR(GetAlgorithmName(static_cast<EGridSearchAlgorithm>(Algorithm))), Stats.NumQueries, Stats.NumWorkers,
+		Stats.Seconds, Stats.QueriesPerSecond, Stats.NumFound, Stats.NodesExpanded);
+}
+
+FGridBatchStats APathfindingBlockGrid::RunBatch(const std::vector<FGridPathRequest>& Requests, EGridSearchAlgorithm Algorithm, std::vector<FGridSearchResult>& OutResults)
+{
+	//Blocks aren't touched, every worker only reads Graph, so the batch runs on the task graph directly
+	PATHFINDING_SCOPE_CYCLE_COUNTER(STAT_PathfindingSearch);
+	const int32 NumWorkers = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+	const FGridBatchStats Stats = BatchSearch.Solve(Graph, Requests, Algorithm, static_cast<EGridOpenList>(OpenList), OutResults, NumWorkers, false,
+		[](int32 Count, const std::function<void(int32)>& Body)
+		{
+			ParallelFor(Count, [&Body](int32 WorkerIndex) { Body(WorkerIndex); });
+		});
+	INC_DWORD_STAT_BY(STAT_PathfindingNodesExpanded, (uint32)Stats.NodesExpanded);
+	return Stats;
+}
+
+std::shared_ptr<const FGridGraph> APathfindingBlockGrid::GetGraphSnapshot()
+{
+	if (!GraphSnapshot)
+	{
+		GraphSnapshot = std::make_shared<const FGridGraph>(Graph);
+	}
+	return GraphSnapshot;
+}
+
+void APathfindingBlockGrid::StartLivePath()
+{
+	bLivePathActive = true;
+	bLivePathDirty = true;
+	UpdateTickEnabled();
+}
+
+void APathfindingBlockGrid::StopLivePath()
+{
+	ShowLivePath(std::vector<int32>());
+	LivePlanner = FGridIncrementalSearch();
+	bLivePathActive = false;
+	UpdateTickEnabled();
+	UpdateMemoryStats();
+}
+
+double APathfindingBlockGrid::GetPlaybackRate() const
+{
+	//A fixed rate took minutes to replay a search of a big board and was over in a few frames on a small one
+	if (PlaybackSpeed > 0.f)
+	{
+		return PlaybackSpeed;
+	}
+	return Playback.Num() / FMath::Max(PlaybackDuration, 0.01f);
+}
+
+void APathfindingBlockGrid::PlaySearch()
+{
+	if (Playback.GetPosition() >= Playback.Num())
+	{
+		Playback.Seek(0.0);
+	}
+	Playback.Play();
+	UpdateTickEnabled();
+}
+
+void APathfindingBlockGrid::PauseSearch()
+{
+	Playback.Pause();
+}
+
+void APathfindingBlockGrid::SeekSearch(float Alpha)
+{
+	Playback.SeekNormalized(FMath::Clamp(Alpha, 0.f, 1.f));
+	UpdateTickEnabled();
+}
+
+float APathfindingBlockGrid::GetSearchPlaybackPosition() const
+{
+	return Playback.Num() > 0 ? (float)(Playback.GetPosition() / Playback.Num()) : 0.f;
+}
+
+bool APathfindingBlockGrid::IsSearchPlaying() const
+{
+	return Playback.IsPlaying();
+}
+
+void APathfindingBlockGrid::BuildFlowField(const TArray<int32>& GoalCells)
+{
+	std::vector<int32> Goals(GoalCells.GetData(), GoalCells.GetData() + GoalCells.Num());
+	if (Goals.empty())
+	{
+		Goals.push_back(Graph.GetGoal());
+	}
+
+	PATHFINDING_SCOPE_CYCLE_COUNTER(STAT_PathfindingFlowFieldBuild);
+	const double StartTime = FPlatformTime::Seconds();
+	FlowField.Build(Graph, Goals);
+	UE_LOG(LogTemp, Log, TEXT("Flow field to %d goals: %.2f ms"), (int32)FlowField.GetGoals().size(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	UpdateMemoryStats();
+	WakeCrowd();
+}
+
+int32 APathfindingBlockGrid::GetFlowFieldNextCell(int32 Cell) const
+{
+	return FlowField.IsBuilt() && Graph.IsValidIndex(Cell) ? FlowField.GetNextCell(Cell) : GridInvalidIndex;
+}
+
+APathfindingBlock* APathfindingBlockGrid::GetFlowFieldNextBlock(APathfindingBlock* From) const
+{
+	const int32 Next = From != nullptr ? GetFlowFieldNextCell(From->GridIndex) : GridInvalidIndex;
+	return BlockArray.IsValidIndex(Next) ? BlockArray[Next] : nullptr;
+}
+
+int32 APathfindingBlockGrid::GetFlowFieldDistance(int32 Cell) const
+{
+	if (!FlowField.IsBuilt() || !Graph.IsValidIndex(Cell) || (FlowField.GetDistance(Cell) == GridUnreachable))
+	{
+		return -1;
+	}
+	return FlowField.GetDistance(Cell);
+}
+
+int32 APathfindingBlockGrid::SpawnCrowd(int32 NumAgents, int32 Seed, float PathAgentFraction)
+{
+	if (Graph.Num() == 0)
+	{
+		return 0;
+	}
+	if (!FlowField.IsBuilt() && Graph.GetGoal() != GridInvalidIndex)
+	{
+		BuildFlowField(TArray<int32>());
+	}
+
+	FRandomStream Random(Seed);
+	int32 NumSpawned = 0;
+	for (int32 Attempt = 0; (Attempt < NumAgents * 4) && (NumSpawned < NumAgents); Attempt++)
+	{
+		const bool bPathAgent = Random.FRand() < PathAgentFraction;
+		int32 Goal = GridInvalidIndex;
+		if (bPathAgent)
+		{
+			//A wall goal could never be reached, AddAgent turns it down
+			Goal = Random.RandHelper(Graph.Num());
+			for (int32 Roll = 0; (Roll < 64) && Graph.IsWall(Goal); Roll++)
+			{
+				Goal = Random.RandHelper(Graph.Num());
+			}
+		}
+		const int32 Agent = Crowd.AddAgent(Graph, Random.RandHelper(Graph.Num()), bPathAgent ? EGridAgentMode::Path : EGridAgentMode::FlowField, AgentSpeed, Goal);
+		if (Agent != GridInvalidIndex)
+		{
+			CrowdTransforms.Add(FTransform(FRotator::ZeroRotator, GetAgentRelativeLocation(Agent), FVector(0.15f)));
+			NumSpawned++;
+		}
+	}
+	CrowdRenderer->AddInstances(TArray<FTransform>(CrowdTransforms.GetData() + CrowdTransforms.Num() - NumSpawned, NumSpawned), false);
+
+	//New path agents get their first path right away
+	WakeCrowd();
+	UpdateMemoryStats();
+	return NumSpawned;
 }
 
-void APathfindingBlockGrid::BeginPlay()
+void APathfindingBlockGrid::ClearCrowd()
 {
-	Super::BeginPlay();
+	Crowd.Reset(Graph);
+	bCrowdActive = false;
+	CrowdTransforms.Reset();
+	CrowdRenderer->ClearInstances();
+	UpdateTickEnabled();
+	UpdateMemoryStats();
+}
 
-	// Number of blocks
-	const int32 NumBlocks = Size * Size;
+int32 APathfindingBlockGrid::GetCrowdSize() const
+{
+	return Crowd.Num();
+}
 
-	// Loop to spawn each block
-	for(int32 BlockIndex=0; BlockIndex<NumBlocks; BlockIndex++)
+FVector APathfindingBlockGrid::GetAgentLocation(int32 Agent) const
+{
+	return (Agent >= 0 && Agent < Crowd.Num()) ? GetActorLocation() + GetAgentRelativeLocation(Agent) : FVector::ZeroVector;
+}
+
+FVector APathfindingBlockGrid::GetAgentRelativeLocation(int32 Agent) const
+{
+	//Rows run along X and columns along Y, raised to sit on top of the cells
+	return FVector(Crowd.GetY(Agent) * BlockSpacing, Crowd.GetX(Agent) * BlockSpacing, BlockSpacing * 0.5f);
+}
+
+void APathfindingBlockGrid::TickCrowd(float DeltaSeconds)
+{
+	CrowdRepathTime -= DeltaSeconds;
+	if (CrowdRepathTime <= 0.f)
 	{
-		const float XOffset = (BlockIndex/Size) * BlockSpacing; // Divide by dimension
-		const float YOffset = (BlockIndex%Size) * BlockSpacing; // Modulo gives remainder
+		CrowdRepathTime = CrowdRepathInterval;
+		RepathCrowd();
+	}
 
-		// Make position vector, offset from Grid location
-		const FVector BlockLocation = FVector(XOffset, YOffset, 0.f) + GetActorLocation();
+	FGridCrowdStats Stats;
+	{
+		SCOPE_CYCLE_COUNTER(STAT_PathfindingCrowdUpdate);
+		Stats = Crowd.Update(Graph, &FlowField, DeltaSeconds, [](int32 NumTasks, const std::function<void(int32)>& Body)
+		{
+			ParallelFor(NumTasks, [&Body](int32 TaskIndex) { Body(TaskIndex); });
+		});
+	}
+	bCrowdActive = (Stats.NumMoving + Stats.NumWaiting) > 0;
+	SET_DWORD_STAT(STAT_PathfindingCrowdAgents, Stats.NumAgents - Stats.NumArrived);
+	SET_DWORD_STAT(STAT_PathfindingCrowdMoving, Stats.NumMoving);
+	SET_DWORD_STAT(STAT_PathfindingCrowdWaiting, Stats.NumWaiting);
 
-		// Spawn a block
-		APathfindingBlock* NewBlock = GetWorld()->SpawnActor<APathfindingBlock>(BlockLocation, FRotator(0,0,0));
-		NewBlock->SetActorTickEnabled(false);
-		BlockArray.Add(NewBlock);
+	SCOPE_CYCLE_COUNTER(STAT_PathfindingCrowdRender);
+	for (int32 Agent = 0; Agent < Crowd.Num(); Agent++)
+	{
+		//Arrived agents have left the board
+		const bool bArrived = Crowd.GetState(Agent) == EGridAgentState::Arrived;
+		CrowdTransforms[Agent].SetTranslationAndScale3D(GetAgentRelativeLocation(Agent), FVector(bArrived ? 0.f : 0.15f));
+	}
+	CrowdRenderer->BatchUpdateInstancesTransforms(0, CrowdTransforms, false, true, true);
+}
 
-		// Tell the block about its owner
-		if (NewBlock != nullptr)
+void APathfindingBlockGrid::WakeCrowd()
+{
+	if (Crowd.Num() > 0)
+	{
+		bCrowdActive = true;
+		CrowdRepathTime = 0.f;
+		UpdateTickEnabled();
+	}
+}
+
+void APathfindingBlockGrid::RepathCrowd()
+{
+	std::vector<FGridPathRequest> Requests;
+	std::vector<int32> Agents;
+	for (int32 Agent = 0; Agent < Crowd.Num(); Agent++)
+	{
+		if ((Crowd.GetMode(Agent) == EGridAgentMode::Path) && (Crowd.GetState(Agent) == EGridAgentState::NoRoute))
 		{
-			NewBlock->OwningGrid = this;
+			Requests.push_back(FGridPathRequest{ Crowd.GetCell(Agent), Crowd.GetGoal(Agent) });
+			Agents.push_back(Agent);
+		}
+	}
+	if (Requests.empty())
+	{
+		return;
+	}
+
+	//Unreachable goals stay without a path and are tried again next interval, an edit may have opened them up
+	std::vector<FGridSearchResult> Results;
+	RunBatch(Requests, EGridSearchAlgorithm::AStar, Results);
+	for (size_t i = 0; i < Agents.size(); i++)
+	{
+		if (Results[i].bFound)
+		{
+			Crowd.SetPath(Agents[i], Results[i].Path.data(), (int32)Results[i].Path.size());
 		}
 	}
 }
 
-void APathfindingBlockGrid::AddScore()
+void APathfindingBlockGrid::ApplyPlaybackVisual(int32 Index, EGridPlaybackVisual Visual)
 {
-	// Increment score
-	Score++;
+	EPathCellVisual CellVisual = EPathCellVisual::Open;
+	switch (Visual)
+	{
+	case EGridPlaybackVisual::Visited:
+		CellVisual = EPathCellVisual::Visited;
+		break;
+	case EGridPlaybackVisual::VisitedFromGoal:
+		CellVisual = EPathCellVisual::VisitedFromGoal;
+		break;
+	case EGridPlaybackVisual::Path:
+		CellVisual = EPathCellVisual::Path;
+		break;
+	default:
+		break;
+	}
+
+	//Undone cells go back to no heat, the path keeps the heat of its visit
+	const bool bVisited = (Visual == EGridPlaybackVisual::Visited) || (Visual == EGridPlaybackVisual::VisitedFromGoal);
+	const float Heat = CellHeat.IsValidIndex(Index) ? CellHeat[Index] : 0.f;
+
+	if (BlockArray.IsValidIndex(Index))
+	{
+		APathfindingBlock* Block = BlockArray[Index];
+		Block->SetSearchVisual(CellVisual);
+		if (!Block->bIsActive && (Visual != EGridPlaybackVisual::Path))
+		{
+			Block->SetHeat(bVisited ? Heat : 0.f);
+		}
+		return;
+	}
+
+	//Walls, start and end painted since the search keep their look
+	const EPathCellVisual Current = CellRenderer->GetCellVisual(Index);
+	if ((Current != EPathCellVisual::Wall) && (Current != EPathCellVisual::Start) && (Current != EPathCellVisual::End))
+	{
+		CellRenderer->SetCellVisual(Index, CellVisual);
+		if (Visual != EGridPlaybackVisual::Path)
+		{
+			CellRenderer->SetCellHeat(Index, bVisited ? Heat : 0.f);
+		}
+	}
 }
 
-void APathfindingBlockGrid::ResetBoard()
+void APathfindingBlockGrid::UpdateTickEnabled()
 {
-	for (auto& Block : BlockArray)
+	SetActorTickEnabled(bLivePathActive || !Playback.IsFinished() || bCrowdActive);
+}
+
+void APathfindingBlockGrid::ShowLivePath(const std::vector<int32>& Cells)
+{
+	for (APathfindingBlock* Block : LivePath)
+	{
+		Block->ShowLivePath(false);
+	}
+	for (int32 Index : LivePathCells)
 	{
-		Block->HandleClicked("Reset");
+		if (bUseInstancedCells && (CellRenderer->GetCellVisual(Index) == EPathCellVisual::Path))
+		{
+			CellRenderer->SetCellVisual(Index, EPathCellVisual::Open);
+		}
 	}
+	LivePath.Reset(Cells.size());
+	LivePathCells = Cells;
 
-	VisitedNodesInOrder.Empty();
-	UnvisitedNodes.Empty();
-	bDone = false;
-	bPathAvailable = false;
+	for (int32 Index : Cells)
+	{
+		if (BlockArray.IsValidIndex(Index))
+		{
+			APathfindingBlock* Block = BlockArray[Index];
+			Block->ShowLivePath(true);
+			LivePath.Add(Block);
+		}
+		else if (bUseInstancedCells && (CellRenderer->GetCellVisual(Index) == EPathCellVisual::Open))
+		{
+			CellRenderer->SetCellVisual(Index, EPathCellVisual::Path);
+		}
+	}
 }
 
-void APathfindingBlockGrid::ResetPathfinding()
+void APathfindingBlockGrid::SetCellWall(int32 Index, bool bWall)
 {
-	for (auto& Block : BlockArray)
+	if (!Graph.IsValidIndex(Index))
 	{
-		if (!Block->bIsEnd && !Block->bIsStart && !Block->bIsWall)
+		return;
+	}
+
+	if (BlockArray.IsValidIndex(Index))
+	{
+		APathfindingBlock* Block = BlockArray[Index];
+		if (bWall)
+		{
+			Block->HandleClicked("Wall");
+		}
+		else if (Block->bIsWall)
 		{
 			Block->HandleClicked("Reset");
 		}
+		return;
 	}
 
-	VisitedNodesInOrder.Empty();
-	UnvisitedNodes.Empty();
-	bDone = false;
-	bPathAvailable = false;
+	//Like blocks, start and end can't be walled over
+	if ((Graph.IsWall(Index) == bWall) || (bWall && ((Index == Graph.GetStart()) || (Index == Graph.GetGoal()))))
+	{
+		return;
+	}
+
+	Graph.SetWall(Index, bWall);
+	CellRenderer->SetCellVisual(Index, bWall ? EPathCellVisual::Wall : EPathCellVisual::Open);
+	OnCellChanged(Index);
 }
 
-TArray<APathfindingBlock*> APathfindingBlockGrid::DijkstraAlgorithm(TArray<APathfindingBlock*> Array)
+void APathfindingBlockGrid::ResetCell(int32 Index)
 {
-	TotalBlocksVisited = 0;
-	for (auto& Block : Array)
+	if (!Graph.IsValidIndex(Index))
 	{
-		UnvisitedNodes.Add(Block);
+		return;
 	}
 
-	while (!bDone)
+	if (BlockArray.IsValidIndex(Index))
 	{
-		//Sort block array by distance
-		UnvisitedNodes = SortBlocksByDistance(UnvisitedNodes, 0, UnvisitedNodes.Num() - 1);
-		//Set 1st element to visited
-		UnvisitedNodes[0]->bVisited = true;
-		TotalBlocksVisited = TotalBlocksVisited + 1;
-		if (UnvisitedNodes[0]->Distance == 9999)
-		{
-			UE_LOG(LogTemp, Warning, TEXT("Blocked Path"));
-			bDone = true;
-			return VisitedNodesInOrder;
-		}
+		BlockArray[Index]->HandleClicked("Reset");
+		return;
+	}
 
-		//Push neighbor nodes (line trace) to NeighborArray
-		TArray <APathfindingBlock*> NeighborsHitArray;
-		FHitResult NeighborHit;
+	const bool bWasWall = Graph.IsWall(Index);
+	Graph.ResetCell(Index);
+	CellRenderer->SetCellVisual(Index, EPathCellVisual::Open);
+	if (bWasWall)
+	{
+		OnCellChanged(Index);
+	}
+}
 
-		FVector Start = UnvisitedNodes[0]->GetActorLocation();
-		FVector EndN = Start + FVector(75, 0, 0);
-		FVector EndS = Start + FVector(-75, 0, 0);
-		FVector EndW = Start + FVector(0, -75, 0);
-		FVector EndE = Start + FVector(0, 75, 0);
-		FVector End;
+void APathfindingBlockGrid::SetCellStart(int32 Index)
+{
+	if (!Graph.IsValidIndex(Index))
+	{
+		return;
+	}
 
-		for (int dir = 1; dir <= 4; dir++)
-		{
-			if (dir == 1) 
-			{
-				End = EndN;
-			}
-			else if (dir == 2)
-			{
-				End = EndS;
-			}
-			else if (dir == 3)
-			{
-				End = EndW;
-			}
-			else if (dir == 4)
-			{
-				End = EndE;
-			}
+	if (BlockArray.IsValidIndex(Index))
+	{
+		BlockArray[Index]->HandleClicked("Start");
+		return;
+	}
 
-			GetWorld()->LineTraceSingleByChannel(NeighborHit, Start, End, ECC_Visibility);
+	if (Graph.IsWall(Index) || (Index == Graph.GetGoal()))
+	{
+		return;
+	}
 
-			APathfindingBlock* NeighborFound = Cast<APathfindingBlock>(NeighborHit.GetActor());
-			if (NeighborFound && !NeighborFound->bIsWall && !NeighborFound->bVisited)
-			{
-				NeighborsHitArray.Add(NeighborFound);
-				//NeighborFound->Highlight(true);
-				if ((UnvisitedNodes[0]->Distance + 1) < NeighborFound->Distance)
-				{
-					NeighborFound->Distance = 1 + UnvisitedNodes[0]->Distance;
-					NeighborFound->SetActorTickEnabled(true);	
-				}
-			}
-		}
+	if (Graph.IsValidIndex(Graph.GetStart()))
+	{
+		CellRenderer->SetCellVisual(Graph.GetStart(), EPathCellVisual::Open);
+	}
+	Graph.SetStart(Index);
+	CellRenderer->SetCellVisual(Index, EPathCellVisual::Start);
+}
 
-		//Push visited node (element 0) to VisitedNodesInOrder Array and Remove it from the BlockArray
-		VisitedNodesInOrder.Add(UnvisitedNodes[0]);
-		UnvisitedNodes.RemoveAt(0);
+void APathfindingBlockGrid::SetCellEnd(int32 Index)
+{
+	if (!Graph.IsValidIndex(Index))
+	{
+		return;
+	}
 
-		//If 1st element->bIsEnd then return VisitedNodesInOrder
-		if (VisitedNodesInOrder.Last()->bIsEnd == true)
-		{
-			UE_LOG(LogTemp, Warning, TEXT("Found End at %s"), *VisitedNodesInOrder.Last()->GetName());
-			EndDistance = VisitedNodesInOrder.Last()->Distance;
-			bDone = true;
-			bPathAvailable = true;
-			UE_LOG(LogTemp, Warning, TEXT("Number of Visited Blocks = %i"), TotalBlocksVisited);
-			return VisitedNodesInOrder;
-		}
+	if (BlockArray.IsValidIndex(Index))
+	{
+		BlockArray[Index]->HandleClicked("End");
+		return;
 	}
 
-	return VisitedNodesInOrder;
+	if (Graph.IsWall(Index) || (Index == Graph.GetStart()))
+	{
+		return;
+	}
+
+	if (Graph.IsValidIndex(Graph.GetGoal()))
+	{
+		CellRenderer->SetCellVisual(Graph.GetGoal(), EPathCellVisual::Open);
+	}
+	Graph.SetGoal(Index);
+	EndLocation = CellRenderer->GetCellLocation(Index);
+	CellRenderer->SetCellVisual(Index, EPathCellVisual::End);
 }
 
-TArray<APathfindingBlock*> APathfindingBlockGrid::AStarAlgorithm(TArray<APathfindingBlock*> Array)
+void APathfindingBlockGrid::SetCellCost(int32 Index, int32 Cost)
 {
-	float TimeCount = 1;
-	TotalBlocksVisited = 0;
-	for (auto& Block : Array)
+	if (!Graph.IsValidIndex(Index))
 	{
-		Block->Heuristic = (Block->GetDistanceTo(EndBlock)) / BlockSpacing;
-		UnvisitedNodes.Add(Block);
+		return;
 	}
-	
-	while (!bDone)
+
+	if (BlockArray.IsValidIndex(Index))
 	{
-		//Sort block array by distance
-		UnvisitedNodes = SortBlocksByWeightedDistance(UnvisitedNodes, 0, UnvisitedNodes.Num() - 1);
-		//Set 1st element to visited
-		UnvisitedNodes[0]->bVisited = true;
-		TotalBlocksVisited = TotalBlocksVisited + 1;
-		if (UnvisitedNodes[0]->Distance == 9999)
-		{
-			UE_LOG(LogTemp, Warning, TEXT("Blocked Path"));
-			bDone = true;
-			return VisitedNodesInOrder;
-		}
+		BlockArray[Index]->SetCost(Cost);
+		return;
+	}
 
-		//Push neighbor nodes (line trace) to NeighborArray
-		TArray <APathfindingBlock*> NeighborsHitArray;
-		FHitResult NeighborHit;
+	Graph.SetCost(Index, Cost);
+	CellRenderer->SetCellCost(Index, Graph.GetCost(Index));
+	OnCellCostChanged(Index);
+}
 
-		FVector Start = UnvisitedNodes[0]->GetActorLocation();
-		FVector EndN = Start + FVector(75, 0, 0);
-		FVector EndS = Start + FVector(-75, 0, 0);
-		FVector EndW = Start + FVector(0, -75, 0);
-		FVector EndE = Start + FVector(0, 75, 0);
-		FVector End;
+int32 APathfindingBlockGrid::TraceCell(const FVector& Start, const FVector& End) const
+{
+	return bUseInstancedCells ? CellRenderer->TraceCell(Start, End) : INDEX_NONE;
+}
 
-		for (int dir = 1; dir <= 4; dir++)
-		{
-			if (dir == 1)
-			{
-				End = EndN;
-			}
-			else if (dir == 2)
-			{
-				End = EndS;
-			}
-			else if (dir == 3)
-			{
-				End = EndW;
-			}
-			else if (dir == 4)
-			{
-				End = EndE;
-			}
+void APathfindingBlockGrid::SetBlockCost(APathfindingBlock* Block, int32 Cost)
+{
+	if (Block != nullptr)
+	{
+		Block->SetCost(Cost);
+	}
+}
 
-			GetWorld()->LineTraceSingleByChannel(NeighborHit, Start, End, ECC_Visibility);
+void APathfindingBlockGrid::PaintCost(APathfindingBlock* Center, int32 Radius, int32 Cost)
+{
+	if (Center == nullptr)
+	{
+		return;
+	}
 
-			APathfindingBlock* NeighborFound = Cast<APathfindingBlock>(NeighborHit.GetActor());
-			if (NeighborFound && !NeighborFound->bIsWall && !NeighborFound->bVisited)
+	const int32 CenterX = Graph.GetX(Center->GridIndex);
+	const int32 CenterY = Graph.GetY(Center->GridIndex);
+	for (int32 Y = CenterY - Radius; Y <= CenterY + Radius; Y++)
+	{
+		for (int32 X = CenterX - Radius; X <= CenterX + Radius; X++)
+		{
+			if (Graph.IsValidCoord(X, Y))
 			{
-				NeighborsHitArray.Add(NeighborFound);
-				if ((UnvisitedNodes[0]->Distance + 1) < NeighborFound->Distance)
-				{
-					NeighborFound->Distance = 1 + UnvisitedNodes[0]->Distance;
-					NeighborFound->SetActorTickEnabled(true);
-				}
+				SetCellCost(Graph.GetIndex(X, Y), Cost);
 			}
 		}
+	}
+}
 
-		//Push visited node (element 0) to VisitedNodesInOrder Array and Remove it from the BlockArray
-		UE_LOG(LogTemp, Warning, TEXT("Heuristic (%f) + Distance (%f) = %f"), UnvisitedNodes[0]->Heuristic, UnvisitedNodes[0]->Distance, UnvisitedNodes[0]->Heuristic + UnvisitedNodes[0]->Distance);
-		VisitedNodesInOrder.Add(UnvisitedNodes[0]);
-		UnvisitedNodes.RemoveAt(0);
+void APathfindingBlockGrid::ClearCosts()
+{
+	for (auto& Block : BlockArray)
+	{
+		if (Block->Cost != 1)
+		{
+			Block->SetCost(1);
+		}
+	}
 
-		//If 1st element->bIsEnd then return VisitedNodesInOrder
-		if (VisitedNodesInOrder.Last()->bIsEnd == true)
+	if (bUseInstancedCells)
+	{
+		for (int32 Index = 0; Index < Graph.Num(); Index++)
 		{
-			UE_LOG(LogTemp, Warning, TEXT("Found End at %s"), *VisitedNodesInOrder.Last()->GetName());
-			EndDistance = VisitedNodesInOrder.Last()->Distance;
-			bDone = true;
-			bPathAvailable = true;
-			UE_LOG(LogTemp, Warning, TEXT("Number of Visited Blocks = %i"), TotalBlocksVisited);
-			return VisitedNodesInOrder;
+			if (Graph.GetCost(Index) != 1)
+			{
+				SetCellCost(Index, 1);
+			}
 		}
 	}
 
-	return VisitedNodesInOrder;
+	Graph.ResetCosts();
 }
 
+void APathfindingBlockGrid::BenchmarkOpenLists(int32 Iterations)
+{
+	//Runs on the board as it is, generate a maze or paint walls first
+	for (const FGridBenchmarkResult& Result : FGridBenchmark::CompareOpenLists(Graph, Iterations))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s / %s: %.3f ms, %i visited, cost %i"),
+			ANSI_TO_TCHAR(GetAlgorithmName(Result.Algorithm)), ANSI_TO_TCHAR(GetOpenListName(Result.OpenList)),
+			Result.AverageMilliseconds, Result.NodesExpanded, Result.Cost);
+	}
 
+	if (Graph.GetMinCost() == Graph.GetMaxCost())
+	{
+		int32 Steps = GridUnreachable;
+		const double Milliseconds = FGridBenchmark::TimeBitsetSearch(Graph, Iterations, Steps);
+		UE_LOG(LogTemp, Warning, TEXT("Bitset BFS (%s): %.3f ms, cost %i"),
+			ANSI_TO_TCHAR(FGridBitsetSearch::GetSimdName()), Milliseconds, Steps != GridUnreachable ? Steps * Graph.GetMinCost() : GridUnreachable);
+	}
+}
 
 TArray<APathfindingBlock*> APathfindingBlockGrid::SortBlocksByDistance(TArray<APathfindingBlock*> UnvisitedArray, int LeftIndex, int RightIndex)
 {
@@ -303,56 +1289,27 @@ TArray<APathfindingBlock*> APathfindingBlockGrid::SortBlocksByWeightedDistance(T
 
 void APathfindingBlockGrid::GetShortestPath(TArray<APathfindingBlock*> VisitedNodes)
 {
-	//Traverse backwards through the visited nodes as long as there is a path
-	APathfindingBlock* EndNode = VisitedNodes.Last();
+	PATHFINDING_SCOPE_CYCLE_COUNTER(STAT_PathfindingShortestPath);
+
+	//The path comes from the parent links of the last search, start and end keep their own materials
 	if (bPathAvailable == true)
 	{
-		while (!EndNode->bIsStart)
-
+		for (int32 Index : LastSearch.Path)
+		{
+			if ((Index == Graph.GetStart()) || (Index == Graph.GetGoal()))
+			{
+				continue;
+			}
+			if (BlockArray.IsValidIndex(Index))
 			{
-				//Check if the node is a neighbor and the distance = currentDistance - 1
-				int dist = EndNode->Distance;
-
-				FHitResult NeighborHit;
-
-				FVector Start = EndNode->GetActorLocation();
-				FVector EndN = Start + FVector(75, 0, 0);
-				FVector EndS = Start + FVector(-75, 0, 0);
-				FVector EndW = Start + FVector(0, -75, 0);
-				FVector EndE = Start + FVector(0, 75, 0);
-				FVector End;
-
-				for (int dir = 1; dir <= 4; dir++)
-				{
-					if (dir == 1)
-					{
-						End = EndN;
-					}
-					else if (dir == 2)
-					{
-						End = EndS;
-					}
-					else if (dir == 3)
-					{
-						End = EndW;
-					}
-					else if (dir == 4)
-					{
-						End = EndE;
-					}
-
-					GetWorld()->LineTraceSingleByChannel(NeighborHit, Start, End, ECC_Visibility);
-
-					APathfindingBlock* NeighborFound = Cast<APathfindingBlock>(NeighborHit.GetActor());
-					if (NeighborFound && (NeighborFound->Distance == EndNode->Distance - 1))
-					{
-						NeighborFound->bIsShortestPath = true;
-						EndNode = NeighborFound;
-					}
-				}
+				BlockArray[Index]->bIsShortestPath = true;
 			}
+			else if (bUseInstancedCells)
+			{
+				CellRenderer->SetCellVisual(Index, EPathCellVisual::Path);
+			}
+		}
 	}
-	
 }
 
 void APathfindingBlockGrid::HighlightBlock(TArray<APathfindingBlock*> VisitedNodes)
@@ -369,109 +1326,224 @@ void APathfindingBlockGrid::HighlightBlock(TArray<APathfindingBlock*> VisitedNod
 	}
 }
 
-TArray<APathfindingBlock*> APathfindingBlockGrid::CreateMazeGrid()
+void APathfindingBlockGrid::GenerateMaze(int32 Seed, EMazeAlgorithm Algorithm, float BraidFraction)
 {
-	int row = 1;
-	int MazeIndexCount = 0;
+	PATHFINDING_SCOPE_CYCLE_COUNTER(STAT_PathfindingGenerateMaze);
 	ResetBoard();
+	const FGridMazeStats Stats = MazeGenerator.Generate(Graph, (uint32)Seed, static_cast<EGridMazeAlgorithm>(Algorithm), FMath::Clamp(BraidFraction, 0.f, 1.f));
+	ShowGraphWalls();
+
+	UE_LOG(LogTemp, Log, TEXT("%s maze %d: %.2f ms, %d of %d cells open, %d dead ends"),
+		ANSI_TO_TCHAR(GetMazeAlgorithmName(Stats.Algorithm)), Seed, Stats.Milliseconds, Stats.NumOpen, Graph.Num(), Stats.NumDeadEnds);
+}
 
-	//Generate Grid
-	for (int i = 0; i < BlockArray.Num(); i++)
+void APathfindingBlockGrid::ShowGraphWalls()
+{
+	//ResetBoard dropped everything built from the graph, so the walls only need to show. The graph already has them,
+	//so blocks mustn't write them back and fire a change per wall
+	for (int32 Index = 0; Index < Graph.Num(); Index++)
 	{
-		//Reached end column
-		if ((i % 25 == 0) && (i != 0))
+		if (!Graph.IsWall(Index))
 		{
-			row++;
+			continue;
 		}
-		//Wall off all odd rows
-		if (row % 2 != 0) {
-			BlockArray[i]->HandleClicked("Wall");
+
+		if (BlockArray.IsValidIndex(Index))
+		{
+			BlockArray[Index]->ApplyGraphState(Graph);
 		}
-		//Wall  off every other block of even rows
-		else
+		else if (bUseInstancedCells)
 		{
-			if (i % 2 != 0)
-			{
-				BlockArray[i]->HandleClicked("Wall");
-			}
+			CellRenderer->SetCellVisual(Index, EPathCellVisual::Wall);
 		}
+	}
+}
 
-		if ((i < 25) || (i > 599) || (i % 25 == 0) || (i % 25 == 24))
+void APathfindingBlockGrid::ShowGraphCosts()
+{
+	for (int32 Index = 0; Index < Graph.Num(); Index++)
+	{
+		const int32 Cost = Graph.GetCost(Index);
+		if (Cost == 1)
 		{
-			BlockArray[i]->bIsEdgeWall = true;
+			continue;
 		}
 
-		if ((i >= 25) && (i <= 599) && (i % 25 != 0) && (i % 25 != 24) && (!BlockArray[i]->bIsWall))
+		if (BlockArray.IsValidIndex(Index))
+		{
+			BlockArray[Index]->ApplyGraphState(Graph);
+		}
+		else if (bUseInstancedCells)
 		{
-			MazeGridArray.Add(BlockArray[i]);
-			BlockArray[i]->MazeIndex = MazeIndexCount;
-			MazeIndexCount++;
-			UE_LOG(LogTemp, Warning, TEXT("MazeBlock: %s"), *BlockArray[i]->GetName());
+			CellRenderer->SetCellCost(Index, Cost);
 		}
 	}
+}
+
+void APathfindingBlockGrid::BenchmarkMazes(int32 Seed, float BraidFraction)
+{
+	for (const FGridMazeStats& Stats : FGridBenchmark::CompareMazes(Size, Size, (uint32)Seed, FMath::Clamp(BraidFraction, 0.f, 1.f)))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s: %.2f ms, %i open, %i dead ends, %i braided"),
+			ANSI_TO_TCHAR(GetMazeAlgorithmName(Stats.Algorithm)), Stats.Milliseconds, Stats.NumOpen, Stats.NumDeadEnds, Stats.NumBraided);
+	}
+}
+
+void APathfindingBlockGrid::StartStreamedMaze(int32 Seed, EMazeAlgorithm Algorithm, float BraidFraction)
+{
+	const FString PageDirectory = FPaths::ProjectSavedDir() / TEXT("Pathfinding");
+	IFileManager::Get().MakeDirectory(*PageDirectory, true);
+
+	FGridChunkStoreSettings Settings;
+	Settings.Seed = (uint32)Seed;
+	Settings.Algorithm = static_cast<EGridMazeAlgorithm>(Algorithm);
+	Settings.BraidFraction = FMath::Clamp(BraidFraction, 0.f, 1.f);
+	Settings.ChunkSize = StreamedChunkSize;
+	Settings.MaxResidentChunks = MaxResidentChunks;
+	Settings.PageFilePath = TCHAR_TO_UTF8(*FPaths::ConvertRelativePathToFull(PageDirectory / TEXT("ChunkPages.bin")));
+
+	StreamedMaze = std::make_unique<FGridChunkStore>();
+	if (!StreamedMaze->Init(Settings))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Couldn't create the chunk page file in %s, evicted edits will be lost"), *PageDirectory);
+	}
+	ShowStreamedMazeWindow(0, 0);
+}
+
+void APathfindingBlockGrid::ShowStreamedMazeWindow(int32 MinX, int32 MinY)
+{
+	if (!StreamedMaze)
+	{
+		return;
+	}
 
-	return MazeGridArray;
+	ResetBoard();
+	StreamedMaze->CopyWindow(MinX, MinY, Graph);
+	ShowGraphWalls();
+	UpdateMemoryStats();
 }
 
-void APathfindingBlockGrid::MazeGenerator(TArray<APathfindingBlock*> GridArray, int Index, TArray<APathfindingBlock*> VisitedArray)
+int32 APathfindingBlockGrid::FindStreamedPath(int32 StartX, int32 StartY, int32 GoalX, int32 GoalY)
 {
-	TArray<APathfindingBlock*> VisitedArr = VisitedArray;
-	TArray<APathfindingBlock*> GridArr = GridArray;
+	if (!StreamedMaze)
+	{
+		return -1;
+	}
 
-	//UE_LOG(LogTemp, Warning, TEXT("T INDEX: %i"), Index);
-	VisitedArr.Add(GridArr[Index]);
+	FGridChunkedSearchResult Result;
+	{
+		PATHFINDING_SCOPE_CYCLE_COUNTER(STAT_PathfindingSearch);
+		StreamedSearch.Run(*StreamedMaze, StartX, StartY, GoalX, GoalY, Result);
+	}
+	INC_DWORD_STAT_BY(STAT_PathfindingNodesExpanded, Result.NodesExpanded);
+	UpdateMemoryStats();
+
+	const FGridChunkStoreStats& Stats = StreamedMaze->GetStats();
+	UE_LOG(LogTemp, Log, TEXT("Streamed path (%d, %d) -> (%d, %d): cost %d, %d visited%s. Chunks: %d resident (peak %lld bytes), %lld generated, %lld paged in, %lld paged out"),
+		StartX, StartY, GoalX, GoalY, Result.bFound ? Result.Cost : -1, Result.NodesExpanded, Result.bExhausted ? TEXT(", gave up") : TEXT(""),
+		Stats.ResidentChunks, Stats.PeakResidentBytes, Stats.ChunksGenerated, Stats.ChunksLoaded, Stats.ChunksWritten);
+	return Result.bFound ? Result.Cost : -1;
+}
 
-	GridArr[Index]->bMazeVisited = true;
+FString APathfindingBlockGrid::GetBoardPath(const FString& FileName) const
+{
+	return FPaths::ConvertRelativePathToFull(FPaths::IsRelative(FileName) ? FPaths::ProjectSavedDir() / TEXT("Pathfinding") / FileName : FileName);
+}
 
-	//Check Neighbors to set maze walls
-	FHitResult NeighborHit;
-	FHitResult WallBetween;
-	FVector End;
-	FVector EndWall;
+bool APathfindingBlockGrid::SaveBoard(const FString& FileName)
+{
+	const FString Path = GetBoardPath(FileName);
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(Path), true);
 
-	int Direction;
-	int DirectionCount = 0;
+	const double StartTime = FPlatformTime::Seconds();
+	const EGridFileResult Result = FGridFile::Write(TCHAR_TO_UTF8(*Path), Graph);
+	if (Result != EGridFileResult::Success)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Couldn't save the board to %s: %s"), *Path, ANSI_TO_TCHAR(GetGridFileResultName(Result)));
+		return false;
+	}
 
-	FVector Start = GridArr[Index]->GetActorLocation();
+	UE_LOG(LogTemp, Log, TEXT("Saved the board to %s: %.2f ms"), *Path, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	return true;
+}
 
-	TArray<FVector> DirectionArray;
-	DirectionArray.Add(FVector(150, 0, 0));
-	DirectionArray.Add(FVector(-150, 0, 0));
-	DirectionArray.Add(FVector(0, -150, 0));
-	DirectionArray.Add(FVector(0, 150, 0));
+bool APathfindingBlockGrid::LoadBoard(const FString& FileName)
+{
+	const FString Path = GetBoardPath(FileName);
+	const double StartTime = FPlatformTime::Seconds();
+
+	//Platforms that can't map files read them into memory instead
+	TUniquePtr<IMappedFileHandle> MappedFile(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Path));
+	TUniquePtr<IMappedFileRegion> MappedRegion(MappedFile ? MappedFile->MapRegion() : nullptr);
+	TArray<uint8> FileData;
+	if (!MappedRegion && !FFileHelper::LoadFileToArray(FileData, *Path))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Couldn't open the board file %s"), *Path);
+		return false;
+	}
+	const uint8* Data = MappedRegion ? MappedRegion->GetMappedPtr() : FileData.GetData();
+	const int64 DataSize = MappedRegion ? MappedRegion->GetMappedSize() : FileData.Num();
 
-	//Shuffle directions
-	for (int i = 0; i <= 25; i++)
+	FGridFileHeader Header;
+	EGridFileResult Result = FGridFile::ReadHeader(Data, DataSize, Header);
+	if ((Result == EGridFileResult::Success) && ((Header.Width != Size) || (Header.Height != Size)))
 	{
-		Direction = FMath::RandRange(0, 3);
-		DirectionArray.Swap(0, Direction);
+		UE_LOG(LogTemp, Warning, TEXT("The board in %s is %d x %d, this grid is %d x %d"), *Path, Header.Width, Header.Height, Size, Size);
+		return false;
 	}
 
-	for (auto& Dir : DirectionArray)
+	ResetBoard();
+	Result = FGridFile::Read(Data, DataSize, Graph);
+	if (Result != EGridFileResult::Success)
 	{
-		End = Start + Dir;
-		DirectionCount++;
+		UE_LOG(LogTemp, Warning, TEXT("Couldn't load the board from %s: %s"), *Path, ANSI_TO_TCHAR(GetGridFileResultName(Result)));
+		return false;
+	}
 
-		//Line Trace to block (non wall)
-		FVector NS = End - FVector(0, 0, 10);
-		GetWorld()->LineTraceSingleByChannel(NeighborHit, Start, End, ECC_GameTraceChannel4);
+	//Start and end are shown through the same calls clicks use, which set them on Graph again
+	const int32 Start = Graph.GetStart();
+	const int32 Goal = Graph.GetGoal();
+	ShowGraphWalls();
+	ShowGraphCosts();
+	if (Graph.IsValidIndex(Start))
+	{
+		SetCellStart(Start);
+	}
+	if (Graph.IsValidIndex(Goal))
+	{
+		SetCellEnd(Goal);
+	}
+	UpdateMemoryStats();
 
-		APathfindingBlock* NeighborFound = Cast<APathfindingBlock>(NeighborHit.GetActor());
-		if ((NeighborFound) && (NeighborFound->bIsEdgeWall == false) && (NeighborFound->bMazeVisited == false) && (NeighborFound->MazeIndex != 0))
-		{
+	UE_LOG(LogTemp, Log, TEXT("Loaded the board from %s: %.2f ms%s"), *Path, (FPlatformTime::Seconds() - StartTime) * 1000.0, MappedRegion ? TEXT(", mapped") : TEXT(""));
+	return true;
+}
 
-			//Get the wall in between two open neighbors and reset it
-			EndWall = Start + (Dir / 2);
-			GetWorld()->LineTraceSingleByChannel(WallBetween, Start, EndWall, ECC_Visibility);
+bool APathfindingBlockGrid::ImportMovingAIMap(const FString& FileName)
+{
+	const FString Path = GetBoardPath(FileName);
+	FGridGraph Imported;
+	if (!FGridScenario::ReadMap(TCHAR_TO_UTF8(*Path), Imported))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Couldn't read the MovingAI map %s"), *Path);
+		return false;
+	}
+	if ((Imported.GetWidth() > Size) || (Imported.GetHeight() > Size))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("The map in %s is %d x %d, larger than this %d x %d grid"), *Path, Imported.GetWidth(), Imported.GetHeight(), Size, Size);
+		return false;
+	}
 
-			APathfindingBlock* WallFound = Cast<APathfindingBlock>(WallBetween.GetActor());
-			if (WallFound)
-			{
-				WallFound->HandleClicked("Reset");
-				MazeGenerator(GridArray, NeighborFound->MazeIndex, VisitedArr);
-			}
-		}
+	ResetBoard();
+	for (int32 Index = 0; Index < Graph.Num(); Index++)
+	{
+		const int32 X = Graph.GetX(Index);
+		const int32 Y = Graph.GetY(Index);
+		Graph.SetWall(Index, !Imported.IsValidCoord(X, Y) || Imported.IsWall(Imported.GetIndex(X, Y)));
 	}
+	ShowGraphWalls();
+	UpdateMemoryStats();
+	return true;
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -5,8 +5,134 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "PathfindingBlock.h"
+#include "PathfindingCellRenderer.h"
+#include "GridCore/GridGraph.h"
+#include "GridCore/GridSearch.h"
+#include "GridCore/JumpPointSearch.h"
+#include "GridCore/HierarchicalSearch.h"
+#include "GridCore/GridQueryQueue.h"
+#include "GridCore/GridBatchSearch.h"
+#include "GridCore/GridPathCache.h"
+#include "GridCore/IncrementalSearch.h"
+#include "GridCore/GridPlayback.h"
+#include "GridCore/GridMaze.h"
+#include "GridCore/GridChunkStore.h"
+#include "GridCore/GridChunkedSearch.h"
+#include "GridCore/GridBitsetSearch.h"
+#include "GridCore/FlowField.h"
+#include "GridCore/GridCrowd.h"
+#include <memory>
 #include "PathfindingBlockGrid.generated.h"
 
+/** Open list used by the Dijkstra and A* searches, one way or bidirectional, same order as EGridOpenList */
+UENUM(BlueprintType)
+enum class EPathOpenList : uint8
+{
+	/** Indexed heap, works for any costs */
+	Heap,
+	/** Dial's bucket queue, O(1) push/pop for small integer costs */
+	Buckets
+};
+
+/** Neighbors the board's Dijkstra and A* searches step to, same order as EGridTopology */
+UENUM(BlueprintType)
+enum class EPathTopology : uint8
+{
+	Four,
+	/** Diagonal steps too, without cutting corners */
+	Eight,
+	/** Six neighbors, rows are skewed so each cell also touches (+1, -1) and (-1, +1) */
+	Hex
+};
+
+/** Searches FindPathAsync can run, same order as EGridSearchAlgorithm */
+UENUM(BlueprintType)
+enum class EPathAlgorithm : uint8
+{
+	Dijkstra,
+	AStar,
+	JumpPoint,
+	BidirectionalDijkstra,
+	BidirectionalAStar
+};
+
+/** Maze generators GenerateMaze can use, same order as EGridMazeAlgorithm */
+UENUM(BlueprintType)
+enum class EMazeAlgorithm : uint8
+{
+	RecursiveBacktracker,
+	Kruskal,
+	Wilson,
+	Eller,
+	RecursiveDivision
+};
+
+/** Which queued path queries run first, same order as EGridQueryPriority */
+UENUM(BlueprintType)
+enum class EPathQueryPriority : uint8
+{
+	Low,
+	Normal,
+	High
+};
+
+/** Result of a FindPathAsync query, handed back on the game thread */
+USTRUCT(BlueprintType)
+struct FPathQueryResult
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Category = Algorithm, BlueprintReadOnly)
+	int32 Handle = 0;
+
+	UPROPERTY(Category = Algorithm, BlueprintReadOnly)
+	bool bFound = false;
+
+	UPROPERTY(Category = Algorithm, BlueprintReadOnly)
+	bool bCancelled = false;
+
+	UPROPERTY(Category = Algorithm, BlueprintReadOnly)
+	int32 Cost = 0;
+
+	/** Blocks on the path, start first and end last */
+	UPROPERTY(Category = Algorithm, BlueprintReadOnly)
+	TArray<APathfindingBlock*> Path;
+
+	/** Blocks in the order the search visited them */
+	UPROPERTY(Category = Algorithm, BlueprintReadOnly)
+	TArray<APathfindingBlock*> VisitedOrder;
+};
+
+/** Counters of the grid's path cache */
+USTRUCT(BlueprintType)
+struct FPathCacheStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Category = Algorithm, BlueprintReadOnly)
+	int32 Hits = 0;
+
+	UPROPERTY(Category = Algorithm, BlueprintReadOnly)
+	int32 Misses = 0;
+
+	/** Paths dropped because a wall or cost edit could change them */
+	UPROPERTY(Category = Algorithm, BlueprintReadOnly)
+	int32 Invalidations = 0;
+
+	/** Least recently used paths dropped to stay under PathCacheCapacity */
+	UPROPERTY(Category = Algorithm, BlueprintReadOnly)
+	int32 Evictions = 0;
+
+	UPROPERTY(Category = Algorithm, BlueprintReadOnly)
+	int32 NumCached = 0;
+
+	/** Goes up on every board edit */
+	UPROPERTY(Category = Algorithm, BlueprintReadOnly)
+	int32 Version = 0;
+};
+
+DECLARE_DYNAMIC_DELEGATE_OneParam(FOnPathQueryComplete, const FPathQueryResult&, Result);
+
 /** Class used to spawn blocks and manage score */
 UCLASS(minimalapi)
 class APathfindingBlockGrid : public AActor
@@ -17,6 +143,14 @@ class APathfindingBlockGrid : public AActor
 	UPROPERTY(Category = Grid, VisibleDefaultsOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = "true"))
 	class USceneComponent* DummyRoot;
 
+	/** Draws the cells when bUseInstancedCells is set */
+	UPROPERTY(Category = Grid, VisibleDefaultsOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = "true"))
+	class UPathfindingCellRenderer* CellRenderer;
+
+	/** Draws the crowd, one instance per agent */
+	UPROPERTY(Category = Crowd, VisibleDefaultsOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = "true"))
+	class UInstancedStaticMeshComponent* CrowdRenderer;
+
 	/** Text component for the score */
 	UPROPERTY(Category = Grid, VisibleDefaultsOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = "true"))
 	class UTextRenderComponent* ScoreText;
@@ -35,6 +169,13 @@ public:
 	UPROPERTY(Category=Grid, EditAnywhere, BlueprintReadOnly)
 	float BlockSpacing;
 
+	/**
+	 * Draw the cells as instances of CellRenderer instead of spawning a block actor per cell. Needed for boards in the
+	 * hundreds of cells per side. BlockArray stays empty, so edit the board with the SetCell functions
+	 */
+	UPROPERTY(Category=Grid, EditAnywhere, BlueprintReadOnly)
+	bool bUseInstancedCells;
+
 	UPROPERTY(BlueprintReadWrite)
 	bool bDone;
 
@@ -43,15 +184,81 @@ public:
 
 	int TestRunCount = 0;
 
+	/** Priority queue the searches use */
+	UPROPERTY(Category = Algorithm, EditAnywhere, BlueprintReadWrite)
+	EPathOpenList OpenList;
+
+	/**
+	 * Neighbors the search buttons step to. Jump Point Search becomes A* and the bitset Dijkstra is skipped unless this
+	 * is Four. 8-connected distances are in 408ths of an orthogonal step
+	 */
+	UPROPERTY(Category = Algorithm, EditAnywhere, BlueprintReadWrite)
+	EPathTopology Topology;
+
+	/** JumpPointSearch reads precomputed jump distances (JPS+) instead of scanning cells */
+	UPROPERTY(Category = Algorithm, EditAnywhere, BlueprintReadWrite)
+	bool bUseJumpPointTable;
+
+	/**
+	 * Opt in to running Dijkstra on a 4-connected board where every cell costs the same as a bit-parallel breadth-first
+	 * search. It ignores OpenList and plays back in breadth-first layers, row by row within a layer
+	 */
+	UPROPERTY(Category = Algorithm, EditAnywhere, BlueprintReadWrite)
+	bool bUseBitsetSearch;
+
+	/** Side of the square clusters HierarchicalSearch cuts the board into. Bigger clusters make queries faster and edits slower */
+	UPROPERTY(Category = Algorithm, EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "2"))
+	int32 HierarchyClusterSize;
+
+	/** Seconds a search playback takes however many blocks it visited, used while PlaybackSpeed is 0 */
+	UPROPERTY(Category = Playback, EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0.01"))
+	float PlaybackDuration;
+
+	/** Visited blocks per second the search playback shows, the path follows at the same pace. 0 plays over PlaybackDuration */
+	UPROPERTY(Category = Playback, EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0"))
+	float PlaybackSpeed;
+
+	/** Most blocks the playback recolors in one frame, also when catching up after a seek */
+	UPROPERTY(Category = Playback, EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "1"))
+	int32 MaxPlaybackUpdatesPerFrame;
+
+	/** Paths FindPathCached keeps, 0 turns the cache off */
+	UPROPERTY(Category = Algorithm, EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0"))
+	int32 PathCacheCapacity;
+
+	/** Side in cells of the chunks a streamed maze is generated and paged in */
+	UPROPERTY(Category = Streaming, EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "4"))
+	int32 StreamedChunkSize;
+
+	/** Chunks of the streamed maze kept in memory, which bounds its memory whatever its size */
+	UPROPERTY(Category = Streaming, EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "1"))
+	int32 MaxResidentChunks;
+
+	/** Cells per second agents spawned by SpawnCrowd walk on cost 1 ground */
+	UPROPERTY(Category = Crowd, EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0"))
+	float AgentSpeed;
+
+	/** Seconds between new path searches for path agents that have none, after a sidestep or an edit blocked them */
+	UPROPERTY(Category = Crowd, EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0"))
+	float CrowdRepathInterval;
+
 protected:
 	// Begin AActor interface
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void Tick(float DeltaSeconds) override;
 	// End AActor interface
 
 public:
 	/** Handle the block being clicked */
 	void AddScore();
 
+	/** Called by a block after its wall state changed in Graph, keeps derived search data in sync */
+	void OnCellChanged(int32 Index);
+
+	/** Called by a block after its cost changed in Graph */
+	void OnCellCostChanged(int32 Index);
+
 	UFUNCTION(BlueprintCallable)
 	void ResetBoard();
 
@@ -64,6 +271,175 @@ public:
 	UFUNCTION(BlueprintCallable)
 	TArray<APathfindingBlock*> AStarAlgorithm(TArray<APathfindingBlock*> Array);
 
+	/** Dijkstra from the start and the end at once, the end's frontier is highlighted in its own material */
+	UFUNCTION(BlueprintCallable)
+	TArray<APathfindingBlock*> BidirectionalDijkstraAlgorithm(TArray<APathfindingBlock*> Array);
+
+	/** Bidirectional A*, same highlighting as BidirectionalDijkstraAlgorithm */
+	UFUNCTION(BlueprintCallable)
+	TArray<APathfindingBlock*> BidirectionalAStarAlgorithm(TArray<APathfindingBlock*> Array);
+
+	/** Jump Point Search, same path lengths as A* with far fewer visited blocks on open boards. Needs uniform costs */
+	UFUNCTION(BlueprintCallable)
+	TArray<APathfindingBlock*> JumpPointSearch(TArray<APathfindingBlock*> Array);
+
+	/** HPA*, searches between cluster entrances and then fills in the blocks. Near optimal paths, meant for large boards */
+	UFUNCTION(BlueprintCallable)
+	TArray<APathfindingBlock*> HierarchicalSearch(TArray<APathfindingBlock*> Array);
+
+	/**
+	 * Search between two blocks on a worker thread. The search runs on a snapshot of the board taken now, so later edits
+	 * don't affect it. OnComplete fires on the game thread, also when the query is cancelled. Returns the query handle
+	 */
+	UFUNCTION(BlueprintCallable)
+	int32 FindPathAsync(APathfindingBlock* StartBlock, APathfindingBlock* EndBlock, EPathAlgorithm Algorithm, EPathQueryPriority Priority, const FOnPathQueryComplete& OnComplete);
+
+	/** Stop a FindPathAsync query, its callback fires right away with bCancelled set. Returns false if it already finished */
+	UFUNCTION(BlueprintCallable)
+	bool CancelPathQuery(int32 Handle);
+
+	/**
+	 * Path between two blocks without touching the board's highlighting. Repeated queries come from a cache that edits
+	 * only clear where they could change a path; FindPathAsync results are added to it too. Returns false if there is no path
+	 */
+	UFUNCTION(BlueprintCallable)
+	bool FindPathCached(APathfindingBlock* StartBlock, APathfindingBlock* EndBlock, EPathAlgorithm Algorithm, TArray<APathfindingBlock*>& OutPath, int32& OutCost);
+
+	UFUNCTION(BlueprintCallable)
+	FPathCacheStats GetPathCacheStats() const;
+
+	UFUNCTION(BlueprintCallable)
+	void ResetPathCacheStats();
+
+	/** Native version of FindPathAsync on cell indices */
+	int32 RequestPath(int32 Start, int32 Goal, EGridSearchAlgorithm Algorithm, EGridQueryPriority Priority, TFunction<void(const FPathQueryResult&)> OnComplete);
+
+	/**
+	 * Search StartBlocks[i] to EndBlocks[i] for every pair at once, spread over the task graph workers. Blocks until all
+	 * are done and leaves the board's highlighting alone. OutResults is in pair order. Returns queries per second
+	 */
+	UFUNCTION(BlueprintCallable)
+	float SolvePathBatch(const TArray<APathfindingBlock*>& StartBlocks, const TArray<APathfindingBlock*>& EndBlocks, EPathAlgorithm Algorithm, TArray<FPathQueryResult>& OutResults);
+
+	/** Solve NumQueries random pairs on the current board as one batch and log the throughput */
+	UFUNCTION(BlueprintCallable)
+	void BenchmarkPathBatch(int32 NumQueries = 10000, EPathAlgorithm Algorithm = EPathAlgorithm::AStar);
+
+	/**
+	 * Keep a path from the start to the end block on screen and repair it every frame while walls are painted, costs change
+	 * or the start moves. Each repair only visits the blocks whose distance to the end changed
+	 */
+	UFUNCTION(BlueprintCallable)
+	void StartLivePath();
+
+	UFUNCTION(BlueprintCallable)
+	void StopLivePath();
+
+	/** Current live path, start first. Empty if there is none or live paths are off */
+	UPROPERTY(Category = Algorithm, BlueprintReadOnly, VisibleAnywhere)
+	TArray<APathfindingBlock*> LivePath;
+
+	UPROPERTY(Category = Algorithm, BlueprintReadOnly, VisibleAnywhere)
+	int32 LivePathCost;
+
+	/** Blocks the last live repair had to visit */
+	UPROPERTY(Category = Algorithm, BlueprintReadOnly, VisibleAnywhere)
+	int32 LivePathNodesExpanded;
+
+	/** Resume the playback of the last search, from the start if it already finished */
+	UFUNCTION(BlueprintCallable, Category = Playback)
+	void PlaySearch();
+
+	UFUNCTION(BlueprintCallable, Category = Playback)
+	void PauseSearch();
+
+	/** Move the playback to a fraction of the last search, 0 shows nothing and 1 the whole search and path */
+	UFUNCTION(BlueprintCallable, Category = Playback)
+	void SeekSearch(float Alpha);
+
+	/** How far the playback is, 0 to 1 */
+	UFUNCTION(BlueprintCallable, Category = Playback)
+	float GetSearchPlaybackPosition() const;
+
+	UFUNCTION(BlueprintCallable, Category = Playback)
+	bool IsSearchPlaying() const;
+
+	/**
+	 * Compute the route to the nearest of GoalCells from every cell at once, the end block if GoalCells is empty.
+	 * Any number of agents can then step along GetFlowFieldNextCell. Edits keep the field up to date
+	 */
+	UFUNCTION(BlueprintCallable, Category = FlowField)
+	void BuildFlowField(const TArray<int32>& GoalCells);
+
+	/** Cell to step to from Cell towards the flow field's goals, -1 on a goal or where none can be reached */
+	UFUNCTION(BlueprintCallable, Category = FlowField)
+	int32 GetFlowFieldNextCell(int32 Cell) const;
+
+	/** Block version of GetFlowFieldNextCell, null on a goal or where none can be reached */
+	UFUNCTION(BlueprintCallable, Category = FlowField)
+	APathfindingBlock* GetFlowFieldNextBlock(APathfindingBlock* From) const;
+
+	/** Cost from Cell to the nearest flow field goal, -1 if none can be reached */
+	UFUNCTION(BlueprintCallable, Category = FlowField)
+	int32 GetFlowFieldDistance(int32 Cell) const;
+
+	/**
+	 * Add up to NumAgents agents on random free cells. Most follow the flow field, built towards the end block if there
+	 * is none yet; PathAgentFraction of them walk their own path to a random cell instead. Agents are not actors, the
+	 * whole crowd moves in parallel every frame and is drawn by CrowdRenderer. Returns how many were added
+	 */
+	UFUNCTION(BlueprintCallable, Category = Crowd)
+	int32 SpawnCrowd(int32 NumAgents, int32 Seed, float PathAgentFraction = 0.f);
+
+	UFUNCTION(BlueprintCallable, Category = Crowd)
+	void ClearCrowd();
+
+	/** Agents spawned since the last ClearCrowd, including those that arrived */
+	UFUNCTION(BlueprintCallable, Category = Crowd)
+	int32 GetCrowdSize() const;
+
+	/** World location of an agent */
+	UFUNCTION(BlueprintCallable, Category = Crowd)
+	FVector GetAgentLocation(int32 Agent) const;
+
+	/** Make a cell a wall or open it again. Works with blocks and instanced cells */
+	UFUNCTION(BlueprintCallable)
+	void SetCellWall(int32 Index, bool bWall);
+
+	/** Put a cell back to an open cell that is neither start nor end */
+	UFUNCTION(BlueprintCallable)
+	void ResetCell(int32 Index);
+
+	UFUNCTION(BlueprintCallable)
+	void SetCellStart(int32 Index);
+
+	UFUNCTION(BlueprintCallable)
+	void SetCellEnd(int32 Index);
+
+	/** Set the traversal cost of one cell (1 is normal ground) */
+	UFUNCTION(BlueprintCallable)
+	void SetCellCost(int32 Index, int32 Cost);
+
+	/** Cell a trace from Start to End points at, -1 if it misses the board */
+	UFUNCTION(BlueprintCallable)
+	int32 TraceCell(const FVector& Start, const FVector& End) const;
+
+	/** Set the traversal cost of one block (1 is normal ground) */
+	UFUNCTION(BlueprintCallable)
+	void SetBlockCost(APathfindingBlock* Block, int32 Cost);
+
+	/** Set the traversal cost of every block within Radius blocks of Center */
+	UFUNCTION(BlueprintCallable)
+	void PaintCost(APathfindingBlock* Center, int32 Radius, int32 Cost);
+
+	/** Put every block back to cost 1 */
+	UFUNCTION(BlueprintCallable)
+	void ClearCosts();
+
+	/** Time Dijkstra and A* with each open list on the current board and log the results */
+	UFUNCTION(BlueprintCallable)
+	void BenchmarkOpenLists(int32 Iterations = 20);
+
 	UFUNCTION(BlueprintCallable)
 	TArray<APathfindingBlock*> SortBlocksByDistance(TArray<APathfindingBlock*> UnvisitedArray, int LeftIndex, int RightIndex);
 
@@ -72,6 +448,10 @@ public:
 
 	/** Returns DummyRoot subobject **/
 	FORCEINLINE class USceneComponent* GetDummyRoot() const { return DummyRoot; }
+	/** Returns CellRenderer subobject **/
+	FORCEINLINE class UPathfindingCellRenderer* GetCellRenderer() const { return CellRenderer; }
+	/** Returns CrowdRenderer subobject **/
+	FORCEINLINE class UInstancedStaticMeshComponent* GetCrowdRenderer() const { return CrowdRenderer; }
 	/** Returns ScoreText subobject **/
 	FORCEINLINE class UTextRenderComponent* GetScoreText() const { return ScoreText; }
 
@@ -84,20 +464,55 @@ public:
 	UPROPERTY(Category = GridArray, BlueprintReadWrite, VisibleAnywhere)
 	TArray<APathfindingBlock*> UnvisitedNodes;
 
-	UPROPERTY(BlueprintReadWrite)
-	TArray<APathfindingBlock*> MazeGridArray;
-
 	UFUNCTION(BlueprintCallable)
 	void GetShortestPath(TArray<APathfindingBlock*> VisitedNodes);
 
 	UFUNCTION(BlueprintCallable)
 	void HighlightBlock(TArray<APathfindingBlock*> VisitedNodes);
 
-	UFUNCTION(BlueprintCallable)
-	TArray<APathfindingBlock*> CreateMazeGrid();
-
-	UFUNCTION(BlueprintCallable)
-	void MazeGenerator(TArray<APathfindingBlock*> GridArray, int Index, TArray<APathfindingBlock*> VisitedArra);
+	/**
+	 * Clear the board and wall it into a maze. BraidFraction of the dead ends get opened up into loops, 0 keeps the
+	 * maze perfect. The same seed, Size and settings always give the same maze
+	 */
+	UFUNCTION(BlueprintCallable, Category = Maze)
+	void GenerateMaze(int32 Seed, EMazeAlgorithm Algorithm = EMazeAlgorithm::RecursiveBacktracker, float BraidFraction = 0.f);
+
+	/** Time every maze algorithm on a board of this grid's size and log the results. The board itself is left alone */
+	UFUNCTION(BlueprintCallable, Category = Maze)
+	void BenchmarkMazes(int32 Seed, float BraidFraction = 0.f);
+
+	/**
+	 * Start an unbounded maze made of chunks generated on demand. Edited chunks page to Saved/Pathfinding when evicted.
+	 * The board shows a Size x Size window of it through ShowStreamedMazeWindow
+	 */
+	UFUNCTION(BlueprintCallable, Category = Streaming)
+	void StartStreamedMaze(int32 Seed, EMazeAlgorithm Algorithm = EMazeAlgorithm::Eller, float BraidFraction = 0.f);
+
+	/** Clear the board and load the streamed maze cells from (MinX, MinY) into it */
+	UFUNCTION(BlueprintCallable, Category = Streaming)
+	void ShowStreamedMazeWindow(int32 MinX, int32 MinY);
+
+	/** Shortest path between two cells of the streamed maze, which can be far outside the board. Returns -1 if there is none */
+	UFUNCTION(BlueprintCallable, Category = Streaming)
+	int32 FindStreamedPath(int32 StartX, int32 StartY, int32 GoalX, int32 GoalY);
+
+	/** Write the board's walls, costs, start and end to a grid file. Relative names go to Saved/Pathfinding */
+	UFUNCTION(BlueprintCallable, Category = Board)
+	bool SaveBoard(const FString& FileName);
+
+	/**
+	 * Replace the board with a grid file written by SaveBoard, which has to be of this grid's size.
+	 * The file is memory-mapped and fills the graph in one pass
+	 */
+	UFUNCTION(BlueprintCallable, Category = Board)
+	bool LoadBoard(const FString& FileName);
+
+	/**
+	 * Replace the board with a MovingAI benchmark .map, see FGridScenario for how terrain is read. Maps smaller than
+	 * the board sit in its corner with the rest walled off, larger ones are refused
+	 */
+	UFUNCTION(BlueprintCallable, Category = Board)
+	bool ImportMovingAIMap(const FString& FileName);
 
 	int EndDistance;
 
@@ -108,6 +523,130 @@ public:
 
 	int TotalBlocksVisited = 0;
 
+	/** Walls, costs, start and goal mirrored from the blocks. All searches run on this */
+	FGridGraph Graph;
+
+private:
+	/** Run a search on Graph and copy the visited order and distances back onto the blocks */
+	TArray<APathfindingBlock*> RunSearch(EGridSearchAlgorithm Algorithm);
+
+	/** Copy LastSearch onto the blocks. Each block highlights after the smaller of its two distances, the goal side in its own material */
+	TArray<APathfindingBlock*> ShowLastSearch(TFunctionRef<int32(int32)> GetDistanceFromStart, TFunctionRef<int32(int32)> GetDistanceFromGoal, bool bShowHeuristic);
+
+	/** Reused distance/parent buffers */
+	FGridSearch Search;
+
+	/** JPS+ jump distances, built on first use and repaired cell by cell afterwards */
+	FJumpPointTable JumpTable;
+
+	/** Packed walls for bUseBitsetSearch, built on first use and kept in sync cell by cell */
+	FGridBitsetSearch BitsetSearch;
+
+	/** Field from BuildFlowField, repaired by OnCellChanged */
+	FGridFlowField FlowField;
+
+	/** HPA* clusters, built on first use and rebuilt per cluster after edits */
+	FGridHierarchy Hierarchy;
+
+	/** Immutable copy of Graph shared by async queries, dropped on every edit and taken again by the next query */
+	std::shared_ptr<const FGridGraph> GetGraphSnapshot();
+	std::shared_ptr<const FGridGraph> GraphSnapshot;
+
+	/** Called on the game thread when a worker is done with a query */
+	void CompleteQuery(const FGridQuery& Query, const FGridSearchResult& Result);
+
+	/** Convert a core result to blocks, skipping cells that no longer exist */
+	void FillQueryResult(const FGridSearchResult& Result, FPathQueryResult& OutResult) const;
+
+	/** Solve Requests on Graph with one worker per task graph thread */
+	FGridBatchStats RunBatch(const std::vector<FGridPathRequest>& Requests, EGridSearchAlgorithm Algorithm, std::vector<FGridSearchResult>& OutResults);
+
+	/** Per-worker scratch of SolvePathBatch, kept between batches */
+	FGridBatchSearch BatchSearch;
+
+	/** Results of FindPathCached and FindPathAsync, checked on every edit */
+	FGridPathCache PathCache;
+
+	/** Show one playback event on a block or instanced cell */
+	void ApplyPlaybackVisual(int32 Index, EGridPlaybackVisual Visual);
+
+	/** Events per second for the current playback, from PlaybackSpeed or PlaybackDuration */
+	double GetPlaybackRate() const;
+
+	/** Tick only while something plays or a live path is shown */
+	void UpdateTickEnabled();
+
+	/** Report what the graph, the searches' working memory, the flow field, crowd, path cache and streamed maze take up to stat Pathfinding */
+	void UpdateMemoryStats();
+
+	/** Follow start/end moves and repair the live path */
+	void TickLivePath();
+
+	/** Stack and visited buffers of GenerateMaze, kept between mazes */
+	FGridMazeGenerator MazeGenerator;
+
+	/** Show the walls of a freshly filled Graph on the blocks or instanced cells */
+	void ShowGraphWalls();
+
+	/** Show the costs of a freshly filled Graph, like ShowGraphWalls */
+	void ShowGraphCosts();
+
+	/** Full path of a board file, relative names are taken from Saved/Pathfinding */
+	FString GetBoardPath(const FString& FileName) const;
+
+	/** Chunks behind StartStreamedMaze, null until it is called */
+	std::unique_ptr<FGridChunkStore> StreamedMaze;
+	FGridChunkedSearch StreamedSearch;
+
+	/** Agents of SpawnCrowd, stored per field rather than per agent */
+	FGridCrowd Crowd;
+
+	/** Seconds until path agents without a path are searched for again */
+	float CrowdRepathTime = 0.f;
+
+	/** Some agent was moving or waiting after the last crowd update. Once all have arrived or are stuck the crowd stops ticking */
+	bool bCrowdActive = false;
+
+	/** Move the crowd on and upload its instance transforms */
+	void TickCrowd(float DeltaSeconds);
+
+	/** Update the crowd again after an edit or a new flow field, which may give stuck agents a route */
+	void WakeCrowd();
+
+	/** Give every path agent that has no route a new one, solved as one batch */
+	void RepathCrowd();
+
+	/** Location of a point in cells relative to the grid, the same layout the blocks use */
+	FVector GetAgentRelativeLocation(int32 Agent) const;
+
+	/** Reused instance transforms of CrowdRenderer */
+	TArray<FTransform> CrowdTransforms;
+
+	/** Replay of the last search, advanced in Tick */
+	FGridPlayback Playback;
+
+	/** Heat of every cell in the last search, see PathfindingCellData::Heat */
+	TArray<float> CellHeat;
+
+	/** Swap the path material from the old live path to Cells */
+	void ShowLivePath(const std::vector<int32>& Cells);
+
+	/** Cells of the live path on screen */
+	std::vector<int32> LivePathCells;
+
+	/** D* Lite planner behind the live path, kept in sync by OnCellChanged */
+	FGridIncrementalSearch LivePlanner;
+	bool bLivePathActive = false;
+	bool bLivePathDirty = false;
+
+	/** Pending async queries, shared with the worker tasks so it outlives the grid if they are still running */
+	std::shared_ptr<FGridQueryQueue> Queries;
+
+	/** Callbacks of the async queries that haven't completed or been cancelled */
+	TMap<int32, TFunction<void(const FPathQueryResult&)>> QueryCallbacks;
+
+	/** Result of the last search call, read by GetShortestPath */
+	FGridSearchResult LastSearch;
 };
 
 
@@ -0,0 +1,111 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "PathfindingCellMaterial.h"
+#include "PathfindingCellRenderer.h"
+#include "Materials/Material.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+#if WITH_EDITOR
+#include "Materials/MaterialExpressionAdd.h"
+#include "Materials/MaterialExpressionAppendVector.h"
+#include "Materials/MaterialExpressionConstant3Vector.h"
+#include "Materials/MaterialExpressionLinearInterpolate.h"
+#include "Materials/MaterialExpressionMultiply.h"
+#include "Materials/MaterialExpressionPerInstanceCustomData.h"
+#include "Materials/MaterialExpressionVectorParameter.h"
+#endif
+
+namespace PathfindingCellMaterial
+{
+	const TCHAR* PackageName = TEXT("/Game/Puzzle/Meshes/M_PathfindingCell");
+
+	UMaterialInterface* Get()
+	{
+		static UMaterialInterface* Material = nullptr;
+		static bool bLookedUp = false;
+		if (!bLookedUp)
+		{
+			bLookedUp = true;
+
+			//Checked first so a missing asset doesn't log a load error
+			if (FPackageName::DoesPackageExist(PackageName))
+			{
+				const FString ObjectPath = FString(PackageName) + TEXT(".") + FPackageName::GetShortName(PackageName);
+				Material = LoadObject<UMaterialInterface>(nullptr, *ObjectPath, nullptr, LOAD_NoWarn | LOAD_Quiet);
+			}
+#if WITH_EDITOR
+			if (Material == nullptr)
+			{
+				Material = Create(GetTransientPackage(), NAME_None, RF_Transient);
+			}
+#endif
+			if (Material != nullptr)
+			{
+				Material->AddToRoot();
+			}
+			else
+			{
+				UE_LOG(LogTemp, Warning, TEXT("%s is missing, cells fall back to swapping materials. Run -run=PathfindingCellMaterial in the editor to save it"), PackageName);
+			}
+		}
+		return Material;
+	}
+
+#if WITH_EDITOR
+	UMaterial* Create(UObject* Outer, FName Name, EObjectFlags Flags)
+	{
+		UMaterial* Material = NewObject<UMaterial>(Outer, Name, Flags);
+		Material->bUsedWithInstancedStaticMeshes = true;
+
+		auto AddExpression = [Material](auto* Expression)
+		{
+			Material->Expressions.Add(Expression);
+			return Expression;
+		};
+
+		//Blocks set custom primitive data and leave the per-instance data at 0, instanced cells the other way round, so the sum works for both
+		UMaterialExpressionVectorParameter* PrimitiveData = AddExpression(NewObject<UMaterialExpressionVectorParameter>(Material));
+		PrimitiveData->ParameterName = TEXT("CellData");
+		PrimitiveData->DefaultValue = FLinearColor(0.f, 0.f, 0.f, 0.f);
+		PrimitiveData->bUseCustomPrimitiveData = true;
+		PrimitiveData->PrimitiveDataIndex = PathfindingCellData::Red;
+
+		UMaterialExpressionPerInstanceCustomData* InstanceData[PathfindingCellData::Num];
+		for (int32 DataIndex = 0; DataIndex < PathfindingCellData::Num; DataIndex++)
+		{
+			InstanceData[DataIndex] = AddExpression(NewObject<UMaterialExpressionPerInstanceCustomData>(Material));
+			InstanceData[DataIndex]->DataIndex = DataIndex;
+		}
+
+		UMaterialExpressionAppendVector* InstanceRedGreen = AddExpression(NewObject<UMaterialExpressionAppendVector>(Material));
+		InstanceRedGreen->A.Connect(0, InstanceData[PathfindingCellData::Red]);
+		InstanceRedGreen->B.Connect(0, InstanceData[PathfindingCellData::Green]);
+		UMaterialExpressionAppendVector* InstanceColor = AddExpression(NewObject<UMaterialExpressionAppendVector>(Material));
+		InstanceColor->A.Connect(0, InstanceRedGreen);
+		InstanceColor->B.Connect(0, InstanceData[PathfindingCellData::Blue]);
+
+		//Output 0 of a vector parameter is RGB and output 4 is A, which is the heat slot
+		UMaterialExpressionAdd* Color = AddExpression(NewObject<UMaterialExpressionAdd>(Material));
+		Color->A.Connect(0, PrimitiveData);
+		Color->B.Connect(0, InstanceColor);
+		UMaterialExpressionAdd* Heat = AddExpression(NewObject<UMaterialExpressionAdd>(Material));
+		Heat->A.Connect(4, PrimitiveData);
+		Heat->B.Connect(0, InstanceData[PathfindingCellData::Heat]);
+
+		//Farther visited cells shade toward a warm tint, never all the way so the visual's color still reads
+		UMaterialExpressionMultiply* HeatAmount = AddExpression(NewObject<UMaterialExpressionMultiply>(Material));
+		HeatAmount->A.Connect(0, Heat);
+		HeatAmount->ConstB = 0.6f;
+		UMaterialExpressionConstant3Vector* HeatTint = AddExpression(NewObject<UMaterialExpressionConstant3Vector>(Material));
+		HeatTint->Constant = FLinearColor(1.f, 0.3f, 0.05f);
+		UMaterialExpressionLinearInterpolate* BaseColor = AddExpression(NewObject<UMaterialExpressionLinearInterpolate>(Material));
+		BaseColor->A.Connect(0, Color);
+		BaseColor->B.Connect(0, HeatTint);
+		BaseColor->Alpha.Connect(0, HeatAmount);
+
+		Material->BaseColor.Connect(0, BaseColor);
+		Material->PostEditChange();
+		return Material;
+	}
+#endif
+}
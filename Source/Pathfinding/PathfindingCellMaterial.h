@@ -0,0 +1,27 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UMaterial;
+class UMaterialInterface;
+
+/**
+ * The material blocks and instanced cells share. It reads color and heat laid out as in PathfindingCellData, from custom
+ * primitive data on blocks and from per-instance custom data on UPathfindingCellRenderer, so looks change without swaps.
+ * The asset is written by the PathfindingCellMaterial commandlet. Editor builds make it on the fly until then.
+ */
+namespace PathfindingCellMaterial
+{
+	/** Long package name the commandlet saves the material to */
+	PATHFINDING_API extern const TCHAR* PackageName;
+
+	/** The saved material, or in editor builds a transient one when it hasn't been saved yet. Null in a cooked build without the asset */
+	PATHFINDING_API UMaterialInterface* Get();
+
+#if WITH_EDITOR
+	/** Build the material's expression graph and compile it */
+	PATHFINDING_API UMaterial* Create(UObject* Outer, FName Name, EObjectFlags Flags);
+#endif
+}
@@ -0,0 +1,47 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "PathfindingCellMaterialCommandlet.h"
+#include "PathfindingCellMaterial.h"
+#include "Materials/Material.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+
+UPathfindingCellMaterialCommandlet::UPathfindingCellMaterialCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+	ShowErrorCount = true;
+}
+
+int32 UPathfindingCellMaterialCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	const FString PackageName = PathfindingCellMaterial::PackageName;
+	const FString AssetName = FPackageName::GetShortName(PackageName);
+	UPackage* Package = CreatePackage(nullptr, *PackageName);
+
+	//A loaded copy would be replaced in place, move it aside so the new one gets a clean object
+	if (UObject* Existing = StaticFindObject(nullptr, Package, *AssetName))
+	{
+		Existing->Rename(nullptr, GetTransientPackage(), REN_DontCreateRedirectors | REN_NonTransactional);
+	}
+
+	UMaterial* Material = PathfindingCellMaterial::Create(Package, *AssetName, RF_Public | RF_Standalone);
+	Package->MarkPackageDirty();
+
+	const FString FileName = FPackageName::LongPackageNameToFilename(PackageName, FPackageName::GetAssetPackageExtension());
+	if (!UPackage::SavePackage(Package, Material, RF_Public | RF_Standalone, *FileName))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Couldn't save %s"), *FileName);
+		return 1;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Saved the cell material to %s"), *FileName);
+	return 0;
+#else
+	UE_LOG(LogTemp, Error, TEXT("The cell material can only be built in the editor"));
+	return 1;
+#endif
+}
@@ -0,0 +1,25 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "PathfindingCellMaterialCommandlet.generated.h"
+
+/**
+ * Saves the cell material blocks and instanced cells share (see PathfindingCellMaterial) as a content asset, so cooked
+ * builds have it too. Overwrites the asset if it is there:
+ *   UE4Editor-Cmd Pathfinding.uproject -run=PathfindingCellMaterial
+ */
+UCLASS()
+class UPathfindingCellMaterialCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UPathfindingCellMaterialCommandlet();
+
+	// Begin UCommandlet interface
+	virtual int32 Main(const FString& Params) override;
+	// End UCommandlet interface
+};
@@ -0,0 +1,221 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "PathfindingCellRenderer.h"
+#include "PathfindingCellMaterial.h"
+#include "PathfindingStats.h"
+#include "UObject/ConstructorHelpers.h"
+#include "Engine/StaticMesh.h"
+#include "Materials/MaterialInterface.h"
+
+UPathfindingCellRenderer::UPathfindingCellRenderer(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	// Structure to hold one-time initialization
+	struct FConstructorStatics
+	{
+		ConstructorHelpers::FObjectFinderOptional<UStaticMesh> PlaneMesh;
+		FConstructorStatics()
+			: PlaneMesh(TEXT("/Game/Puzzle/Meshes/PuzzleCube.PuzzleCube"))
+		{
+		}
+	};
+	static FConstructorStatics ConstructorStatics;
+
+	SetStaticMesh(ConstructorStatics.PlaneMesh.Get());
+	//Left empty for BuildCells to fill in, the shared material may have to be built and that can't happen in a constructor
+	CellMaterial = nullptr;
+
+	CellColors.SetNum((int32)EPathCellVisual::Num);
+	for (int32 Visual = 0; Visual < (int32)EPathCellVisual::Num; Visual++)
+	{
+		CellColors[Visual] = GetDefaultCellColor(static_cast<EPathCellVisual>(Visual));
+	}
+
+	NumCustomDataFloats = PathfindingCellData::Num;
+	bInstanceCollision = false;
+	SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	SetCastShadow(false);
+
+	//Only ticks on frames with changes to flush
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	PrimaryComponentTick.TickGroup = TG_PostUpdateWork;
+}
+
+void UPathfindingCellRenderer::BuildCells(int32 InWidth, int32 InHeight, float InSpacing)
+{
+	Width = InWidth;
+	Height = InHeight;
+	Spacing = InSpacing;
+
+	ClearInstances();
+	if (CellMaterial == nullptr)
+	{
+		CellMaterial = PathfindingCellMaterial::Get();
+	}
+	SetMaterial(0, CellMaterial);
+	SetCollisionEnabled(bInstanceCollision ? ECollisionEnabled::QueryOnly : ECollisionEnabled::NoCollision);
+
+	const int32 NumCells = Width * Height;
+	TArray<FTransform> Transforms;
+	Transforms.Reserve(NumCells);
+	for (int32 Index = 0; Index < NumCells; Index++)
+	{
+		Transforms.Add(GetCellTransform(Index, 1));
+	}
+	AddInstances(Transforms, false);
+
+	Visuals.Init((uint8)EPathCellVisual::Open, NumCells);
+	const FLinearColor& Open = CellColors[(int32)EPathCellVisual::Open];
+	for (int32 Index = 0; Index < NumCells; Index++)
+	{
+		float* CustomData = &PerInstanceSMCustomData[Index * PathfindingCellData::Num];
+		CustomData[PathfindingCellData::Red] = Open.R;
+		CustomData[PathfindingCellData::Green] = Open.G;
+		CustomData[PathfindingCellData::Blue] = Open.B;
+		CustomData[PathfindingCellData::Heat] = 0.f;
+	}
+
+	MarkCellsDirty();
+}
+
+void UPathfindingCellRenderer::SetCellVisual(int32 Index, EPathCellVisual Visual)
+{
+	if (!Visuals.IsValidIndex(Index) || Visuals[Index] == (uint8)Visual)
+	{
+		return;
+	}
+
+	Visuals[Index] = (uint8)Visual;
+	const FLinearColor& Color = CellColors[(int32)Visual];
+	SetCustomDataValue(Index, PathfindingCellData::Red, Color.R, false);
+	SetCustomDataValue(Index, PathfindingCellData::Green, Color.G, false);
+	SetCustomDataValue(Index, PathfindingCellData::Blue, Color.B, false);
+	INC_DWORD_STAT(STAT_PathfindingParameterWrites);
+	MarkCellsDirty();
+}
+
+void UPathfindingCellRenderer::SetCellHeat(int32 Index, float Heat)
+{
+	if (Visuals.IsValidIndex(Index))
+	{
+		SetCustomDataValue(Index, PathfindingCellData::Heat, Heat, false);
+		INC_DWORD_STAT(STAT_PathfindingParameterWrites);
+		MarkCellsDirty();
+	}
+}
+
+void UPathfindingCellRenderer::SetCellCost(int32 Index, int32 Cost)
+{
+	if (Visuals.IsValidIndex(Index))
+	{
+		UpdateInstanceTransform(Index, GetCellTransform(Index, Cost), false, false, true);
+		MarkCellsDirty();
+	}
+}
+
+int32 UPathfindingCellRenderer::GetCellAtLocation(const FVector& WorldLocation) const
+{
+	if (Spacing <= 0.f)
+	{
+		return INDEX_NONE;
+	}
+
+	//Rows run along local X and columns along local Y, like the spawned blocks
+	const FVector Local = GetComponentTransform().InverseTransformPosition(WorldLocation);
+	const int32 Row = FMath::RoundToInt(Local.X / Spacing);
+	const int32 Column = FMath::RoundToInt(Local.Y / Spacing);
+	if (Row < 0 || Row >= Height || Column < 0 || Column >= Width)
+	{
+		return INDEX_NONE;
+	}
+	return Row * Width + Column;
+}
+
+int32 UPathfindingCellRenderer::TraceCell(const FVector& Start, const FVector& End) const
+{
+	const FPlane GridPlane(GetComponentLocation(), GetUpVector());
+	const FVector Direction = End - Start;
+	if (FMath::IsNearlyZero(FVector::DotProduct(Direction, GridPlane)))
+	{
+		return INDEX_NONE;
+	}
+
+	const FVector Hit = FMath::LinePlaneIntersection(Start, End, GridPlane);
+	if (FVector::DotProduct(Hit - Start, Direction) < 0.f || (Hit - Start).SizeSquared() > Direction.SizeSquared())
+	{
+		return INDEX_NONE;
+	}
+	return GetCellAtLocation(Hit);
+}
+
+int32 UPathfindingCellRenderer::GetCellFromHit(const FHitResult& Hit) const
+{
+	if (Hit.Component.Get() != this)
+	{
+		return INDEX_NONE;
+	}
+	return Visuals.IsValidIndex(Hit.Item) ? Hit.Item : GetCellAtLocation(Hit.ImpactPoint);
+}
+
+FVector UPathfindingCellRenderer::GetCellLocation(int32 Index) const
+{
+	return GetComponentTransform().TransformPosition(GetCellTransform(Index, 1).GetLocation());
+}
+
+FLinearColor UPathfindingCellRenderer::GetDefaultCellColor(EPathCellVisual Visual)
+{
+	//Close to the block materials
+	switch (Visual)
+	{
+	case EPathCellVisual::Wall:
+		return FLinearColor(0.8f, 0.25f, 0.02f);
+	case EPathCellVisual::Start:
+		return FLinearColor(1.f, 0.7f, 0.1f);
+	case EPathCellVisual::End:
+		return FLinearColor(0.4f, 0.05f, 0.6f);
+	case EPathCellVisual::Visited:
+		return FLinearColor(0.9f, 0.9f, 0.9f);
+	case EPathCellVisual::VisitedFromGoal:
+		return FLinearColor(0.95f, 0.45f, 0.25f);
+	case EPathCellVisual::Path:
+		return FLinearColor(0.1f, 0.8f, 0.2f);
+	default:
+		return FLinearColor(0.02f, 0.08f, 0.4f);
+	}
+}
+
+void UPathfindingCellRenderer::FlushCells()
+{
+	if (bCellsDirty)
+	{
+		//Instance data only reaches the GPU with a new render state, but once per frame rather than per cell
+		INC_DWORD_STAT(STAT_PathfindingRenderStateRebuilds);
+		bCellsDirty = false;
+		MarkRenderStateDirty();
+		SetComponentTickEnabled(false);
+	}
+}
+
+void UPathfindingCellRenderer::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	FlushCells();
+}
+
+FTransform UPathfindingCellRenderer::GetCellTransform(int32 Index, int32 Cost) const
+{
+	const float XOffset = (Index / Width) * Spacing;
+	const float YOffset = (Index % Width) * Spacing;
+	return FTransform(FRotator::ZeroRotator, FVector(XOffset, YOffset, 0.f), FVector(0.25f, 0.25f, 1.0f + (Cost - 1) * 0.05f));
+}
+
+void UPathfindingCellRenderer::MarkCellsDirty()
+{
+	if (!bCellsDirty)
+	{
+		bCellsDirty = true;
+		SetComponentTickEnabled(true);
+	}
+}
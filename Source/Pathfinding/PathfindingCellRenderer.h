@@ -0,0 +1,114 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "PathfindingCellRenderer.generated.h"
+
+/** What a cell currently shows. Each one maps to a color in UPathfindingCellRenderer::CellColors */
+UENUM(BlueprintType)
+enum class EPathCellVisual : uint8
+{
+	Open,
+	Wall,
+	Start,
+	End,
+	Visited,
+	/** Visited by the backward half of a bidirectional search */
+	VisitedFromGoal,
+	Path,
+	Num UMETA(Hidden)
+};
+
+/** Custom data layout shared by the block and instanced cell materials */
+namespace PathfindingCellData
+{
+	enum : int32
+	{
+		Red,
+		Green,
+		Blue,
+		/** 0 at the start to 1 at the farthest visited cell, 0 while unvisited */
+		Heat,
+		Num
+	};
+}
+
+/**
+ * Draws every cell of a grid as one instance of a single mesh, instance index = cell index.
+ * Color and heat go to per-instance custom data (see PathfindingCellData), so CellMaterial has to read PerInstanceCustomData.
+ * Changes are batched and sent to the render thread once per frame. Picking works without per-instance collision by
+ * intersecting the trace with the grid plane.
+ */
+UCLASS(minimalapi, ClassGroup = Pathfinding, meta = (BlueprintSpawnableComponent))
+class UPathfindingCellRenderer : public UInstancedStaticMeshComponent
+{
+	GENERATED_BODY()
+
+public:
+	UPathfindingCellRenderer(const FObjectInitializer& ObjectInitializer);
+
+	/** Color of each EPathCellVisual, indexed by the enum */
+	UPROPERTY(Category = Cells, EditAnywhere, BlueprintReadWrite)
+	TArray<FLinearColor> CellColors;
+
+	/** Material reading color and heat from PerInstanceCustomData, laid out as in PathfindingCellData. PathfindingCellMaterial's when left empty */
+	UPROPERTY(Category = Cells, EditAnywhere, BlueprintReadWrite)
+	class UMaterialInterface* CellMaterial;
+
+	/** Give every instance a physics body so traces report Hit.Item. Costly on large grids, picking works without it */
+	UPROPERTY(Category = Cells, EditAnywhere, BlueprintReadWrite)
+	bool bInstanceCollision;
+
+	/** Replace all instances with a Width x Height grid of cells, Spacing apart, all Open */
+	void BuildCells(int32 InWidth, int32 InHeight, float InSpacing);
+
+	int32 GetNumCells() const { return Visuals.Num(); }
+
+	EPathCellVisual GetCellVisual(int32 Index) const { return static_cast<EPathCellVisual>(Visuals[Index]); }
+
+	/** Recolor a cell, sent with the next flush */
+	void SetCellVisual(int32 Index, EPathCellVisual Visual);
+
+	/** Set a cell's heat, 0 to 1 */
+	void SetCellHeat(int32 Index, float Heat);
+
+	/** Raise a cell to show its traversal cost, the same way blocks do */
+	void SetCellCost(int32 Index, int32 Cost);
+
+	/** Cell under a world location, INDEX_NONE if it is off the grid */
+	int32 GetCellAtLocation(const FVector& WorldLocation) const;
+
+	/** Cell a trace from Start to End points at, INDEX_NONE if it misses the grid */
+	int32 TraceCell(const FVector& Start, const FVector& End) const;
+
+	/** Cell a hit on this component landed on */
+	int32 GetCellFromHit(const FHitResult& Hit) const;
+
+	/** World position of a cell's center */
+	FVector GetCellLocation(int32 Index) const;
+
+	/** Color cells and blocks use for a visual unless told otherwise */
+	static FLinearColor GetDefaultCellColor(EPathCellVisual Visual);
+
+	/** Push batched changes to the render thread now instead of at the end of the frame */
+	void FlushCells();
+
+	// Begin UActorComponent interface
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	// End UActorComponent interface
+
+private:
+	FTransform GetCellTransform(int32 Index, int32 Cost) const;
+
+	void MarkCellsDirty();
+
+	/** EPathCellVisual of every cell */
+	TArray<uint8> Visuals;
+
+	int32 Width = 0;
+	int32 Height = 0;
+	float Spacing = 0.f;
+	bool bCellsDirty = false;
+};
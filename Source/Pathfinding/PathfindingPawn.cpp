@@ -2,6 +2,9 @@
 
 #include "PathfindingPawn.h"
 #include "PathfindingBlock.h"
+#include "PathfindingBlockGrid.h"
+#include "PathfindingStats.h"
+#include "EngineUtils.h"
 #include "HeadMountedDisplayFunctionLibrary.h"
 #include "Camera/CameraComponent.h"
 #include "GameFramework/PlayerController.h"
@@ -12,6 +15,7 @@ APathfindingPawn::APathfindingPawn(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
 	AutoPossessPlayer = EAutoReceiveInput::Player0;
+	CurrentGridFocus = nullptr;
 }
 
 void APathfindingPawn::Tick(float DeltaSeconds)
@@ -84,6 +88,10 @@ void APathfindingPawn::SetStart()
 	{
 		CurrentBlockFocus->HandleClicked("Start");
 	}
+	else if (CurrentGridFocus)
+	{
+		CurrentGridFocus->SetCellStart(CurrentCellFocus);
+	}
 }
 
 void APathfindingPawn::SetEnd()
@@ -95,6 +103,10 @@ void APathfindingPawn::SetEnd()
 	{
 		CurrentBlockFocus->HandleClicked("End");
 	}
+	else if (CurrentGridFocus)
+	{
+		CurrentGridFocus->SetCellEnd(CurrentCellFocus);
+	}
 }
 
 void APathfindingPawn::SetWall()
@@ -104,6 +116,10 @@ void APathfindingPawn::SetWall()
 	{
 		CurrentBlockFocus->HandleClicked("Wall");
 	}
+	else if (CurrentGridFocus)
+	{
+		CurrentGridFocus->SetCellWall(CurrentCellFocus, true);
+	}
 }
 
 void APathfindingPawn::ReleaseWall()
@@ -118,6 +134,10 @@ void APathfindingPawn::ResetBlock()
 	{
 		CurrentBlockFocus->HandleClicked("Reset");
 	}
+	else if (CurrentGridFocus)
+	{
+		CurrentGridFocus->ResetCell(CurrentCellFocus);
+	}
 }
 
 void APathfindingPawn::ReleaseReset()
@@ -132,6 +152,9 @@ void APathfindingPawn::ResetBoard()
 
 void APathfindingPawn::TraceForBlock(const FVector& Start, const FVector& End, bool bDrawDebugHelpers)
 {
+	PATHFINDING_SCOPE_CYCLE_COUNTER(STAT_PathfindingPawnTrace);
+	INC_DWORD_STAT(STAT_PathfindingTraces);
+
 	FHitResult HitResult;
 	GetWorld()->LineTraceSingleByChannel(HitResult, Start, End, ECC_Visibility);
 	if (bDrawDebugHelpers)
@@ -142,6 +165,13 @@ void APathfindingPawn::TraceForBlock(const FVector& Start, const FVector& End, b
 	if (HitResult.Actor.IsValid())
 	{
 		APathfindingBlock* HitBlock = Cast<APathfindingBlock>(HitResult.Actor.Get());
+		if ((HitBlock == nullptr) && (CurrentBlockFocus == nullptr) && TraceForCell(Start, End))
+		{
+			return;
+		}
+
+		CurrentGridFocus = nullptr;
+		CurrentCellFocus = -1;
 		if (CurrentBlockFocus != HitBlock)
 		{
 			if (bLeftMouseHeld)
@@ -170,4 +200,40 @@ void APathfindingPawn::TraceForBlock(const FVector& Start, const FVector& End, b
 		CurrentBlockFocus->Highlight(false);
 		CurrentBlockFocus = nullptr;
 	}
+	else
+	{
+		TraceForCell(Start, End);
+	}
+}
+
+bool APathfindingPawn::TraceForCell(const FVector& Start, const FVector& End)
+{
+	//Instanced cells have no collision, so the trace is intersected with each grid's plane instead
+	for (TActorIterator<APathfindingBlockGrid> It(GetWorld()); It; ++It)
+	{
+		const int32 Cell = It->TraceCell(Start, End);
+		if (Cell != -1)
+		{
+			if ((CurrentGridFocus != *It) || (CurrentCellFocus != Cell))
+			{
+				CurrentGridFocus = *It;
+				CurrentCellFocus = Cell;
+
+				//Dragging paints every cell the cursor passes
+				if (bLeftMouseHeld)
+				{
+					SetWall();
+				}
+				else if (bRightMouseHeld)
+				{
+					ResetBlock();
+				}
+			}
+			return true;
+		}
+	}
+
+	CurrentGridFocus = nullptr;
+	CurrentCellFocus = -1;
+	return false;
 }
\ No newline at end of file
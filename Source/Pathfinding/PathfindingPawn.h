@@ -35,4 +35,15 @@ protected:
 
 	UPROPERTY(EditInstanceOnly, BlueprintReadWrite)
 	class APathfindingBlock* CurrentBlockFocus;
+
+	/** Grid whose instanced cell is under the cursor, when there is no block there */
+	UPROPERTY(EditInstanceOnly, BlueprintReadWrite)
+	class APathfindingBlockGrid* CurrentGridFocus;
+
+	/** Instanced cell under the cursor, -1 if none */
+	UPROPERTY(EditInstanceOnly, BlueprintReadWrite)
+	int32 CurrentCellFocus = -1;
+
+	/** Trace the instanced grids when no block was hit, returns true if a cell is under the trace */
+	bool TraceForCell(const FVector& Start, const FVector& End);
 };
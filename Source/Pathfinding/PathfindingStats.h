@@ -0,0 +1,96 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+/** stat Pathfinding */
+DECLARE_STATS_GROUP(TEXT("Pathfinding"), STATGROUP_Pathfinding, STATCAT_Advanced);
+
+/**
+ * Times the rest of the scope for stat Pathfinding and marks it as a CPU event in Insights captures.
+ * The trace event is there even in builds without stats, Insights needs -trace=cpu
+ */
+#define PATHFINDING_SCOPE_CYCLE_COUNTER(Stat) \
+	TRACE_CPUPROFILER_EVENT_SCOPE(Stat); \
+	SCOPE_CYCLE_COUNTER(Stat)
+
+/** One search over the graph, Dijkstra, A*, their bidirectional versions, Jump Point Search or HPA* */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Search"), STAT_PathfindingSearch, STATGROUP_Pathfinding, PATHFINDING_API);
+
+/** Handing a finished search to the blocks and building its playback */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Show Search"), STAT_PathfindingShowSearch, STATGROUP_Pathfinding, PATHFINDING_API);
+
+/** Marking the blocks of the last search's path */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Shortest Path"), STAT_PathfindingShortestPath, STATGROUP_Pathfinding, PATHFINDING_API);
+
+/** Carving a maze and showing its walls */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Generate Maze"), STAT_PathfindingGenerateMaze, STATGROUP_Pathfinding, PATHFINDING_API);
+
+/** Clearing every block, cost and derived structure */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Reset Board"), STAT_PathfindingResetBoard, STATGROUP_Pathfinding, PATHFINDING_API);
+
+/** Building a flow field from scratch */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Flow Field Build"), STAT_PathfindingFlowFieldBuild, STATGROUP_Pathfinding, PATHFINDING_API);
+
+/** The grid's whole tick, which drives the blocks: playback, live path and crowd */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Grid Tick"), STAT_PathfindingGridTick, STATGROUP_Pathfinding, PATHFINDING_API);
+
+/** Playback steps applied to blocks and cells during the grid's tick */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Playback"), STAT_PathfindingPlayback, STATGROUP_Pathfinding, PATHFINDING_API);
+
+/** Following the moved start or end with a new path during the grid's tick */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Live Path"), STAT_PathfindingLivePath, STATGROUP_Pathfinding, PATHFINDING_API);
+
+/** The pawn's traces for the block or cell under the cursor */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Pawn Trace"), STAT_PathfindingPawnTrace, STATGROUP_Pathfinding, PATHFINDING_API);
+
+/** Nodes the searches took off their open lists */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Nodes Expanded"), STAT_PathfindingNodesExpanded, STATGROUP_Pathfinding, PATHFINDING_API);
+
+/** Line traces the pawn cast into the world */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Pawn Traces"), STAT_PathfindingTraces, STATGROUP_Pathfinding, PATHFINDING_API);
+
+/** Blocks given a different material, each one also counts as a render state rebuild */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Block Material Swaps"), STAT_PathfindingMaterialSwaps, STATGROUP_Pathfinding, PATHFINDING_API);
+
+/** The graph, one byte per cell */
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Graph Memory"), STAT_PathfindingGraphMemory, STATGROUP_Pathfinding, PATHFINDING_API);
+
+/** Working memory the searches keep between runs: open lists, distances, jump tables, the cluster graph, the D* Lite planner and the batch and async workers */
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Search Memory"), STAT_PathfindingSearchMemory, STATGROUP_Pathfinding, PATHFINDING_API);
+
+/** The flow field and its repair buffers */
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Flow Field Memory"), STAT_PathfindingFlowFieldMemory, STATGROUP_Pathfinding, PATHFINDING_API);
+
+/** The crowd's agents, their paths and the board's occupancy */
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Crowd Memory"), STAT_PathfindingCrowdMemory, STATGROUP_Pathfinding, PATHFINDING_API);
+
+/** Paths FindPathCached keeps */
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Path Cache Memory"), STAT_PathfindingPathCacheMemory, STATGROUP_Pathfinding, PATHFINDING_API);
+
+/** Resident chunks of the streamed maze and the search over them, the page file on disk not counted */
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Streamed Maze Memory"), STAT_PathfindingStreamingMemory, STATGROUP_Pathfinding, PATHFINDING_API);
+
+/** Cell look changes that recreated render state: material swaps on blocks and instance buffer uploads */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Cell Render State Rebuilds"), STAT_PathfindingRenderStateRebuilds, STATGROUP_Pathfinding, PATHFINDING_API);
+
+/** Cell look changes done by writing custom primitive or instance data, each one a rebuild a material swap would have cost */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Cell Parameter Writes"), STAT_PathfindingParameterWrites, STATGROUP_Pathfinding, PATHFINDING_API);
+
+/** Time FGridCrowd::Update takes for the whole crowd, across all worker threads */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Crowd Update"), STAT_PathfindingCrowdUpdate, STATGROUP_Pathfinding, PATHFINDING_API);
+
+/** Time spent writing the crowd's instance transforms */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Crowd Render"), STAT_PathfindingCrowdRender, STATGROUP_Pathfinding, PATHFINDING_API);
+
+/** Agents still on the board */
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Crowd Agents"), STAT_PathfindingCrowdAgents, STATGROUP_Pathfinding, PATHFINDING_API);
+
+/** Agents between two cells */
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Crowd Agents Moving"), STAT_PathfindingCrowdMoving, STATGROUP_Pathfinding, PATHFINDING_API);
+
+/** Agents held up by an occupied cell */
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Crowd Agents Waiting"), STAT_PathfindingCrowdWaiting, STATGROUP_Pathfinding, PATHFINDING_API);
@@ -0,0 +1,132 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "GridCore/GridBenchmark.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/**
+ * Headless driver of the benchmark suite, the same switches as the PathfindingBenchmark commandlet without the editor:
+ *   GridCoreBenchmark -sizes=25,256,1024 -seeds=1,2 -iterations=3 -csv=Benchmark.csv -json=Benchmark.json -baseline=Baseline.csv
+ * Exits 1 when the results can't be written, the baseline can't be read or a case regressed against it.
+ */
+namespace GridCoreBenchmark
+{
+	/** Value of -Name=Value, nullptr if the switch isn't there */
+	const char* FindValue(int argc, char** argv, const char* Name)
+	{
+		const size_t Length = std::strlen(Name);
+		for (int i = 1; i < argc; i++)
+		{
+			if ((argv[i][0] == '-') && (std::strncmp(argv[i] + 1, Name, Length) == 0) && (argv[i][Length + 1] == '='))
+			{
+				return argv[i] + Length + 2;
+			}
+		}
+		return nullptr;
+	}
+
+	/** Parse a comma separated -Name=1,2,3 list, Values is left alone if the switch isn't there */
+	template <typename ValueType>
+	void ParseList(int argc, char** argv, const char* Name, std::vector<ValueType>& Values)
+	{
+		const char* List = FindValue(argc, argv, Name);
+		if (List == nullptr)
+		{
+			return;
+		}
+
+		Values.clear();
+		const char* Item = List;
+		while (*Item != 0)
+		{
+			Values.push_back((ValueType)std::atoi(Item));
+			const char* Comma = std::strchr(Item, ',');
+			Item = Comma != nullptr ? Comma + 1 : Item + std::strlen(Item);
+		}
+	}
+
+	template <typename ValueType>
+	void ParseValue(int argc, char** argv, const char* Name, ValueType& Value)
+	{
+		if (const char* Text = FindValue(argc, argv, Name))
+		{
+			Value = (ValueType)std::atof(Text);
+		}
+	}
+
+	void ParseString(int argc, char** argv, const char* Name, std::string& Value)
+	{
+		if (const char* Text = FindValue(argc, argv, Name))
+		{
+			Value = Text;
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	using namespace GridCoreBenchmark;
+
+	FGridBenchmarkSuiteSettings Settings;
+	ParseList(argc, argv, "sizes", Settings.Sizes);
+	ParseList(argc, argv, "seeds", Settings.Seeds);
+	ParseValue(argc, argv, "iterations", Settings.Iterations);
+	ParseValue(argc, argv, "density", Settings.ObstacleDensity);
+	ParseValue(argc, argv, "braid", Settings.BraidFraction);
+
+	std::string CsvPath = "Benchmark.csv";
+	std::string JsonPath = "Benchmark.json";
+	std::string BaselinePath;
+	ParseString(argc, argv, "csv", CsvPath);
+	ParseString(argc, argv, "json", JsonPath);
+	ParseString(argc, argv, "baseline", BaselinePath);
+
+	const std::vector<FGridBenchmarkRecord> Records = FGridBenchmark::RunSuite(Settings, [](const FGridBenchmarkRecord& Record)
+	{
+		printf("%s %d seed %u %s: %.3f ms, %d expanded, peak open %d, %lld bytes, cost %d\n",
+			Record.Map.c_str(), Record.Size, Record.Seed, Record.Mode.c_str(), Record.Milliseconds,
+			Record.NodesExpanded, Record.PeakOpenListSize, Record.Bytes, Record.bFound ? Record.Cost : -1);
+	});
+
+	if (!FGridBenchmark::WriteCsv(CsvPath.c_str(), Records) || !FGridBenchmark::WriteJson(JsonPath.c_str(), Records))
+	{
+		printf("Couldn't write the results to %s and %s\n", CsvPath.c_str(), JsonPath.c_str());
+		return 1;
+	}
+	printf("%d cases written to %s and %s\n", (int32)Records.size(), CsvPath.c_str(), JsonPath.c_str());
+
+	if (BaselinePath.empty())
+	{
+		return 0;
+	}
+
+	std::vector<FGridBenchmarkRecord> Baseline;
+	if (!FGridBenchmark::ReadCsv(BaselinePath.c_str(), Baseline))
+	{
+		printf("Couldn't read the baseline %s\n", BaselinePath.c_str());
+		return 1;
+	}
+
+	FGridBenchmarkThresholds Thresholds;
+	ParseValue(argc, argv, "maxtimeratio", Thresholds.MaxTimeRatio);
+	ParseValue(argc, argv, "mingatedms", Thresholds.MinGatedMilliseconds);
+	ParseValue(argc, argv, "maxnodesratio", Thresholds.MaxNodesRatio);
+	ParseValue(argc, argv, "maxpeakratio", Thresholds.MaxPeakOpenListRatio);
+	ParseValue(argc, argv, "maxbytesratio", Thresholds.MaxBytesRatio);
+
+	const std::vector<FGridBenchmarkRegression> Regressions = FGridBenchmark::FindRegressions(Records, Baseline, Thresholds);
+	for (const FGridBenchmarkRegression& Regression : Regressions)
+	{
+		if (Regression.Metric == "missing")
+		{
+			printf("Regression in %s: in the baseline but not run\n", Regression.Key.c_str());
+			continue;
+		}
+		printf("Regression in %s: %s went from %.3f to %.3f\n", Regression.Key.c_str(), Regression.Metric.c_str(), Regression.Baseline, Regression.Current);
+	}
+	printf("%d regressions against %s\n", (int32)Regressions.size(), BaselinePath.c_str());
+	return Regressions.empty() ? 0 : 1;
+}
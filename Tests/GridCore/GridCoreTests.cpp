@@ -0,0 +1,905 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "GridCore/GridGraph.h"
+#include "GridCore/GridSearch.h"
+#include "GridCore/GridBenchmark.h"
+#include "GridCore/JumpPointSearch.h"
+#include "GridCore/GridBitsetSearch.h"
+#include "GridCore/HierarchicalSearch.h"
+#include "GridCore/IncrementalSearch.h"
+#include "GridCore/FlowField.h"
+#include "GridCore/GridCrowd.h"
+#include "GridCore/GridMaze.h"
+#include "GridCore/GridFile.h"
+#include "GridCore/GridQueryQueue.h"
+#include "GridCore/GridPathCache.h"
+#include "GridCore/GridChunkStore.h"
+#include "GridCore/GridChunkedSearch.h"
+#include "GridCore/GridScenario.h"
+#include "GridCore/GridRandom.h"
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <string>
+#include <vector>
+
+/**
+ * Headless checks of the grid core against a plain reference Dijkstra. Run with no arguments for every test, or with
+ * test names to run only those. Exits non-zero if any check fails.
+ */
+namespace GridCoreTests
+{
+	int32 NumFailures = 0;
+
+	void Check(bool bCondition, const char* Test, const char* What, int32 Detail = 0)
+	{
+		if (!bCondition)
+		{
+			//Only the first few of a kind, a broken search would otherwise print thousands of lines
+			if (NumFailures < 50)
+			{
+				printf("FAIL %s: %s (%d)\n", Test, What, Detail);
+			}
+			NumFailures++;
+		}
+	}
+
+	/** Cost of the cheapest 4-connected path, stepping onto a cell costs the cell's cost. GridUnreachable if none */
+	int32 ReferenceCost(const FGridGraph& Graph, int32 Start, int32 Goal)
+	{
+		std::vector<int32> Distance(Graph.Num(), GridUnreachable);
+		typedef std::pair<int32, int32> FEntry;
+		std::priority_queue<FEntry, std::vector<FEntry>, std::greater<FEntry>> Open;
+		Distance[Start] = 0;
+		Open.push(FEntry(0, Start));
+		while (!Open.empty())
+		{
+			const FEntry Top = Open.top();
+			Open.pop();
+			if (Top.first > Distance[Top.second])
+			{
+				continue;
+			}
+			if (Top.second == Goal)
+			{
+				return Top.first;
+			}
+
+			int32 Neighbors[4];
+			const int32 NumNeighbors = Graph.GetNeighbors(Top.second, Neighbors);
+			for (int32 i = 0; i < NumNeighbors; i++)
+			{
+				const int32 NewDistance = Top.first + Graph.GetCost(Neighbors[i]);
+				if (NewDistance < Distance[Neighbors[i]])
+				{
+					Distance[Neighbors[i]] = NewDistance;
+					Open.push(FEntry(NewDistance, Neighbors[i]));
+				}
+			}
+		}
+		return GridUnreachable;
+	}
+
+	/** Does Result walk from Start to Goal over open neighbors and add up to its cost */
+	bool IsValidPath(const FGridGraph& Graph, int32 Start, int32 Goal, const FGridSearchResult& Result)
+	{
+		const std::vector<int32>& Path = Result.Path;
+		if (Path.empty() || (Path.front() != Start) || (Path.back() != Goal))
+		{
+			return false;
+		}
+
+		int32 Cost = 0;
+		for (size_t i = 1; i < Path.size(); i++)
+		{
+			if (!Graph.IsValidIndex(Path[i]) || Graph.IsWall(Path[i]) || (Graph.GetManhattanDistance(Path[i - 1], Path[i]) != 1))
+			{
+				return false;
+			}
+			Cost += Graph.GetCost(Path[i]);
+		}
+		return Cost == Result.Cost;
+	}
+
+	/** Random board with about WallPercent walls and, unless bUniform, costs 1 to 9 */
+	void MakeBoard(FGridGraph& Graph, FGridRandom& Random, int32 Width, int32 Height, int32 WallPercent, bool bUniform)
+	{
+		Graph.Init(Width, Height);
+		for (int32 Index = 0; Index < Graph.Num(); Index++)
+		{
+			if (Random.RandRange(100) < WallPercent)
+			{
+				Graph.SetWall(Index, true);
+			}
+			else if (!bUniform)
+			{
+				Graph.SetCost(Index, 1 + Random.RandRange(9));
+			}
+		}
+	}
+
+	/** Random open cell, GridInvalidIndex if a few tries find none */
+	int32 PickOpenCell(const FGridGraph& Graph, FGridRandom& Random)
+	{
+		for (int32 Try = 0; Try < 100; Try++)
+		{
+			const int32 Index = Random.RandRange(Graph.Num());
+			if (Graph.IsWalkable(Index))
+			{
+				return Index;
+			}
+		}
+		return GridInvalidIndex;
+	}
+
+	/** Run Query on random boards and queries and hold its cost and path to the reference */
+	void CheckExact(const char* Test, bool bUniform, const std::function<bool(const FGridGraph&, int32, int32, FGridSearchResult&)>& Query)
+	{
+		FGridRandom Random(11);
+		for (int32 Board = 0; Board < 40; Board++)
+		{
+			FGridGraph Graph;
+			MakeBoard(Graph, Random, 8 + Random.RandRange(40), 8 + Random.RandRange(40), 25, bUniform);
+			for (int32 i = 0; i < 10; i++)
+			{
+				const int32 Start = PickOpenCell(Graph, Random);
+				const int32 Goal = PickOpenCell(Graph, Random);
+				if ((Start == GridInvalidIndex) || (Goal == GridInvalidIndex))
+				{
+					continue;
+				}
+
+				FGridSearchResult Result;
+				const bool bFound = Query(Graph, Start, Goal, Result);
+				const int32 Expected = ReferenceCost(Graph, Start, Goal);
+				Check(bFound == (Expected != GridUnreachable), Test, "found a path exactly when one exists", Board);
+				Check(Result.Cost == Expected, Test, "cost matches the reference", Result.Cost);
+				Check(!bFound || IsValidPath(Graph, Start, Goal, Result), Test, "path is valid", Board);
+			}
+		}
+	}
+
+	void TestSearches()
+	{
+		const EGridSearchAlgorithm Algorithms[] = { EGridSearchAlgorithm::Dijkstra, EGridSearchAlgorithm::AStar,
+			EGridSearchAlgorithm::BidirectionalDijkstra, EGridSearchAlgorithm::BidirectionalAStar };
+		const EGridOpenList OpenLists[] = { EGridOpenList::Heap, EGridOpenList::Buckets };
+
+		FGridSearch Search;
+		for (EGridSearchAlgorithm Algorithm : Algorithms)
+		{
+			for (EGridOpenList OpenList : OpenLists)
+			{
+				const std::string Test = std::string("Searches/") + GetAlgorithmName(Algorithm) + "/" + GetOpenListName(OpenList);
+				CheckExact(Test.c_str(), false, [&](const FGridGraph& Graph, int32 Start, int32 Goal, FGridSearchResult& Result)
+				{
+					return Search.Run(Graph, Start, Goal, Algorithm, Result, OpenList);
+				});
+			}
+		}
+	}
+
+	void TestJumpPoint()
+	{
+		FGridSearch Search;
+		CheckExact("JumpPoint/Scan", true, [&](const FGridGraph& Graph, int32 Start, int32 Goal, FGridSearchResult& Result)
+		{
+			return Search.RunJumpPoint(Graph, Start, Goal, nullptr, Result);
+		});
+
+		FJumpPointTable Table;
+		CheckExact("JumpPoint/Table", true, [&](const FGridGraph& Graph, int32 Start, int32 Goal, FGridSearchResult& Result)
+		{
+			Table.Rebuild(Graph);
+			return Search.RunJumpPoint(Graph, Start, Goal, &Table, Result);
+		});
+
+		//Tables repaired cell by cell have to match the search a fresh table gives
+		FGridRandom Random(5);
+		FGridGraph Graph;
+		MakeBoard(Graph, Random, 40, 30, 20, true);
+		Table.Rebuild(Graph);
+		for (int32 Edit = 0; Edit < 200; Edit++)
+		{
+			const int32 Index = Random.RandRange(Graph.Num());
+			Graph.SetWall(Index, !Graph.IsWall(Index));
+			Table.UpdateCell(Graph, Index);
+
+			const int32 Start = PickOpenCell(Graph, Random);
+			const int32 Goal = PickOpenCell(Graph, Random);
+			FGridSearchResult Result;
+			Search.RunJumpPoint(Graph, Start, Goal, &Table, Result);
+			Check(Result.Cost == ReferenceCost(Graph, Start, Goal), "JumpPoint/Repair", "cost after edits matches the reference", Edit);
+		}
+	}
+
+	void TestBitset()
+	{
+		FGridBitsetSearch Bitset;
+		CheckExact("Bitset", true, [&](const FGridGraph& Graph, int32 Start, int32 Goal, FGridSearchResult& Result)
+		{
+			Bitset.Build(Graph);
+			return Bitset.Run(Graph, Start, Goal, Result);
+		});
+
+		FGridRandom Random(9);
+		FGridGraph Graph;
+		MakeBoard(Graph, Random, 130, 70, 30, true);
+		Bitset.Build(Graph);
+		for (int32 Edit = 0; Edit < 200; Edit++)
+		{
+			const int32 Index = Random.RandRange(Graph.Num());
+			Graph.SetWall(Index, !Graph.IsWall(Index));
+			Bitset.UpdateCell(Graph, Index);
+
+			const int32 Start = PickOpenCell(Graph, Random);
+			const int32 Goal = PickOpenCell(Graph, Random);
+			Check(Bitset.GetStepDistance(Start, Goal) == ReferenceCost(Graph, Start, Goal), "Bitset/Repair", "steps after edits match the reference", Edit);
+		}
+	}
+
+	void TestHierarchical()
+	{
+		FGridRandom Random(13);
+		FGridHierarchy Hierarchy;
+		for (int32 Board = 0; Board < 20; Board++)
+		{
+			FGridGraph Graph;
+			MakeBoard(Graph, Random, 20 + Random.RandRange(60), 20 + Random.RandRange(60), 25, Board % 2 == 0);
+			Hierarchy.Build(Graph, 8);
+			for (int32 i = 0; i < 20; i++)
+			{
+				//Edit between queries so the cluster rebuilds are covered too
+				const int32 Edit = Random.RandRange(Graph.Num());
+				Graph.SetWall(Edit, !Graph.IsWall(Edit));
+				Hierarchy.OnCellChanged(Edit);
+				Hierarchy.Update(Graph);
+
+				const int32 Start = PickOpenCell(Graph, Random);
+				const int32 Goal = PickOpenCell(Graph, Random);
+				if ((Start == GridInvalidIndex) || (Goal == GridInvalidIndex))
+				{
+					continue;
+				}
+
+				FGridSearchResult Result;
+				const bool bFound = Hierarchy.FindPath(Graph, Start, Goal, Result);
+				const int32 Expected = ReferenceCost(Graph, Start, Goal);
+				Check(bFound == (Expected != GridUnreachable), "Hierarchical", "found a path exactly when one exists", Board);
+				Check(!bFound || IsValidPath(Graph, Start, Goal, Result), "Hierarchical", "path is valid", Board);
+				Check(!bFound || (Result.Cost >= Expected), "Hierarchical", "never cheaper than the reference", Result.Cost);
+			}
+		}
+	}
+
+	void TestIncremental()
+	{
+		FGridRandom Random(17);
+		for (int32 Board = 0; Board < 20; Board++)
+		{
+			FGridGraph Graph;
+			MakeBoard(Graph, Random, 30, 30, 20, Board % 2 == 0);
+			int32 Start = PickOpenCell(Graph, Random);
+			const int32 Goal = PickOpenCell(Graph, Random);
+			if ((Start == GridInvalidIndex) || (Goal == GridInvalidIndex))
+			{
+				continue;
+			}
+
+			FGridIncrementalSearch Planner;
+			Planner.Initialize(Graph, Start, Goal);
+			for (int32 Step = 0; Step < 30; Step++)
+			{
+				FGridSearchResult Result;
+				const bool bFound = Planner.Replan(Graph, Result);
+				const int32 Expected = ReferenceCost(Graph, Start, Goal);
+				Check(bFound == (Expected != GridUnreachable), "Incremental", "found a path exactly when one exists", Step);
+				Check(!bFound || (Result.Cost == Expected), "Incremental", "cost after edits matches the reference", Result.Cost);
+				Check(!bFound || IsValidPath(Graph, Start, Goal, Result), "Incremental", "path is valid", Step);
+
+				//Walk one step along the path, then change a few cells
+				if (bFound && (Result.Path.size() > 1))
+				{
+					Start = Result.Path[1];
+					Planner.SetStart(Graph, Start);
+				}
+				for (int32 Edit = 0; Edit < 3; Edit++)
+				{
+					const int32 Index = Random.RandRange(Graph.Num());
+					if ((Index == Start) || (Index == Goal))
+					{
+						continue;
+					}
+					if (Random.RandBool())
+					{
+						Graph.SetWall(Index, !Graph.IsWall(Index));
+					}
+					else if (Graph.IsWalkable(Index))
+					{
+						Graph.SetCost(Index, 1 + Random.RandRange(9));
+					}
+					Planner.OnCellChanged(Graph, Index);
+				}
+			}
+		}
+	}
+
+	void TestFlowField()
+	{
+		FGridRandom Random(19);
+		FGridGraph Graph;
+		MakeBoard(Graph, Random, 40, 40, 20, false);
+		std::vector<int32> Goals;
+		Goals.push_back(PickOpenCell(Graph, Random));
+		Goals.push_back(PickOpenCell(Graph, Random));
+
+		FGridFlowField Field;
+		Field.Build(Graph, Goals);
+		for (int32 Edit = 0; Edit < 150; Edit++)
+		{
+			const int32 Index = Random.RandRange(Graph.Num());
+			if (Random.RandBool())
+			{
+				Graph.SetWall(Index, !Graph.IsWall(Index));
+			}
+			else if (Graph.IsWalkable(Index))
+			{
+				Graph.SetCost(Index, 1 + Random.RandRange(9));
+			}
+			Field.OnCellChanged(Graph, Index);
+
+			//A repaired field has to hold the distances a fresh build gives, and its arrows have to lead to a goal
+			FGridFlowField Fresh;
+			Fresh.Build(Graph, Goals);
+			for (int32 Cell = 0; Cell < Graph.Num(); Cell++)
+			{
+				Check(Field.GetDistance(Cell) == Fresh.GetDistance(Cell), "FlowField", "repaired distance matches a rebuild", Cell);
+			}
+
+			const int32 Cell = Random.RandRange(Graph.Num());
+			if (Field.GetDistance(Cell) != GridUnreachable)
+			{
+				int32 Cost = 0;
+				int32 Current = Cell;
+				for (int32 Steps = 0; (Steps < Graph.Num()) && (Field.GetDirection(Current) != EGridFlowDirection::Goal); Steps++)
+				{
+					Current = Field.GetNextCell(Current);
+					Cost += Graph.GetCost(Current);
+				}
+				Check(Field.GetDirection(Current) == EGridFlowDirection::Goal, "FlowField", "arrows lead to a goal", Cell);
+				Check(Cost == Field.GetDistance(Cell), "FlowField", "arrows add up to the distance", Cost);
+			}
+		}
+	}
+
+	/** Open cells and the joins between 4-neighboring open cells, and whether every open cell is reachable from the first */
+	void CountMaze(const FGridGraph& Graph, int32& OutNumOpen, int32& OutNumJoins, bool& bOutConnected)
+	{
+		OutNumOpen = 0;
+		OutNumJoins = 0;
+		int32 First = GridInvalidIndex;
+		for (int32 Index = 0; Index < Graph.Num(); Index++)
+		{
+			if (Graph.IsWalkable(Index))
+			{
+				OutNumOpen++;
+				First = First == GridInvalidIndex ? Index : First;
+				int32 Neighbors[4];
+				OutNumJoins += Graph.GetNeighbors(Index, Neighbors);
+			}
+		}
+		OutNumJoins /= 2;
+
+		int32 NumReached = 0;
+		if (First != GridInvalidIndex)
+		{
+			std::vector<uint8> Reached(Graph.Num(), 0);
+			std::vector<int32> Stack(1, First);
+			Reached[First] = 1;
+			while (!Stack.empty())
+			{
+				const int32 Cell = Stack.back();
+				Stack.pop_back();
+				NumReached++;
+				int32 Neighbors[4];
+				const int32 NumNeighbors = Graph.GetNeighbors(Cell, Neighbors);
+				for (int32 i = 0; i < NumNeighbors; i++)
+				{
+					if (!Reached[Neighbors[i]])
+					{
+						Reached[Neighbors[i]] = 1;
+						Stack.push_back(Neighbors[i]);
+					}
+				}
+			}
+		}
+		bOutConnected = NumReached == OutNumOpen;
+	}
+
+	void TestMazes()
+	{
+		FGridMazeGenerator Generator;
+		for (int32 Algorithm = 0; Algorithm < (int32)EGridMazeAlgorithm::Num; Algorithm++)
+		{
+			const std::string Test = std::string("Mazes/") + GetMazeAlgorithmName(static_cast<EGridMazeAlgorithm>(Algorithm));
+			for (int32 Size = 5; Size <= 61; Size += 14)
+			{
+				//A perfect maze is a tree: connected, with one join fewer than open cells
+				FGridGraph Graph(Size, Size + 2);
+				const FGridMazeStats Stats = Generator.Generate(Graph, 100 + Size, static_cast<EGridMazeAlgorithm>(Algorithm));
+				int32 NumOpen;
+				int32 NumJoins;
+				bool bConnected;
+				CountMaze(Graph, NumOpen, NumJoins, bConnected);
+				Check(bConnected, Test.c_str(), "perfect maze is connected", Size);
+				Check(NumJoins == NumOpen - 1, Test.c_str(), "perfect maze has no loops", Size);
+				Check(Stats.NumOpen == NumOpen, Test.c_str(), "stats count the open cells", Stats.NumOpen);
+
+				//The same seed carves the same maze
+				FGridGraph Again(Size, Size + 2);
+				Generator.Generate(Again, 100 + Size, static_cast<EGridMazeAlgorithm>(Algorithm));
+				bool bSame = true;
+				for (int32 Index = 0; Index < Graph.Num(); Index++)
+				{
+					bSame = bSame && (Graph.IsWall(Index) == Again.IsWall(Index));
+				}
+				Check(bSame, Test.c_str(), "seeded generation is repeatable", Size);
+
+				//Braiding everything leaves no dead ends and adds loops without disconnecting anything
+				const FGridMazeStats Braided = Generator.Generate(Graph, 100 + Size, static_cast<EGridMazeAlgorithm>(Algorithm), 1.f);
+				CountMaze(Graph, NumOpen, NumJoins, bConnected);
+				Check(bConnected, Test.c_str(), "braided maze is connected", Size);
+				Check(Braided.NumDeadEnds == 0, Test.c_str(), "full braiding leaves no dead ends", Braided.NumDeadEnds);
+				Check(Braided.NumDeadEnds == FGridMazeGenerator::CountDeadEnds(Graph), Test.c_str(), "stats count the dead ends", Size);
+				Check(NumJoins == NumOpen - 1 + Braided.NumBraided, Test.c_str(), "every braid adds one loop", Braided.NumBraided);
+			}
+		}
+	}
+
+	void TestGridFile()
+	{
+		const char* Path = "GridCoreTests.grid";
+		FGridRandom Random(23);
+		for (int32 Board = 0; Board < 2; Board++)
+		{
+			//Odd sizes so the wall bitset ends in a partial byte, and one uniform board so the cost layer is left out
+			FGridGraph Graph;
+			MakeBoard(Graph, Random, 37, 23, 30, Board == 0);
+			Graph.SetStart(PickOpenCell(Graph, Random));
+			Graph.SetGoal(PickOpenCell(Graph, Random));
+			Check(FGridFile::Write(Path, Graph) == EGridFileResult::Success, "GridFile", "board is written", Board);
+
+			FGridGraph Loaded;
+			Check(FGridFile::Load(Path, Loaded) == EGridFileResult::Success, "GridFile", "board is read back", Board);
+			bool bSame = (Loaded.GetWidth() == Graph.GetWidth()) && (Loaded.GetHeight() == Graph.GetHeight());
+			for (int32 Index = 0; bSame && (Index < Graph.Num()); Index++)
+			{
+				bSame = (Loaded.IsWall(Index) == Graph.IsWall(Index)) && (Loaded.GetCost(Index) == Graph.GetCost(Index));
+			}
+			Check(bSame, "GridFile", "walls and costs survive the round trip", Board);
+			Check((Loaded.GetStart() == Graph.GetStart()) && (Loaded.GetGoal() == Graph.GetGoal()), "GridFile", "start and goal survive the round trip", Board);
+			Check((Loaded.GetMinCost() == Graph.GetMinCost()) && (Loaded.GetMaxCost() == Graph.GetMaxCost()), "GridFile", "cost range survives the round trip", Board);
+		}
+
+		//An empty board has neither a wall nor a cost layer to write
+		FGridGraph Empty(0, 0);
+		FGridGraph LoadedEmpty(3, 3);
+		Check(FGridFile::Write(Path, Empty) == EGridFileResult::Success, "GridFile", "empty board is written", 0);
+		Check(FGridFile::Load(Path, LoadedEmpty) == EGridFileResult::Success, "GridFile", "empty board is read back", 0);
+		Check(LoadedEmpty.Num() == 0, "GridFile", "empty board stays empty", LoadedEmpty.Num());
+
+		//A cut off file is refused and leaves the graph alone
+		FGridGraph Board;
+		MakeBoard(Board, Random, 37, 23, 30, false);
+		FGridFile::Write(Path, Board);
+		std::FILE* File = std::fopen(Path, "rb");
+		std::vector<uint8> Data(4096);
+		Data.resize(std::fread(Data.data(), 1, Data.size(), File));
+		std::fclose(File);
+		FGridGraph Untouched(3, 3);
+		Check(FGridFile::Read(Data.data(), (int64)Data.size() - 1, Untouched) == EGridFileResult::Truncated, "GridFile", "truncated file is refused", (int32)Data.size());
+		Check(Untouched.GetWidth() == 3, "GridFile", "graph is untouched on failure", Untouched.GetWidth());
+		Data[0] ^= 0xff;
+		Check(FGridFile::Read(Data.data(), (int64)Data.size(), Untouched) == EGridFileResult::BadMagic, "GridFile", "foreign file is refused", 0);
+		std::remove(Path);
+	}
+
+	void TestQueryQueue()
+	{
+		FGridRandom Random(29);
+		std::shared_ptr<FGridGraph> Graph = std::make_shared<FGridGraph>();
+		MakeBoard(*Graph, Random, 30, 30, 20, false);
+
+		//Most urgent first, oldest first within a priority, and cancelled queries are skipped
+		FGridQueryQueue Queue;
+		const EGridQueryPriority Priorities[] = { EGridQueryPriority::Low, EGridQueryPriority::High, EGridQueryPriority::Normal, EGridQueryPriority::High };
+		std::vector<int32> Handles;
+		for (EGridQueryPriority Priority : Priorities)
+		{
+			FGridQuery Query;
+			Query.Start = PickOpenCell(*Graph, Random);
+			Query.Goal = PickOpenCell(*Graph, Random);
+			Query.Priority = Priority;
+			Query.Graph = Graph;
+			Handles.push_back(Queue.Push(Query));
+		}
+		Check(Queue.Cancel(Handles[2]), "QueryQueue", "pending query can be cancelled", Handles[2]);
+
+		const int32 Expected[] = { Handles[1], Handles[3], Handles[0] };
+		FGridQuery Next;
+		for (int32 Handle : Expected)
+		{
+			Check(Queue.Pop(Next) && (Next.Handle == Handle), "QueryQueue", "queries pop in priority order", Next.Handle);
+
+			std::unique_ptr<FGridSearch> Search = Queue.AcquireSearch();
+			FGridSearchResult Result;
+			FGridQueryQueue::Execute(Next, *Search, Result);
+			Check(Result.Cost == ReferenceCost(*Graph, Next.Start, Next.Goal), "QueryQueue", "executed query matches the reference", Result.Cost);
+			Queue.ReleaseSearch(std::move(Search));
+			Queue.Finish(Next.Handle);
+		}
+		Check(!Queue.Pop(Next), "QueryQueue", "queue runs dry", Next.Handle);
+
+		//One query at a time needs one set of scratch, and releasing drops it for good
+		Check(Queue.GetIdleSearchBytes() > 0, "QueryQueue", "scratch is kept between queries", 0);
+		std::unique_ptr<FGridSearch> First = Queue.AcquireSearch();
+		Check(Queue.GetIdleSearchBytes() == 0, "QueryQueue", "one worker reuses the one idle scratch", 0);
+		Queue.ReleaseSearches();
+		Queue.ReleaseSearch(std::move(First));
+		Check(Queue.GetIdleSearchBytes() == 0, "QueryQueue", "released queue keeps no scratch", 0);
+	}
+
+	void TestCrowd()
+	{
+		FGridRandom Random(29);
+		FGridGraph Graph;
+		MakeBoard(Graph, Random, 30, 30, 10, true);
+		const int32 Goal = PickOpenCell(Graph, Random);
+		std::vector<int32> Goals(1, Goal);
+		FGridFlowField Field;
+		Field.Build(Graph, Goals);
+
+		FGridCrowd Crowd;
+		Crowd.Reset(Graph);
+		int32 Wall = 0;
+		while (!Graph.IsWall(Wall))
+		{
+			Wall++;
+		}
+		Check(Crowd.AddAgent(Graph, PickOpenCell(Graph, Random), EGridAgentMode::Path, 4.f, Wall) == GridInvalidIndex, "Crowd", "wall goal is turned down", Wall);
+
+		//Only agents that can reach the goal, so the whole crowd has to arrive and go quiet
+		for (int32 Attempt = 0; Attempt < 200; Attempt++)
+		{
+			const int32 Cell = PickOpenCell(Graph, Random);
+			if (Field.GetDistance(Cell) != GridUnreachable)
+			{
+				Crowd.AddAgent(Graph, Cell, EGridAgentMode::FlowField, 4.f);
+			}
+		}
+		Check(Crowd.Num() > 0, "Crowd", "agents were added", Crowd.Num());
+
+		FGridCrowdStats Stats;
+		for (int32 Update = 0; Update < 5000; Update++)
+		{
+			Stats = Crowd.Update(Graph, &Field, 0.1f);
+			if (Stats.NumMoving + Stats.NumWaiting == 0)
+			{
+				break;
+			}
+		}
+		Check(Stats.NumArrived == Crowd.Num(), "Crowd", "every agent arrives", Stats.NumArrived);
+		Check(Stats.NumMoving + Stats.NumWaiting == 0, "Crowd", "nothing moves or waits once everyone arrived", Stats.NumMoving + Stats.NumWaiting);
+	}
+
+	void TestBenchmark()
+	{
+		std::vector<FGridBenchmarkRecord> Baseline(3);
+		const char* Modes[] = { "Dijkstra", "AStar", "JumpPoint" };
+		for (int32 i = 0; i < 3; i++)
+		{
+			Baseline[i].Map = "maze";
+			Baseline[i].Size = 25;
+			Baseline[i].Mode = Modes[i];
+			Baseline[i].bFound = true;
+			Baseline[i].Cost = 48;
+			Baseline[i].NodesExpanded = 100;
+		}
+
+		std::vector<FGridBenchmarkRecord> Current = Baseline;
+		FGridBenchmarkThresholds Thresholds;
+		Check(FGridBenchmark::FindRegressions(Current, Baseline, Thresholds).empty(), "Benchmark", "same records have no regressions", 0);
+
+		//A worse case and a case that didn't run are both reported, a new case isn't
+		Current[0].NodesExpanded = 200;
+		Current.erase(Current.begin() + 2);
+		FGridBenchmarkRecord Added = Baseline[0];
+		Added.Mode = "Bitset";
+		Current.push_back(Added);
+		const std::vector<FGridBenchmarkRegression> Regressions = FGridBenchmark::FindRegressions(Current, Baseline, Thresholds);
+		Check(Regressions.size() == 2, "Benchmark", "one slower and one missing case", (int32)Regressions.size());
+		bool bFoundMissing = false;
+		for (const FGridBenchmarkRegression& Regression : Regressions)
+		{
+			bFoundMissing = bFoundMissing || ((Regression.Metric == "missing") && (Regression.Key == Baseline[2].GetKey()));
+		}
+		Check(bFoundMissing, "Benchmark", "baseline case missing from the run is a regression", 0);
+	}
+
+	void TestTopology()
+	{
+		//Cost 127 diagonals overflow int32 long before 4-connected steps do, the search has to say so instead of wrapping
+		FGridGraph Graph;
+		Graph.Init(200, 200);
+		for (int32 Index = 0; Index < Graph.Num(); Index++)
+		{
+			Graph.SetCost(Index, FGridGraph::MaxCellCost);
+		}
+		const int32 Start = 0;
+		const int32 Goal = Graph.Num() - 1;
+
+		FGridSearch Search;
+		FGridSearchResult Result;
+		Search.SetTopology(EGridTopology::Eight);
+		Check(!Search.Run(Graph, Start, Goal, EGridSearchAlgorithm::AStar, Result) && Result.bTooLarge, "Topology", "8-connected search refuses a board it can't fit", Result.Cost);
+
+		Search.SetTopology(EGridTopology::Four);
+		Check(Search.Run(Graph, Start, Goal, EGridSearchAlgorithm::AStar, Result) && !Result.bTooLarge, "Topology", "4-connected search still runs", Result.Cost);
+		Check(Result.Cost == ReferenceCost(Graph, Start, Goal), "Topology", "4-connected cost matches the reference", Result.Cost);
+
+		Graph.Init(20, 20);
+		for (int32 Index = 0; Index < Graph.Num(); Index++)
+		{
+			Graph.SetCost(Index, FGridGraph::MaxCellCost);
+		}
+		Search.SetTopology(EGridTopology::Eight);
+		const bool bFound = Search.Run(Graph, 0, Graph.Num() - 1, EGridSearchAlgorithm::BidirectionalAStar, Result);
+		Check(bFound && !Result.bTooLarge, "Topology", "small 8-connected board runs", Result.Cost);
+		Check(Result.Cost == 19 * FGridGraph::MaxCellCost * FGridTopology8::DiagonalWeight, "Topology", "diagonal cost is exact", Result.Cost);
+	}
+
+	void TestPathCache()
+	{
+		FGridGraph Graph(20, 20);
+		FGridSearch Search;
+		FGridPathCache Cache(2);
+		const auto Add = [&](int32 Start, int32 Goal)
+		{
+			FGridSearchResult Result;
+			Search.Run(Graph, Start, Goal, EGridSearchAlgorithm::AStar, Result);
+			Cache.Add(Start, Goal, EGridSearchAlgorithm::AStar, Result, Cache.GetVersion());
+		};
+		const auto Has = [&](int32 Start, int32 Goal)
+		{
+			return Cache.Find(Start, Goal, EGridSearchAlgorithm::AStar) != nullptr;
+		};
+
+		//Along row 0, along column 0, and across the far corner
+		const int32 Row = 19;
+		const int32 Column = 19 * 20;
+		const int32 Corner = 20 * 20 - 1;
+
+		Check(!Has(0, Row), "PathCache", "empty cache misses", 0);
+		Add(0, Row);
+		const FGridCachedPath* Cached = Cache.Find(0, Row, EGridSearchAlgorithm::AStar);
+		Check((Cached != nullptr) && Cached->bFound && (Cached->Cost == 19), "PathCache", "stored path comes back", Cached ? Cached->Cost : -1);
+		Check((Cache.GetStats().Hits == 1) && (Cache.GetStats().Misses == 1), "PathCache", "one hit and one miss are counted", (int32)Cache.GetStats().Hits);
+
+		//The least recently used entry goes when a third one comes in, and a lookup counts as a use
+		Add(0, Column);
+		Has(0, Row);
+		Add(Corner, Column);
+		Check(!Has(0, Column), "PathCache", "least recently used entry is evicted", Cache.Num());
+		Check(Has(0, Row) && Has(Corner, Column), "PathCache", "recently used entries stay", Cache.Num());
+		Check(Cache.GetStats().Evictions == 1, "PathCache", "eviction is counted", (int32)Cache.GetStats().Evictions);
+
+		//A wall off a cached path keeps it, a wall on it drops it
+		const int32 OffPath = 10 * 20 + 5;
+		Graph.SetWall(OffPath, true);
+		Cache.OnCellChanged(Graph, OffPath);
+		Check(Has(0, Row), "PathCache", "wall off the path keeps the entry", OffPath);
+		Graph.SetWall(5, true);
+		Cache.OnCellChanged(Graph, 5);
+		Check(!Has(0, Row), "PathCache", "wall on the path drops the entry", 5);
+		Check(Cache.GetStats().Invalidations == 1, "PathCache", "invalidation is counted", (int32)Cache.GetStats().Invalidations);
+
+		//A search from before the last edit, or one that was cancelled, isn't stored
+		FGridSearchResult Result;
+		const uint32 SearchedVersion = Cache.GetVersion();
+		Search.Run(Graph, 0, Corner, EGridSearchAlgorithm::AStar, Result);
+		Graph.SetWall(OffPath, false);
+		Cache.OnCellChanged(Graph, OffPath);
+		Cache.Add(0, Corner, EGridSearchAlgorithm::AStar, Result, SearchedVersion);
+		Check(!Has(0, Corner), "PathCache", "stale search is turned away", (int32)SearchedVersion);
+		Result.bCancelled = true;
+		Cache.Add(0, Corner, EGridSearchAlgorithm::AStar, Result, Cache.GetVersion());
+		Check(!Has(0, Corner), "PathCache", "cancelled search is turned away", 0);
+	}
+
+	/** Do the two windows have the same walls */
+	bool IsSameWindow(const FGridGraph& A, const FGridGraph& B)
+	{
+		bool bSame = (A.GetWidth() == B.GetWidth()) && (A.GetHeight() == B.GetHeight());
+		for (int32 Index = 0; bSame && (Index < A.Num()); Index++)
+		{
+			bSame = A.IsWall(Index) == B.IsWall(Index);
+		}
+		return bSame;
+	}
+
+	void TestChunkStore()
+	{
+		const char* PagePath = "GridCoreTests.page";
+		FGridChunkStoreSettings Settings;
+		Settings.Seed = 31;
+		Settings.ChunkSize = 16;
+
+		//Windows straddle the origin so negative coordinates are covered
+		const int32 MinX = -40;
+		const int32 MinY = -30;
+		FGridGraph First(80, 60);
+		FGridGraph Again(80, 60);
+		{
+			FGridChunkStore Store;
+			Store.Init(Settings);
+			Store.CopyWindow(MinX, MinY, First);
+			Check(Store.GetStats().ChunksGenerated == 6 * 4, "ChunkStore", "window generates the chunks it covers", (int32)Store.GetStats().ChunksGenerated);
+
+			//Cells -16..-1 share chunk -1, -17 starts chunk -2
+			FGridChunkStore Probe;
+			Probe.Init(Settings);
+			Probe.IsWalkable(0, 0);
+			Probe.IsWalkable(-1, 0);
+			Probe.IsWalkable(-16, 0);
+			Check(Probe.GetStats().ChunksGenerated == 2, "ChunkStore", "negative cells round down to their chunk", (int32)Probe.GetStats().ChunksGenerated);
+			Probe.IsWalkable(-17, 0);
+			Check(Probe.GetStats().ChunksGenerated == 3, "ChunkStore", "next negative chunk starts a chunk further", (int32)Probe.GetStats().ChunksGenerated);
+		}
+
+		//A store that can only hold one chunk evicts every other one, and they have to come back the same
+		Settings.MaxResidentChunks = 1;
+		Settings.PageFilePath = PagePath;
+		{
+			FGridChunkStore Store;
+			Check(Store.Init(Settings), "ChunkStore", "page file is created", 0);
+			Store.CopyWindow(MinX, MinY, Again);
+			Check(IsSameWindow(First, Again), "ChunkStore", "evicted chunks regenerate the same", 0);
+			Check(Store.GetStats().ChunksEvicted > 0, "ChunkStore", "chunks were evicted", (int32)Store.GetStats().ChunksEvicted);
+
+			//An edit has to survive its chunk being paged out and back in
+			const bool bWasWall = !Store.IsWalkable(-5, -7);
+			Store.SetWall(-5, -7, !bWasWall);
+			Store.IsWalkable(30, 20);
+			Check(Store.GetStats().ChunksWritten == 1, "ChunkStore", "edited chunk is paged out", (int32)Store.GetStats().ChunksWritten);
+			Check(Store.IsWalkable(-5, -7) == bWasWall, "ChunkStore", "edit survives eviction", 0);
+			Check(Store.GetStats().ChunksLoaded == 1, "ChunkStore", "edited chunk is read back", (int32)Store.GetStats().ChunksLoaded);
+		}
+		std::remove(PagePath);
+
+		//Walled in, the chunked search sees the same board as a plain search over a copy of the window. Without a page
+		//file evicted edits are lost, so every chunk the walls touch stays resident
+		Settings.MaxResidentChunks = 64;
+		Settings.PageFilePath.clear();
+		FGridChunkStore Store;
+		Store.Init(Settings);
+		for (int32 X = MinX - 1; X <= MinX + First.GetWidth(); X++)
+		{
+			Store.SetWall(X, MinY - 1, true);
+			Store.SetWall(X, MinY + First.GetHeight(), true);
+		}
+		for (int32 Y = MinY; Y < MinY + First.GetHeight(); Y++)
+		{
+			Store.SetWall(MinX - 1, Y, true);
+			Store.SetWall(MinX + First.GetWidth(), Y, true);
+		}
+		Store.CopyWindow(MinX, MinY, Again);
+		Check(IsSameWindow(First, Again), "ChunkStore", "walling in leaves the window alone", 0);
+
+		FGridRandom Random(37);
+		FGridChunkedSearch Search;
+		for (int32 Query = 0; Query < 30; Query++)
+		{
+			const int32 Start = PickOpenCell(First, Random);
+			const int32 Goal = PickOpenCell(First, Random);
+			if ((Start == GridInvalidIndex) || (Goal == GridInvalidIndex))
+			{
+				continue;
+			}
+
+			FGridChunkedSearchResult Result;
+			Search.Run(Store, MinX + First.GetX(Start), MinY + First.GetY(Start), MinX + First.GetX(Goal), MinY + First.GetY(Goal), Result);
+			Check(Result.Cost == ReferenceCost(First, Start, Goal), "ChunkStore", "chunked search cost matches the reference", Result.Cost);
+		}
+	}
+
+	void TestScenario()
+	{
+		//Rows 1 and 3 are open end to end, row 0 holds every terrain letter
+		const std::string MapText = "type octile\nheight 4\nwidth 7\nmap\n.GS@OTW\n.......\n.@@@@..\n.......\n";
+		FGridGraph Graph;
+		Check(FGridScenario::ParseMap(MapText, Graph), "Scenario", "map is parsed", 0);
+		Check((Graph.GetWidth() == 7) && (Graph.GetHeight() == 4), "Scenario", "map size is read", Graph.GetWidth());
+		const char* Terrain = ".GS@OTW";
+		for (int32 X = 0; X < 7; X++)
+		{
+			const bool bOpen = (Terrain[X] == '.') || (Terrain[X] == 'G') || (Terrain[X] == 'S');
+			Check(Graph.IsWalkable(Graph.GetIndex(X, 0)) == bOpen, "Scenario", "terrain is open or walled", X);
+		}
+
+		FGridGraph Rejected;
+		Check(!FGridScenario::ParseMap("type octile\nheight 2\nwidth 3\nmap\n...\n..\n", Rejected), "Scenario", "short row is refused", 0);
+		Check(!FGridScenario::ParseMap("type octile\nheight 1\nwidth 3\n...\n", Rejected), "Scenario", "missing map line is refused", 0);
+
+		std::vector<FGridScenarioQuery> Queries;
+		Check(FGridScenario::ParseScenario("version 1\n0\tsmall.map\t7\t4\t0\t1\t6\t1\t6\n1\tsmall.map\t7\t4\t0\t3\t6\t1\t7.41421356\n", Queries), "Scenario", "versioned scenario is parsed", 0);
+		Check(Queries.size() == 2, "Scenario", "every query is read", (int32)Queries.size());
+		if (Queries.size() == 2)
+		{
+			const FGridScenarioQuery& Query = Queries[1];
+			Check((Query.Bucket == 1) && (Query.Map == "small.map") && (Query.MapWidth == 7) && (Query.MapHeight == 4), "Scenario", "query header fields are read", Query.Bucket);
+			Check((Query.StartX == 0) && (Query.StartY == 3) && (Query.GoalX == 6) && (Query.GoalY == 1) && (Query.OptimalLength > 7.4), "Scenario", "query cells and length are read", Query.StartY);
+		}
+		std::vector<FGridScenarioQuery> Unversioned;
+		Check(FGridScenario::ParseScenario("0 small.map 7 4 0 3 6 3 6\n", Unversioned) && (Unversioned.size() == 1), "Scenario", "unversioned scenario is parsed", (int32)Unversioned.size());
+		Check(!FGridScenario::ParseScenario("version 1\n0 small.map 7 4 0 3\n", Unversioned), "Scenario", "short query line is refused", 0);
+
+		std::vector<EGridBenchmarkMode> Modes;
+		Modes.push_back(EGridBenchmarkMode::DijkstraHeap);
+		Modes.push_back(EGridBenchmarkMode::AStarBuckets);
+		Modes.push_back(EGridBenchmarkMode::JumpPoint);
+		FGridScenarioReport Report = FGridScenario::Run(Graph, Queries, Modes);
+		Check(Report.Failures.empty(), "Scenario", "correct queries pass", (int32)Report.Failures.size());
+
+		//A wrong published length has to be reported, not averaged away
+		Queries[0].OptimalLength = 7.0;
+		Report = FGridScenario::Run(Graph, Queries, Modes);
+		Check((Report.Failures.size() == 1) && (Report.Failures[0].Query == 0) && (Report.Failures[0].Mode == "Reference"), "Scenario", "wrong optimal length is a failure", (int32)Report.Failures.size());
+	}
+
+	struct FTest
+	{
+		const char* Name;
+		void (*Run)();
+	};
+
+	const FTest Tests[] =
+	{
+		{ "Searches", TestSearches },
+		{ "JumpPoint", TestJumpPoint },
+		{ "Bitset", TestBitset },
+		{ "Hierarchical", TestHierarchical },
+		{ "Incremental", TestIncremental },
+		{ "FlowField", TestFlowField },
+		{ "Mazes", TestMazes },
+		{ "GridFile", TestGridFile },
+		{ "QueryQueue", TestQueryQueue },
+		{ "Crowd", TestCrowd },
+		{ "Benchmark", TestBenchmark },
+		{ "Topology", TestTopology },
+		{ "PathCache", TestPathCache },
+		{ "ChunkStore", TestChunkStore },
+		{ "Scenario", TestScenario },
+	};
+}
+
+int main(int argc, char** argv)
+{
+	using namespace GridCoreTests;
+
+	for (const FTest& Test : Tests)
+	{
+		bool bSelected = argc < 2;
+		for (int32 i = 1; i < argc; i++)
+		{
+			bSelected = bSelected || (std::strcmp(argv[i], Test.Name) == 0);
+		}
+		if (bSelected)
+		{
+			const int32 FailuresBefore = NumFailures;
+			Test.Run();
+			printf("%s %s\n", NumFailures == FailuresBefore ? "PASS" : "FAIL", Test.Name);
+		}
+	}
+	return NumFailures == 0 ? 0 : 1;
+}